@@ -6,6 +6,9 @@
 
 #include "mpi.h"
 #include "pcgnslib.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "mini/mesh/shuffler.hpp"
 #include "mini/mesh/vtk.hpp"
@@ -133,7 +136,9 @@ using Spatial = mini::spatial::WithViscosity<General>;
 #include <nlohmann/json.hpp>
 
 int main(int argc, char* argv[]) {
-  MPI_Init(NULL, NULL);
+  // MPI is only called outside OpenMP parallel regions.
+  int mpi_thread_support;
+  MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &mpi_thread_support);
   int n_core, i_core;
   MPI_Comm_size(MPI_COMM_WORLD, &n_core);
   MPI_Comm_rank(MPI_COMM_WORLD, &i_core);
@@ -156,6 +161,18 @@ int main(int argc, char* argv[]) {
   auto json_input_file = std::ifstream(argv[1]);
   auto json_object = nlohmann::json::parse(json_input_file);
 
+#ifdef _OPENMP
+  // `n_threads` is optional, `OMP_NUM_THREADS` takes effect if it is absent.
+  if (json_object.contains("n_threads")) {
+    int n_threads = json_object.at("n_threads");
+    omp_set_num_threads(n_threads);
+  }
+  if (i_core == 0) {
+    std::printf("Run %d OpenMP threads on each of the %d cores\n",
+        omp_get_max_threads(), n_core);
+  }
+#endif
+
   std::string old_file_name = json_object.at("cgns_file");
   std::string suffix = json_object.at("cell_type");
   double t_start = json_object.at("t_start");
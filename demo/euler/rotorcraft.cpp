@@ -33,7 +33,9 @@ void WriteForces(Part const &part, Source *source, double t_curr,
 }
 
 int Main(int argc, char* argv[], IC ic, BC bc, Source source) {
-  MPI_Init(NULL, NULL);
+  // MPI is only called outside OpenMP parallel regions.
+  int mpi_thread_support;
+  MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &mpi_thread_support);
   int n_core, i_core;
   MPI_Comm_size(MPI_COMM_WORLD, &n_core);
   MPI_Comm_rank(MPI_COMM_WORLD, &i_core);
@@ -90,6 +92,7 @@ int Main(int argc, char* argv[], IC ic, BC bc, Source source) {
   /* Build a `Limiter` object. */
   auto limiter = Limiter(/* w0 = */0.001, /* eps = */1e-6);
   auto spatial = Spatial(&limiter, &source, &part);
+  spatial.BuildBasisTables();
   auto face_to_riemanns = [&spatial](Face const &face) -> auto const & {
     return spatial.GetRiemannSolvers(face);
   };
@@ -8,8 +8,15 @@
 
 #include "mpi.h"
 #include "pcgnslib.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
+#ifdef ENABLE_PARMETIS
+#include "mini/mesh/parallel_shuffler.hpp"
+#else
 #include "mini/mesh/shuffler.hpp"
+#endif
 
 #include "sourceless.hpp"
 
@@ -34,6 +41,9 @@ static void InstallIntegratorPrototypes(Part *part_ptr) {
   part_ptr->BuildGeometry();
 }
 
+#include "mini/temporal/steady.hpp"
+using Steady = mini::temporal::PseudoTimeStepping<kOrders, Scalar>;
+
 #include "mini/mesh/vtk.hpp"
 using VtkWriter = mini::mesh::vtk::Writer<Part>;
 
@@ -45,7 +55,10 @@ using VtkWriter = mini::mesh::vtk::Writer<Part>;
 #include <fstream>
 
 int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
-  MPI_Init(NULL, NULL);
+  // MPI is only called outside OpenMP parallel regions, but frames are written
+  // by a background thread if `MPI_THREAD_MULTIPLE` is supported.
+  int mpi_thread_support;
+  MPI_Init_thread(NULL, NULL, MPI_THREAD_MULTIPLE, &mpi_thread_support);
   int n_core, i_core;
   MPI_Comm_size(MPI_COMM_WORLD, &n_core);
   MPI_Comm_rank(MPI_COMM_WORLD, &i_core);
@@ -63,6 +76,18 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
   auto json_input_file = std::ifstream(argv[1]);
   auto json_object = nlohmann::json::parse(json_input_file);
 
+#ifdef _OPENMP
+  // `n_threads` is optional, `OMP_NUM_THREADS` takes effect if it is absent.
+  if (json_object.contains("n_threads")) {
+    int n_threads = json_object.at("n_threads");
+    omp_set_num_threads(n_threads);
+  }
+  if (i_core == 0) {
+    std::printf("Run %d OpenMP threads on each of the %d cores\n",
+        omp_get_max_threads(), n_core);
+  }
+#endif
+
   std::string old_file_name = json_object.at("cgns_file");
   std::string suffix = json_object.at("cell_type");
   const double t_start = json_object.at("t_start");
@@ -75,7 +100,9 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
   const int i_frame_prev = json_object.at("i_frame_prev");
   // `i_frame_prev` might be -1, which means no previous result to be loaded.
   const int i_frame_min = std::max(i_frame_prev, 0);
-  const int i_frame_max = i_frame_min + n_frames;
+  int i_frame_max = i_frame_min + n_frames;
+  // `residual_drop` is optional, a steady state is sought if it is present.
+  const double residual_drop = json_object.value("residual_drop", 0.0);
   int n_parts_prev = n_core;
   if (i_frame_prev >= 0) {
     n_parts_prev = json_object.at("n_parts_prev");
@@ -94,10 +121,18 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
   auto time_begin = MPI_Wtime();
 
   /* Partition the mesh. */
+#ifdef ENABLE_PARMETIS
+  // All ranks read the mesh and partition its dual graph by ParMETIS.
+  if (i_frame_prev < 0 || n_parts_prev != n_core) {
+    using Shuffler = mini::mesh::ParallelShuffler<idx_t, Scalar>;
+    Shuffler::PartitionAndShuffle(case_name, old_file_name, MPI_COMM_WORLD);
+  }
+#else
   if (i_core == 0 && (i_frame_prev < 0 || n_parts_prev != n_core)) {
     using Shuffler = mini::mesh::Shuffler<idx_t, Scalar>;
     Shuffler::PartitionAndShuffle(case_name, old_file_name, n_core);
   }
+#endif
   MPI_Barrier(MPI_COMM_WORLD);
 
   if (i_core == 0) {
@@ -106,8 +141,18 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
   }
   auto part = Part(case_name, i_core, n_core);
   InstallIntegratorPrototypes(&part);
+  // Each `FrameX.cgns` only holds solutions and is linked to this grid, which
+  // is named by `n_core`, since the order of cells depends on the partition.
+  part.WriteGrid("Grid" + std::to_string(n_core));
+  // Frames are written in the background while the next one is computed.
+  auto writer = std::make_unique<mini::mesh::AsyncWriter>(part.mpi_comm());
   part.SetFieldNames({"Density", "MomentumX", "MomentumY", "MomentumZ",
       "EnergyStagnationDensity"});
+#ifdef ENABLE_ZLIB
+  VtkWriter::SetEncoding(mini::mesh::vtk::Encoding::kZlib);
+#else
+  VtkWriter::SetEncoding(mini::mesh::vtk::Encoding::kRaw);
+#endif
 
 #ifdef LIMITER
   /* Build a `Limiter` object. */
@@ -125,6 +170,9 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
             return RiemannWithViscosity::GetPropertyOnCell(cell.id(), 0)[k]; });
   }
 #endif
+#ifdef DGFEM
+  spatial.BuildBasisTables();
+#endif
 
   /* Initialization. */
   if (i_frame_prev < 0) {
@@ -158,8 +206,8 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
     }
 
     part.GatherSolutions();
-    part.WriteSolutions("Frame0");
-    VtkWriter::WriteSolutions(part, "Frame0");
+    part.WriteSolutions("Frame0", writer.get());
+    VtkWriter::WriteSolutions(part, "Frame0", writer.get());
     if (i_core == 0) {
       std::printf("[Done] WriteSolutions(Frame0) on %d cores at %f sec\n",
           n_core, MPI_Wtime() - time_begin);
@@ -177,6 +225,7 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
 
   /* Define the temporal solver. */
   auto temporal = Temporal();
+  auto steady = Steady(residual_drop);
 
   /* Set boundary conditions. */
   bc(suffix, &spatial);
@@ -186,12 +235,30 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
   double t_curr = t_start;
   for (int i_frame = i_frame_min; i_frame < i_frame_max; ++i_frame) {
     double t_next = t_curr + dt_per_frame;
-    while (t_curr < t_next) {
+    // In the steady mode, each frame is n_steps_per_frame pseudo steps, in
+    // which each cell is advanced by its own dt (not greater than dt_max).
+    for (int i_step = 0; residual_drop > 0 && i_step < n_steps_per_frame;
+        ++i_step) {
+      steady.Update(&spatial, t_curr, dt_max);
+      auto [l2_norm, linf_norm] = steady.GetResidualNorms();
+      if (i_core == 0) {
+        std::printf("[Done] Step%d: |R|_2 = %4.2e, |R|_inf = %4.2e, "
+            "dropped by %4.2f orders at %f sec\n", steady.CountSteps(),
+            l2_norm, linf_norm, steady.GetOrdersOfDrop(),
+            MPI_Wtime() - wtime_start);
+      }
+      if (steady.IsConverged()) {
+        i_frame_max = i_frame + 1;
+        break;
+      }
+    }
+    while (residual_drop <= 0 && t_curr < t_next) {
       double dt_guess = std::min(t_next - t_curr, dt_max);
       double dt_local = (&spatial)->GetTimeStep(dt_guess, kOrders);
       assert(dt_local <= dt_guess);
       double dt;  // i.e. dt_global
-      MPI_Allreduce(&dt_local, &dt, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+      MPI_Allreduce(&dt_local, &dt, 1, MPI_DOUBLE, MPI_MIN,
+          part.mpi_comm());
       if (dt_local <= dt) {
         assert(dt_local == dt);
         if (dt < dt_guess) {
@@ -217,12 +284,21 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
     // Write the solutions at the next frame:
     auto frame_name = "Frame" + std::to_string(i_frame + 1);
     part.GatherSolutions();
-    part.WriteSolutions(frame_name);
-    VtkWriter::WriteSolutions(part, frame_name);
+    part.WriteSolutions(frame_name, writer.get());
+    VtkWriter::WriteSolutions(part, frame_name, writer.get());
     if (i_core == 0) {
       std::printf("[Done] WriteSolutions(Frame%d) on %d cores at %f sec\n",
           i_frame + 1, n_core, MPI_Wtime() - wtime_start);
     }
+#ifdef LIMITER
+    long n_cells[2] = { spatial.CountTroubledCells(), part.CountLocalCells() };
+    MPI_Allreduce(MPI_IN_PLACE, n_cells, 2, MPI_LONG, MPI_SUM,
+        part.mpi_comm());
+    if (i_core == 0) {
+      std::printf("[Done] %4.2f%% cells are troubled at Frame%d\n",
+          100.0 * n_cells[0] / n_cells[1], i_frame + 1);
+    }
+#endif
   }
 
   if (i_core == 0) {
@@ -238,6 +314,7 @@ int Main(int argc, char* argv[], IC ic, BC bc, MIV miv) {
     std::printf("[Start] MPI_Finalize() on %d cores at %f sec\n",
         n_core, MPI_Wtime() - time_begin);
   }
+  writer.reset();  // wait until all frames are written
   MPI_Finalize();
   return 0;
 }
@@ -77,7 +77,8 @@ using General = mini::spatial::fr::Lobatto<Part, Riemann>;
 #include "mini/limiter/weno.hpp"
 #include "mini/limiter/reconstruct.hpp"
 #include "mini/spatial/with_limiter.hpp"
-using Limiter = mini::limiter::weno::Lazy<Cell>;
+using Limiter = mini::limiter::weno::Lazy<Cell,
+    mini::limiter::detector::Krivodonova<Cell>>;
 using Spatial = mini::spatial::WithLimiter<General, Limiter>;
 
 #endif  // LIMITER
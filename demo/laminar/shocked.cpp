@@ -8,6 +8,9 @@
 
 #include "mpi.h"
 #include "pcgnslib.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "mini/mesh/shuffler.hpp"
 
@@ -54,7 +57,9 @@ using VtkWriter = mini::mesh::vtk::Writer<Part>;
 #include <nlohmann/json.hpp>
 
 int Main(int argc, char* argv[], IC ic, BC bc) {
-  MPI_Init(NULL, NULL);
+  // MPI is only called outside OpenMP parallel regions.
+  int mpi_thread_support;
+  MPI_Init_thread(NULL, NULL, MPI_THREAD_FUNNELED, &mpi_thread_support);
   int n_core, i_core;
   MPI_Comm_size(MPI_COMM_WORLD, &n_core);
   MPI_Comm_rank(MPI_COMM_WORLD, &i_core);
@@ -72,6 +77,18 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
   auto json_input_file = std::ifstream(argv[1]);
   auto json_object = nlohmann::json::parse(json_input_file);
 
+#ifdef _OPENMP
+  // `n_threads` is optional, `OMP_NUM_THREADS` takes effect if it is absent.
+  if (json_object.contains("n_threads")) {
+    int n_threads = json_object.at("n_threads");
+    omp_set_num_threads(n_threads);
+  }
+  if (i_core == 0) {
+    std::printf("Run %d OpenMP threads on each of the %d cores\n",
+        omp_get_max_threads(), n_core);
+  }
+#endif
+
   std::string old_file_name = json_object.at("cgns_file");
   std::string suffix = json_object.at("cell_type");
   const double t_start = json_object.at("t_start");
@@ -196,7 +213,8 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
       double dt_local = (&spatial)->GetTimeStep(dt_guess, kOrders);
       assert(dt_local <= dt_guess);
       double dt;  // i.e. dt_global
-      MPI_Allreduce(&dt_local, &dt, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+      MPI_Allreduce(&dt_local, &dt, 1, MPI_DOUBLE, MPI_MIN,
+          part.mpi_comm());
       if (dt_local <= dt) {
         assert(dt_local == dt);
         if (dt < dt_guess) {
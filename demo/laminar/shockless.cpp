@@ -54,7 +54,7 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
       std::cout << "usage:\n"
           << "  mpirun -n <n_core> " << argv[0] << " <cgns_file> <hexa|tetra>"
           << " <t_start> <t_stop> <n_steps_per_frame> <n_frames>"
-          << " [<i_frame_start> [n_parts_prev]]\n";
+          << " [<i_frame_start> [<n_parts_prev> [<residual_drop>]]]\n";
     }
     MPI_Finalize();
     exit(0);
@@ -75,6 +75,13 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
   if (argc > 8) {
     n_parts_prev = std::atoi(argv[8]);
   }
+  // A steady state is sought if `residual_drop` is given and positive.
+  double residual_drop = 0.0;
+  if (argc > 9) {
+    residual_drop = std::atof(argv[9]);
+  }
+  // Starting from Frame0 is the same as starting from scratch.
+  bool from_scratch = (i_frame == 0);
 
   auto case_name = std::string(argv[0]);
   auto pos = case_name.find_last_of('/');
@@ -87,7 +94,7 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
   auto time_begin = MPI_Wtime();
 
   /* Partition the mesh. */
-  if (i_core == 0 && (argc == 7 || n_parts_prev != n_core)) {
+  if (i_core == 0 && (from_scratch || n_parts_prev != n_core)) {
     using Shuffler = mini::mesh::Shuffler<idx_t, Scalar>;
     Shuffler::PartitionAndShuffle(case_name, old_file_name, n_core);
   }
@@ -107,7 +114,7 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
   bc(suffix, &spatial);
 
   /* Initialization. */
-  if (argc == 7) {
+  if (from_scratch) {
     if (i_core == 0) {
       std::printf("[Start] Approximate() on %d cores at %f sec\n",
           n_core, MPI_Wtime() - time_begin);
@@ -138,21 +145,37 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
 
   /* Define the temporal solver. */
   auto temporal = Temporal();
+  auto steady = Steady(residual_drop);
 
   /* Main Loop */
+  int i_frame_min = i_frame;
   auto wtime_start = MPI_Wtime();
   for (int i_step = 1; i_step <= n_steps; ++i_step) {
     double t_curr = t_start + dt * (i_step - 1);
-    temporal.Update(&spatial, t_curr, dt);
-
-    auto wtime_curr = MPI_Wtime() - wtime_start;
-    auto wtime_total = wtime_curr * n_steps / i_step;
-    if (i_core == 0) {
-      std::printf("[Done] Update(Step%d/%d) on %d cores at %f / %f sec\n",
-          i_step, n_steps, n_core, wtime_curr, wtime_total);
+    bool converged = false;
+    if (residual_drop > 0) {
+      // Each cell is advanced by its own pseudo step (not greater than dt).
+      steady.Update(&spatial, t_start, dt);
+      auto [l2_norm, linf_norm] = steady.GetResidualNorms();
+      if (i_core == 0) {
+        std::printf("[Done] Step%d: |R|_2 = %4.2e, |R|_inf = %4.2e, "
+            "dropped by %4.2f orders at %f sec\n", steady.CountSteps(),
+            l2_norm, linf_norm, steady.GetOrdersOfDrop(),
+            MPI_Wtime() - wtime_start);
+      }
+      converged = steady.IsConverged();
+    } else {
+      temporal.Update(&spatial, t_curr, dt);
+      auto wtime_curr = MPI_Wtime() - wtime_start;
+      auto wtime_total = wtime_curr * n_steps / i_step;
+      if (i_core == 0) {
+        std::printf("[Done] Update(Step%d/%d) on %d cores at %f / %f sec\n",
+            i_step, n_steps, n_core, wtime_curr, wtime_total);
+      }
     }
 
-    if (i_step % n_steps_per_frame == 0) {
+    // The converged solution is written as the last frame.
+    if (converged || i_step % n_steps_per_frame == 0) {
       ++i_frame;
       part.GatherSolutions();
       if (i_core == 0) {
@@ -163,11 +186,14 @@ int Main(int argc, char* argv[], IC ic, BC bc) {
       part.WriteSolutions(frame_name);
       mini::mesh::vtk::Writer<Part>::WriteSolutions(part, frame_name);
     }
+    if (converged) {
+      break;
+    }
   }
 
   if (i_core == 0) {
     std::printf("time-range = [%f, %f], frame-range = [%d, %d], dt = %f\n",
-        t_start, t_stop, i_frame - n_frames, i_frame, dt);
+        t_start, t_stop, i_frame_min, i_frame, dt);
     std::printf("[Start] MPI_Finalize() on %d cores at %f sec\n",
         n_core, MPI_Wtime() - time_begin);
   }
@@ -23,6 +23,7 @@
 #include "mini/polynomial/hexahedron.hpp"
 #include "mini/mesh/part.hpp"
 #include "mini/temporal/rk.hpp"
+#include "mini/temporal/steady.hpp"
 #include "mini/spatial/dg/lobatto.hpp"
 #include "mini/spatial/fr/lobatto.hpp"
 
@@ -87,6 +88,7 @@ using Spatial = mini::spatial::fr::Lobatto<Part, Riemann>;
 /* Choose the time-stepping scheme. */
 constexpr int kOrders = std::min(3, kDegrees + 1);
 using Temporal = mini::temporal::RungeKutta<kOrders, Scalar>;
+using Steady = mini::temporal::PseudoTimeStepping<kOrders, Scalar>;
 
 /* Define the types of IC and BCs. */
 using IC = Value(*)(const Global &);
@@ -3,13 +3,16 @@
 #define MINI_AIRCRAFT_SOURCE_HPP_
 
 #include <algorithm>
+#include <ranges>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "mini/algebra/eigen.hpp"
+#include "mini/geometry/bins.hpp"
 #include "mini/geometry/frame.hpp"
 #include "mini/geometry/intersect.hpp"
+#include "mini/integrator/function.hpp"
 #include "mini/integrator/line.hpp"
 #include "mini/aircraft/rotor.hpp"
 #include "mini/riemann/euler/types.hpp"
@@ -36,6 +39,7 @@ class Rotorcraft {
   using Blade = typename Rotor::Blade;
   using Section = typename Blade::Section;
   using Force = Global;
+  using Bins = mini::geometry::Bins<Scalar>;
 
  private:
   static bool Valid(Scalar ratio) {
@@ -160,6 +164,57 @@ class Rotorcraft {
     }
   }
 
+  /**
+   * @brief Index the bounding boxes of the given `Cell`s, so that `UpdateCoeffs` only visits `Cell`s near each `Blade`.
+   * 
+   * @param cells a range of `(const Cell &)`, which must outlive this object
+   */
+  template <std::ranges::input_range Cells>
+  void BuildCellIndex(Cells &&cells) {
+    cells_.clear();
+    auto lowers = std::vector<Global>(), uppers = std::vector<Global>();
+    for (const Cell &cell : cells) {
+      const auto &coordinate = cell.coordinate();
+      Global lower = coordinate.GetGlobal(0), upper = lower;
+      for (int i = 1, n = coordinate.CountNodes(); i < n; ++i) {
+        lower = lower.cwiseMin(coordinate.GetGlobal(i));
+        upper = upper.cwiseMax(coordinate.GetGlobal(i));
+      }
+      // pad the box, so that rounding errors never drop a touching blade
+      Scalar padding = cell.length() * 1e-6;
+      lower.array() -= padding;
+      upper.array() += padding;
+      lowers.emplace_back(lower);
+      uppers.emplace_back(upper);
+      cells_.emplace_back(&cell);
+    }
+    bins_ = Bins(std::move(lowers), std::move(uppers));
+  }
+
+  /**
+   * @brief Add the source integrals on the `Cell`s (indexed by `BuildCellIndex`) intersected by some `Blade`.
+   * 
+   * Each `Blade` only visits the `Cell`s whose bounding boxes are intersected by its span axis, so the cost scales with the number of intersected `Cell`s rather than all `Cell`s.
+   * 
+   * @param t_curr the current time
+   * @param get_coeff_data `(const Cell &) -> Scalar *`
+   */
+  template <class GetCoeffData>
+  void UpdateCoeffs(double t_curr, GetCoeffData &&get_coeff_data) {
+    assert(bins_.CountBoxes() == std::ssize(cells_));
+    for (auto &rotor : rotors_) {
+      rotor.UpdateAzimuth(t_curr);
+      for (int i = 0, n = rotor.CountBlades(); i < n; ++i) {
+        const Blade &blade = rotor.GetBlade(i);
+        bins_.Query(blade.P(), blade.Q(), &touched_cells_);
+        for (int i_cell : touched_cells_) {
+          const Cell &cell = *cells_[i_cell];
+          UpdateCoeff(cell, blade, get_coeff_data(cell));
+        }
+      }
+    }
+  }
+
   Rotorcraft &InstallRotor(const Rotor &rotor) {
     rotors_.emplace_back(rotor);
     return *this;
@@ -167,6 +222,9 @@ class Rotorcraft {
 
  protected:
   std::vector<Rotor> rotors_;
+  std::vector<const Cell *> cells_;  // [i_box] -> a Cell
+  Bins bins_;
+  std::vector<int> touched_cells_;  // reused by each Blade
 };
 
 }  // namespace aircraft
@@ -0,0 +1,126 @@
+//  Copyright 2024 PEI Weicheng
+#ifndef MINI_ALGEBRA_KRYLOV_HPP_
+#define MINI_ALGEBRA_KRYLOV_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "mini/algebra/eigen.hpp"
+
+namespace mini {
+namespace algebra {
+namespace krylov {
+
+/**
+ * @brief Solve a linear system \f$ A\,x = b \f$ by the restarted GMRES with right preconditioning.
+ *
+ * Only products of \f$ A \f$ and \f$ M^{-1} \f$ with columns are required, so neither matrix has to be formed.
+ * The residual is minimized in the norm induced by the given inner product, which should be reduced over all processes if the columns are distributed.
+ *
+ * @tparam Column the type of \f$ x \f$ and \f$ b \f$, which must be a dynamic Eigen vector
+ * @tparam Multiply the type of `(Column const &v, Column *a_v) -> void`, which writes \f$ A\,v \f$ into `a_v`
+ * @tparam Precondition the type of `(Column *v) -> void`, which overwrites `v` by \f$ M^{-1}\,v \f$
+ * @tparam Dot the type of `(Column const &x, Column const &y) -> Scalar`
+ * @param multiply the product of \f$ A \f$ and a column
+ * @param precondition the product of \f$ M^{-1} \f$ and a column
+ * @param dot the inner product of two columns
+ * @param b the right-hand side
+ * @param x the initial guess, which is overwritten by the solution
+ * @param relative_tolerance the iteration stops once the residual is reduced by this factor relative to \f$ \|b\| \f$
+ * @param max_iterations the maximum number of products of \f$ A \f$ (excluding those for restarting)
+ * @param restart the dimension of each Krylov subspace
+ * @param converged if not `nullptr`, overwritten by whether the tolerance is reached before `max_iterations`
+ * @return the number of iterations
+ */
+template <typename Column, typename Multiply, typename Precondition,
+    typename Dot>
+int Gmres(Multiply &&multiply, Precondition &&precondition, Dot &&dot,
+    Column const &b, Column *x, double relative_tolerance = 1e-3,
+    int max_iterations = 100, int restart = 30, bool *converged = nullptr) {
+  using Scalar = typename Column::Scalar;
+  assert(b.size() == x->size() && 1 <= restart);
+  auto norm = [&dot](Column const &v) {
+    return std::sqrt(std::max(Scalar(dot(v, v)), Scalar(0)));
+  };
+  Scalar target = relative_tolerance * norm(b);
+  int m = std::min(restart, max_iterations);
+  auto basis = std::vector<Column>(m + 1);
+  auto hessenberg = DynamicMatrix<Scalar>(m + 1, m);
+  auto cosines = DynamicVector<Scalar>(m), sines = DynamicVector<Scalar>(m);
+  auto g = DynamicVector<Scalar>(m + 1);
+  Column w;
+  int n_iterations = 0;
+  bool reached = false;
+  while (true) {
+    // r = b - A x, which is stored in basis[0]
+    multiply(*x, &w);
+    basis[0] = b - w;
+    Scalar beta = norm(basis[0]);
+    reached = beta <= target;
+    if (reached || n_iterations == max_iterations) {
+      break;
+    }
+    basis[0] /= beta;
+    g.setZero();
+    g[0] = beta;
+    int k = 0;
+    while (k < m && n_iterations < max_iterations) {
+      // w = A M^{-1} v_k, then orthogonalize it by modified Gram--Schmidt
+      basis[k + 1] = basis[k];
+      precondition(&basis[k + 1]);
+      multiply(basis[k + 1], &w);
+      for (int i = 0; i <= k; ++i) {
+        hessenberg(i, k) = dot(w, basis[i]);
+        w -= hessenberg(i, k) * basis[i];
+      }
+      hessenberg(k + 1, k) = norm(w);
+      // Apply previous Givens rotations to the new column.
+      for (int i = 0; i < k; ++i) {
+        Scalar h_i = hessenberg(i, k), h_j = hessenberg(i + 1, k);
+        hessenberg(i, k) = cosines[i] * h_i + sines[i] * h_j;
+        hessenberg(i + 1, k) = -sines[i] * h_i + cosines[i] * h_j;
+      }
+      Scalar h_k = hessenberg(k, k), h_next = hessenberg(k + 1, k);
+      Scalar r = std::hypot(h_k, h_next);
+      cosines[k] = r > 0 ? h_k / r : 1;
+      sines[k] = r > 0 ? h_next / r : 0;
+      if (h_next > 0) {
+        basis[k + 1] = w / h_next;
+      }
+      hessenberg(k, k) = r;
+      hessenberg(k + 1, k) = 0;
+      g[k + 1] = -sines[k] * g[k];
+      g[k] *= cosines[k];
+      ++k;
+      ++n_iterations;
+      if (std::abs(g[k]) <= target || h_next == 0) {
+        break;
+      }
+    }
+    // x += M^{-1} V y, in which H y = g
+    auto y = hessenberg.topLeftCorner(k, k).template triangularView<
+        Eigen::Upper>().solve(g.head(k)).eval();
+    w = basis[0] * y[0];
+    for (int i = 1; i < k; ++i) {
+      w += basis[i] * y[i];
+    }
+    precondition(&w);
+    *x += w;
+    reached = std::abs(g[k]) <= target;
+    if (reached) {
+      break;
+    }
+  }
+  if (converged) {
+    *converged = reached;
+  }
+  return n_iterations;
+}
+
+}  // namespace krylov
+}  // namespace algebra
+}  // namespace mini
+
+#endif  // MINI_ALGEBRA_KRYLOV_HPP_
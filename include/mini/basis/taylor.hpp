@@ -173,7 +173,7 @@ class Taylor {
 
  private:
   static MatNx1 _GetValue(const Coord &xy) requires(kDegrees == 0) {
-    return { 1 };
+    return MatNx1::Ones();
   }
 
   static MatNx1 _GetValue(const Coord &xy)
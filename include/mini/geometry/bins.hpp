@@ -0,0 +1,193 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_GEOMETRY_BINS_HPP_
+#define MINI_GEOMETRY_BINS_HPP_
+
+#include <concepts>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "mini/algebra/eigen.hpp"
+
+namespace mini {
+namespace geometry {
+
+/**
+ * @brief Whether the segment PQ intersects the axis-aligned box `[lower, upper]`.
+ *
+ * @tparam Point
+ * @param p the start of the segment
+ * @param q the end of the segment
+ * @param lower the lower corner of the box
+ * @param upper the upper corner of the box
+ */
+template <typename Point>
+bool IntersectBox(Point const &p, Point const &q,
+    Point const &lower, Point const &upper) {
+  using Scalar = typename Point::Scalar;
+  Scalar t_min = 0, t_max = 1;
+  for (int d = 0; d < 3; ++d) {
+    Scalar pq = q[d] - p[d];
+    if (pq == 0) {
+      if (p[d] < lower[d] || upper[d] < p[d]) {
+        return false;
+      }
+    } else {
+      Scalar t_0 = (lower[d] - p[d]) / pq;
+      Scalar t_1 = (upper[d] - p[d]) / pq;
+      if (t_0 > t_1) {
+        std::swap(t_0, t_1);
+      }
+      t_min = std::max(t_min, t_0);
+      t_max = std::min(t_max, t_1);
+      if (t_min > t_max) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief A uniform grid of bins over some axis-aligned boxes, which finds the boxes that might be intersected by a segment without visiting all of them.
+ *
+ * @tparam Scalar
+ */
+template <std::floating_point Scalar>
+class Bins {
+ public:
+  using Point = algebra::Vector<Scalar, 3>;
+
+ private:
+  std::vector<Point> lowers_, uppers_;  // [i_box] -> a corner of the box
+  std::vector<int> heads_;  // [i_bin] -> the head of its boxes in `boxes_`
+  std::vector<int> boxes_;  // [heads_[i_bin], heads_[i_bin + 1]) -> i_box
+  Point lower_, width_;  // the lower corner of the grid, the width of a bin
+  std::array<int, 3> n_bins_{0, 0, 0};
+
+  int GetBin(int i, int j, int k) const {
+    return i + n_bins_[0] * (j + n_bins_[1] * k);
+  }
+  int GetIndex(int d, Scalar x) const {
+    int i = std::floor((x - lower_[d]) / width_[d]);
+    return std::clamp(i, 0, n_bins_[d] - 1);
+  }
+
+ public:
+  /**
+   * @brief Build the bins over the given boxes.
+   *
+   * @param lowers `[i_box]` -> the lower corner of the box
+   * @param uppers `[i_box]` -> the upper corner of the box
+   * @param n_boxes_per_bin the average number of boxes in a bin
+   */
+  Bins(std::vector<Point> lowers, std::vector<Point> uppers,
+      int n_boxes_per_bin = 4)
+      : lowers_(std::move(lowers)), uppers_(std::move(uppers)) {
+    assert(lowers_.size() == uppers_.size());
+    assert(n_boxes_per_bin >= 1);
+    int n_boxes = lowers_.size();
+    if (n_boxes == 0) {
+      return;
+    }
+    Point upper = uppers_.front();
+    lower_ = lowers_.front();
+    for (int i_box = 1; i_box < n_boxes; ++i_box) {
+      lower_ = lower_.cwiseMin(lowers_[i_box]);
+      upper = upper.cwiseMax(uppers_[i_box]);
+    }
+    // avoid zero widths on a flat grid
+    Point extent = upper - lower_;
+    extent.array() += extent.maxCoeff() * 1e-6 + 1e-300;
+    Scalar n_bins = std::max(1, n_boxes / n_boxes_per_bin);
+    Scalar width = std::cbrt(extent.prod() / n_bins);
+    for (int d = 0; d < 3; ++d) {
+      n_bins_[d] = std::clamp<Scalar>(std::ceil(extent[d] / width), 1, n_bins);
+      width_[d] = extent[d] / n_bins_[d];
+    }
+    // count boxes in each bin, then fill them in the CSR format
+    heads_.assign(n_bins_[0] * n_bins_[1] * n_bins_[2] + 1, 0);
+    auto for_each_bin = [this](int i_box, auto &&visit) {
+      auto &lower = lowers_[i_box], &upper = uppers_[i_box];
+      for (int k = GetIndex(2, lower[2]); k <= GetIndex(2, upper[2]); ++k) {
+        for (int j = GetIndex(1, lower[1]); j <= GetIndex(1, upper[1]); ++j) {
+          for (int i = GetIndex(0, lower[0]); i <= GetIndex(0, upper[0]); ++i) {
+            visit(GetBin(i, j, k));
+          }
+        }
+      }
+    };
+    for (int i_box = 0; i_box < n_boxes; ++i_box) {
+      for_each_bin(i_box, [this](int i_bin) { ++heads_[i_bin + 1]; });
+    }
+    for (int i_bin = 1; i_bin < std::ssize(heads_); ++i_bin) {
+      heads_[i_bin] += heads_[i_bin - 1];
+    }
+    boxes_.resize(heads_.back());
+    auto tails = std::vector<int>(heads_.begin(), heads_.end() - 1);
+    for (int i_box = 0; i_box < n_boxes; ++i_box) {
+      for_each_bin(i_box, [this, &tails, i_box](int i_bin) {
+        boxes_[tails[i_bin]++] = i_box;
+      });
+    }
+  }
+  Bins() = default;
+  Bins(Bins const &) = default;
+  Bins &operator=(Bins const &) = default;
+  Bins(Bins &&) noexcept = default;
+  Bins &operator=(Bins &&) noexcept = default;
+  ~Bins() noexcept = default;
+
+  int CountBoxes() const {
+    return lowers_.size();
+  }
+  int CountBins() const {
+    return n_bins_[0] * n_bins_[1] * n_bins_[2];
+  }
+
+  /**
+   * @brief Get the boxes intersected by the segment PQ.
+   *
+   * @param p the start of the segment
+   * @param q the end of the segment
+   * @param boxes the sorted indices of the intersected boxes, each of which appears only once
+   */
+  void Query(Point const &p, Point const &q, std::vector<int> *boxes) const {
+    boxes->clear();
+    if (CountBoxes() == 0) {
+      return;
+    }
+    Point lower = p.cwiseMin(q), upper = p.cwiseMax(q);
+    for (int k = GetIndex(2, lower[2]); k <= GetIndex(2, upper[2]); ++k) {
+      for (int j = GetIndex(1, lower[1]); j <= GetIndex(1, upper[1]); ++j) {
+        for (int i = GetIndex(0, lower[0]); i <= GetIndex(0, upper[0]); ++i) {
+          Point bin_lower = lower_;
+          bin_lower += Point(i, j, k).cwiseProduct(width_);
+          Point bin_upper = bin_lower + width_;
+          if (!IntersectBox(p, q, bin_lower, bin_upper)) {
+            continue;
+          }
+          int i_bin = GetBin(i, j, k);
+          for (int b = heads_[i_bin]; b < heads_[i_bin + 1]; ++b) {
+            int i_box = boxes_[b];
+            if (IntersectBox(p, q, lowers_[i_box], uppers_[i_box])) {
+              boxes->emplace_back(i_box);
+            }
+          }
+        }
+      }
+    }
+    std::ranges::sort(*boxes);
+    auto [first, last] = std::ranges::unique(*boxes);
+    boxes->erase(first, last);
+  }
+};
+
+}  // namespace geometry
+}  // namespace mini
+
+#endif  // MINI_GEOMETRY_BINS_HPP_
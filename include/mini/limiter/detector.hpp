@@ -0,0 +1,155 @@
+//  Copyright 2024 PEI Weicheng
+#ifndef MINI_LIMITER_DETECTOR_HPP_
+#define MINI_LIMITER_DETECTOR_HPP_
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "mini/polynomial/concept.hpp"
+
+namespace mini {
+namespace limiter {
+
+/**
+ * @brief Troubled-cell detectors, which tell a limiter which cells need to be reconstructed.
+ *
+ */
+namespace detector {
+
+/**
+ * @brief Mark every cell as troubled.
+ *
+ * @tparam Cell the type of cells
+ */
+template <typename Cell>
+class Always {
+ public:
+  bool IsNotSmooth(const Cell &cell) const {
+    return true;
+  }
+};
+
+/**
+ * @brief The jump indicator proposed by Krivodonova, Xin, Remacle, Chevaugeon and Flaherty (KXRCF).
+ *
+ * The jumps are integrated on the inflow part of the adjacent faces, i.e. where the momentum of this cell points into it.
+ * The components are assumed to be conservative variables (e.g. density, momentum, energy), and only the 0th and the last ones are checked.
+ * If there are no momentum components (e.g. for scalar equations) or no inflow point at all (e.g. for a fluid at rest), the jumps are integrated on all adjacent faces.
+ *
+ * @tparam Cell the type of cells
+ */
+template <typename Cell>
+class Krivodonova {
+ public:
+  using Scalar = typename Cell::Scalar;
+  using Value = typename Cell::Value;
+
+ private:
+  Scalar threshold_;
+
+  static constexpr bool kHasMomentum = (Cell::K >= Cell::D + 2);
+
+ public:
+  explicit Krivodonova(Scalar threshold = 1.0)
+      : threshold_(threshold) {
+  }
+
+  bool IsNotSmooth(const Cell &cell) const {
+    constexpr int components[] = { 0, Cell::K - 1 };
+    Value inflow_jumps, all_jumps;
+    inflow_jumps.setZero(); all_jumps.setZero();
+    Scalar inflow_area = 0, all_area = 0;
+    for (auto *adj_face : cell.adj_faces_) {
+      auto const *adj_cell = adj_face->other(&cell);
+      // the normal vectors point from the holder to the sharer
+      Scalar sign = (adj_cell == &adj_face->sharer()) ? 1 : -1;
+      auto const &integrator = adj_face->integrator();
+      for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
+        auto const &global = integrator.GetGlobal(q);
+        Value value = cell.GlobalToValue(global);
+        Value jump = value - adj_cell->GlobalToValue(global);
+        jump = jump.cwiseAbs() * integrator.GetGlobalWeight(q);
+        all_jumps += jump;
+        all_area += integrator.GetGlobalWeight(q);
+        if constexpr (kHasMomentum) {
+          auto const &normal = integrator.GetNormalFrame(q)[0];
+          if (sign * value.template segment<Cell::D>(1).dot(normal) < 0) {
+            inflow_jumps += jump;
+            inflow_area += integrator.GetGlobalWeight(q);
+          }
+        }
+      }
+    }
+    bool use_inflow = (inflow_area > 0);
+    auto const &jumps = use_inflow ? inflow_jumps : all_jumps;
+    auto area = use_inflow ? inflow_area : all_area;
+    constexpr auto length_power = (Cell::P + 1.0) / 2.0;
+    auto divisor = area * std::pow(cell.length(), length_power);
+    auto averages = cell.polynomial().average();
+    for (int i : components) {
+      auto indicator = jumps[i] / divisor
+          / std::max(Scalar(1e-9), std::abs(averages[i]));
+      if (indicator > threshold_) {
+        return true;  // if any component is not smooth
+      }
+    }
+    return false;  // if all components are smooth
+  }
+};
+
+/**
+ * @brief The modal-decay indicator proposed by Persson and Peraire.
+ *
+ * On an orthonormal basis, the energy carried by the highest-degree modes is compared with the total energy, and a cell is marked as troubled if their ratio exceeds \f$ 10^{s_0} \f$, in which \f$ s_0 = s_\mathrm{offset} - 4 \log_{10} P \f$.
+ * Only the 0th and the last components (e.g. density and energy) are checked.
+ *
+ * @tparam Cell the type of cells
+ */
+template <typename Cell>
+    requires mini::polynomial::Modal<typename Cell::Polynomial>
+class PerssonPeraire {
+ public:
+  using Scalar = typename Cell::Scalar;
+  using Projection = std::remove_cvref_t<
+      decltype(std::declval<Cell>().polynomial().projection())>;
+  using Taylor = typename Projection::Taylor;
+
+ private:
+  Scalar ratio_;
+
+ public:
+  explicit PerssonPeraire(Scalar offset = 0.0)
+      : ratio_(std::pow(10.0, offset) / std::pow(Cell::P, 4)) {
+  }
+
+  bool IsNotSmooth(const Cell &cell) const {
+    if constexpr (Cell::P == 0) {
+      return false;
+    } else {
+      constexpr int components[] = { 0, Cell::K - 1 };
+      // the modes whose degree is lower than P
+      constexpr int kLower = Taylor::CountBasis(Cell::P - 1);
+      constexpr int kHighest = Projection::N - kLower;
+      // coefficients on an orthonormal basis
+      auto const &coeff = cell.polynomial().projection().coeff();
+      for (int i : components) {
+        auto total = coeff.row(i).squaredNorm();
+        auto highest = coeff.row(i).template tail<kHighest>().squaredNorm();
+        if (highest > total * ratio_) {
+          return true;  // if any component is not smooth
+        }
+      }
+      return false;  // if all components are smooth
+    }
+  }
+};
+
+}  // namespace detector
+}  // namespace limiter
+}  // namespace mini
+
+#endif  // MINI_LIMITER_DETECTOR_HPP_
@@ -18,16 +18,27 @@
 namespace mini {
 namespace limiter {
 
+/**
+ * @brief Reconstruct the troubled cells marked by the given limiter.
+ * 
+ * @tparam Part the type of the mesh partition
+ * @tparam Limiter the type of the limiter, which provides `IsNotSmooth(cell)` and `Reconstruct(cell)`
+ * @param part_ptr the mesh partition
+ * @param limiter_ptr the limiter
+ * @return the number of troubled cells on this partition
+ */
 template <class Part, class Limiter>
-void Reconstruct(Part *part_ptr, Limiter *limiter_ptr) {
+typename Part::Index Reconstruct(Part *part_ptr, Limiter *limiter_ptr) {
   if (!(Part::kDegrees && limiter_ptr)) {
-    return;
+    return 0;
   }
   using Cell = typename Part::Cell;
   using ProjectionWrapper
       = typename std::remove_reference_t<Limiter>::ProjectionWrapper;
 
-  auto act = [limiter_ptr](std::vector<Cell *> const &cell_ptrs) {
+  typename Part::Index n_troubled_cells = 0;
+  auto act = [limiter_ptr, &n_troubled_cells](
+      std::vector<Cell *> const &cell_ptrs) {
     auto troubled_cells = std::vector<Cell *>();
     for (Cell *cell_ptr : cell_ptrs) {
       if (limiter_ptr->IsNotSmooth(*cell_ptr)) {
@@ -35,6 +46,7 @@ void Reconstruct(Part *part_ptr, Limiter *limiter_ptr) {
       }
     }
     auto new_projections = std::vector<ProjectionWrapper>();
+    new_projections.reserve(troubled_cells.size());
     for (Cell *cell_ptr : troubled_cells) {
       new_projections.emplace_back(limiter_ptr->Reconstruct(*cell_ptr));
     }
@@ -43,6 +55,7 @@ void Reconstruct(Part *part_ptr, Limiter *limiter_ptr) {
       cell_ptr->polynomial().SetCoeff(new_projections[i++].coeff());
     }
     assert(i == troubled_cells.size());
+    n_troubled_cells += troubled_cells.size();
   };
 
   // run the limiter on inner cells that need no ghost cells
@@ -51,6 +64,7 @@ void Reconstruct(Part *part_ptr, Limiter *limiter_ptr) {
   // run the limiter on inter cells that need ghost cells
   part_ptr->UpdateGhostCellCoeffs();
   act(part_ptr->GetInterCellPointers());
+  return n_troubled_cells;
 }
 
 }  // namespace limiter
@@ -11,10 +11,12 @@
 #include <iostream>
 #include <numeric>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "mini/basis/taylor.hpp"
+#include "mini/limiter/detector.hpp"
 #include "mini/polynomial/concept.hpp"
 #include "mini/riemann/concept.hpp"
 
@@ -94,8 +96,120 @@ auto GetSmoothness(const Projection &proj) {
   return Smoothness<Scalar, K, P>::GetSmoothness(integral, volume);
 }
 
+/**
+ * @brief Get the matrix of the quadratic form that gives the smoothness on a given basis.
+ *
+ * For any `proj` on `basis`, `GetSmoothness(proj)[k] == proj.coeff().row(k) * matrix * proj.coeff().row(k).transpose()`.
+ *
+ * @tparam Basis the type of the orthonormal basis
+ * @param basis the orthonormal basis
+ * @return the symmetric matrix of the quadratic form
+ */
+template <class Basis>
+auto GetSmoothnessMatrix(const Basis &basis) {
+  using Scalar = typename Basis::Scalar;
+  using Taylor = typename Basis::Taylor;
+  using Coord = typename Basis::Coord;
+  using MatNxN = typename Basis::MatNxN;
+  constexpr int N = Basis::N;
+  constexpr int P = Taylor::P;
+  // weights of partial derivatives, grouped by their orders
+  auto volume = basis.Measure();
+  algebra::Matrix<Scalar, N, 1> weights; weights.setZero();
+  for (int p = 1; p <= P; ++p) {
+    weights.segment(Taylor::CountBasis(p - 1),
+        Taylor::CountBasis(p) - Taylor::CountBasis(p - 1)).setConstant(
+            Smoothness<Scalar, 1, P>::GetWeight(volume, p));
+  }
+  auto mat_pdv_func = [&basis, &weights](Coord const &xyz) {
+    auto local = xyz; local -= basis.center();
+    // the i-th row holds the partial derivatives of the i-th basis function
+    MatNxN mat_pdv = Taylor::GetPartialDerivatives(local, basis.coeff());
+    MatNxN mat_pdv_pdv = mat_pdv * weights.asDiagonal() * mat_pdv.transpose();
+    return mat_pdv_pdv;
+  };
+  return integrator::Integrate(mat_pdv_func, basis.integrator());
+}
+
+/**
+ * @brief Cached operators for borrowing projections from adjacent cells and measuring their smoothness.
+ *
+ * Since the geometry is static, the operators of a cell are built on its first query and reused afterwards.
+ *
+ * @tparam Cell the type of cells
+ */
 template <typename Cell>
     requires mini::polynomial::Modal<typename Cell::Polynomial>
+class Operators {
+ public:
+  using Projection = std::remove_cvref_t<
+      decltype(std::declval<Cell>().polynomial().projection())>;
+  using Basis = typename Projection::Basis;
+  using Global = typename Projection::Global;
+  using Scalar = typename Projection::Scalar;
+  static constexpr int K = Projection::K;
+  static constexpr int N = Projection::N;
+  using MatNxN = algebra::Matrix<Scalar, N, N>;
+  using MatKxN = algebra::Matrix<Scalar, K, N>;
+  using MatKx1 = algebra::Matrix<Scalar, K, 1>;
+
+  struct Entry {
+    /**
+     * @brief `borrowings[i]` maps the coefficients of `adj_cells_[i]` to those on this cell's basis.
+     */
+    std::vector<MatNxN> borrowings;
+    /**
+     * @brief The matrix of the quadratic form given by `GetSmoothnessMatrix()`.
+     */
+    MatNxN smoothness;
+
+    MatKxN Borrow(int i_adj, const MatKxN &adj_coeff) const {
+      return adj_coeff * borrowings[i_adj];
+    }
+    MatKx1 GetSmoothness(const MatKxN &coeff) const {
+      return (coeff * smoothness).cwiseProduct(coeff).rowwise().sum();
+    }
+  };
+
+ private:
+  std::unordered_map<Cell const *, Entry> entries_;
+
+ public:
+  static Entry BuildEntry(const Cell &cell) {
+    auto const &my_basis = cell.polynomial().projection().basis();
+    auto entry = Entry();
+    entry.borrowings.reserve(cell.adj_cells_.size());
+    for (auto *adj_cell : cell.adj_cells_) {
+      assert(adj_cell);
+      auto const &adj_basis = adj_cell->polynomial().projection().basis();
+      auto mat_func = [&my_basis, &adj_basis](Global const &xyz) {
+        MatNxN mat = adj_basis(xyz) * my_basis(xyz).transpose();
+        return mat;
+      };
+      entry.borrowings.emplace_back(
+          integrator::Integrate(mat_func, my_basis.integrator()));
+    }
+    entry.smoothness = GetSmoothnessMatrix(my_basis);
+    return entry;
+  }
+
+  Entry const &operator()(const Cell &cell) {
+    auto iter = entries_.find(&cell);
+    if (iter == entries_.end()) {
+      iter = entries_.emplace(&cell, BuildEntry(cell)).first;
+    }
+    return iter->second;
+  }
+};
+
+/**
+ * @brief A WENO limiter using smoothness indicators of the borrowed projections.
+ * 
+ * @tparam Cell the type of cells
+ * @tparam Detector the type of the troubled-cell detector, which marks every cell as troubled by default
+ */
+template <typename Cell, typename Detector = detector::Always<Cell>>
+    requires mini::polynomial::Modal<typename Cell::Polynomial>
 class Lazy {
  public:
   using Scalar = typename Cell::Scalar;
@@ -109,18 +223,22 @@ class Lazy {
   std::vector<ProjectionWrapper> old_projections_;
   ProjectionWrapper *new_projection_ptr_ = nullptr;
   const Cell *my_cell_ = nullptr;
+  typename Operators<Cell>::Entry const *my_operators_ = nullptr;
+  Operators<Cell> operators_;
   Value weights_;
   Scalar eps_;
+  Detector detector_;
   bool verbose_;
 
  public:
-  Lazy(Scalar w0, Scalar eps, bool verbose = false)
-      : eps_(eps), verbose_(verbose) {
+  Lazy(Scalar w0, Scalar eps, bool verbose = false,
+      Detector const &detector = Detector())
+      : eps_(eps), detector_(detector), verbose_(verbose) {
     weights_.setOnes();
     weights_ *= w0;
   }
-  bool IsNotSmooth(const Cell &cell) {
-    return true;
+  bool IsNotSmooth(const Cell &cell) const {
+    return detector_.IsNotSmooth(cell);
   }
   ProjectionWrapper Reconstruct(const Cell &cell) {
     my_cell_ = &cell;
@@ -140,14 +258,14 @@ class Lazy {
     old_projections_.reserve(my_cell_->adj_cells_.size() + 1);
     auto const &my_projection = my_cell_->polynomial().projection();
     auto my_average = my_projection.average();
+    my_operators_ = &operators_(*my_cell_);
+    int i_adj = 0;
     for (auto *adj_cell : my_cell_->adj_cells_) {
       assert(adj_cell);
       auto &adj_proj = old_projections_.emplace_back(my_projection.basis());
       assert(&(adj_proj.basis()) == &(my_projection.basis()));
-      auto adj_func = [&adj_cell](Global const &global) {
-        return adj_cell->polynomial().GlobalToValue(global);
-      };
-      adj_proj.Approximate(adj_func);
+      adj_proj.SetCoeff(my_operators_->Borrow(i_adj++,
+          adj_cell->polynomial().projection().coeff()));
       adj_proj += my_average - adj_proj.average();
       if (verbose_) {
         std::cout << "\n  adj smoothness[" << adj_cell->metis_id << "] = ";
@@ -172,7 +290,7 @@ class Lazy {
     weights.back().array() += 1.0;
     // modify weights by smoothness
     for (int i = 0; i <= adj_cnt; ++i) {
-      auto beta = GetSmoothness(old_projections_[i]);
+      auto beta = my_operators_->GetSmoothness(old_projections_[i].coeff());
       beta.array() += eps_;
       beta.array() *= beta.array();
       weights[i].array() /= beta.array();
@@ -211,6 +329,8 @@ class Eigen {
   ProjectionWrapper new_projection_;
   std::vector<ProjectionWrapper> old_projections_;
   const Cell *my_cell_ = nullptr;
+  typename Operators<Cell>::Entry const *my_operators_ = nullptr;
+  Operators<Cell> operators_;
   Value weights_;
   Scalar eps_;
   Scalar total_volume_;
@@ -273,12 +393,12 @@ class Eigen {
     old_projections_.reserve(my_cell_->adj_cells_.size() + 1);
     auto const &my_projection = my_cell_->polynomial().projection();
     auto my_average = my_projection.average();
+    my_operators_ = &operators_(*my_cell_);
+    int i_adj = 0;
     for (auto *adj_cell : my_cell_->adj_cells_) {
       auto &adj_proj = old_projections_.emplace_back(my_projection.basis());
-      auto adj_func = [&adj_cell](Global const &global) {
-        return adj_cell->polynomial().GlobalToValue(global);
-      };
-      adj_proj.Approximate(adj_func);
+      adj_proj.SetCoeff(my_operators_->Borrow(i_adj++,
+          adj_cell->polynomial().projection().coeff()));
       adj_proj += my_average - adj_proj.average();
     }
     old_projections_.emplace_back(my_projection);
@@ -305,7 +425,7 @@ class Eigen {
     for (int i = 0; i <= adj_cnt; ++i) {
       auto &projection_i = rotated_projections[i];
       projection_i.LeftMultiply(riemann->L());
-      auto beta = GetSmoothness(projection_i);
+      auto beta = my_operators_->GetSmoothness(projection_i.coeff());
       beta.array() += eps_;
       beta.array() *= beta.array();
       weights[i].array() /= beta.array();
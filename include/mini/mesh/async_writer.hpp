@@ -0,0 +1,195 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_MESH_ASYNC_WRITER_HPP_
+#define MINI_MESH_ASYNC_WRITER_HPP_
+
+#include <cassert>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
+#include "mpi.h"
+
+namespace mini {
+namespace mesh {
+
+/**
+ * @brief A bounded FIFO of output tasks, which are run by a background thread while the calling thread carries on computing.
+ *
+ * Each task gets a duplicate of the given communicator, so collective I/O (e.g. `cgp_*` calls) in the background thread never interleaves with collective calls on the original communicator.
+ * Since that requires `MPI_THREAD_MULTIPLE`, tasks are run at once on the calling thread if MPI is initialized with a lower thread level.
+ * Tasks must be pushed by all ranks in the same order, and their data must outlive them (i.e. call `Flush` before destroying them).
+ *
+ * Libraries like CGNS keep global states (e.g. the communicator set by `cgp_mpi_comm`), so the calling thread must not use them while any task is pending.
+ * Call `FlushAll` before doing so, as `part::Part` does before reading or writing CGNS files.
+ * Exceptions thrown by tasks are rethrown by the next `Push`, `Flush` or the destructor.
+ */
+class AsyncWriter {
+ public:
+  using Task = std::function<void(MPI_Comm)>;
+
+ private:
+  std::deque<Task> tasks_;
+  std::mutex mutex_;
+  std::condition_variable not_full_, not_empty_, idle_;
+  std::thread thread_;
+  std::exception_ptr error_;
+  MPI_Comm comm_;
+  std::size_t capacity_;
+  bool async_, running_{false}, stopped_{false};
+
+  static std::mutex &GetRegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+  static std::set<AsyncWriter *> &GetRegistry() {
+    static std::set<AsyncWriter *> writers;
+    return writers;
+  }
+
+  void Run() {
+    while (true) {
+      Task task;
+      {
+        auto lock = std::unique_lock(mutex_);
+        not_empty_.wait(lock, [this] { return stopped_ || !tasks_.empty(); });
+        if (tasks_.empty()) {
+          return;  // stopped and drained
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+        running_ = true;
+      }
+      not_full_.notify_one();
+      try {
+        task(comm_);
+      } catch (...) {
+        auto lock = std::unique_lock(mutex_);
+        if (!error_) {
+          error_ = std::current_exception();
+        }
+      }
+      {
+        auto lock = std::unique_lock(mutex_);
+        running_ = false;
+      }
+      idle_.notify_all();
+    }
+  }
+  void Rethrow() {
+    if (error_) {
+      auto error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+ public:
+  /**
+   * @brief Construct a new AsyncWriter object.
+   *
+   * It must be called by all ranks in `comm`.
+   *
+   * @param comm the communicator on which the tasks do collective I/O
+   * @param capacity the max number of pending tasks, which bounds the memory held by snapshots
+   */
+  explicit AsyncWriter(MPI_Comm comm = MPI_COMM_WORLD, int capacity = 2)
+      : capacity_(capacity) {
+    assert(capacity >= 1);
+    int thread_level;
+    MPI_Query_thread(&thread_level);
+    async_ = (thread_level == MPI_THREAD_MULTIPLE);
+    if (async_) {
+      MPI_Comm_dup(comm, &comm_);
+      thread_ = std::thread(&AsyncWriter::Run, this);
+      auto lock = std::unique_lock(GetRegistryMutex());
+      GetRegistry().emplace(this);
+    } else {
+      comm_ = comm;
+    }
+  }
+  AsyncWriter(const AsyncWriter &) = delete;
+  AsyncWriter &operator=(const AsyncWriter &) = delete;
+  AsyncWriter(AsyncWriter &&) = delete;
+  AsyncWriter &operator=(AsyncWriter &&) = delete;
+  /**
+   * @brief Run the pending tasks, then stop the background thread.
+   *
+   * An exception thrown by any task is rethrown, unless the stack is being unwound by another one.
+   */
+  ~AsyncWriter() noexcept(false) {
+    if (async_) {
+      {
+        auto lock = std::unique_lock(GetRegistryMutex());
+        GetRegistry().erase(this);
+      }
+      {
+        auto lock = std::unique_lock(mutex_);
+        stopped_ = true;
+      }
+      not_empty_.notify_one();
+      thread_.join();
+      MPI_Comm_free(&comm_);
+      if (std::uncaught_exceptions() == 0) {
+        Rethrow();
+      }
+    }
+  }
+
+  bool async() const {
+    return async_;
+  }
+
+  /**
+   * @brief Append a task to the queue, which blocks while the queue is full.
+   *
+   * @param task the task to be run in the background thread
+   */
+  void Push(Task &&task) {
+    if (!async_) {
+      task(comm_);
+      return;
+    }
+    {
+      auto lock = std::unique_lock(mutex_);
+      not_full_.wait(lock, [this] { return tasks_.size() < capacity_; });
+      Rethrow();
+      tasks_.emplace_back(std::move(task));
+    }
+    not_empty_.notify_one();
+  }
+
+  /**
+   * @brief Block until all pushed tasks are done.
+   *
+   */
+  void Flush() {
+    if (async_) {
+      auto lock = std::unique_lock(mutex_);
+      idle_.wait(lock, [this] { return tasks_.empty() && !running_; });
+      Rethrow();
+    }
+  }
+
+  /**
+   * @brief Block until all tasks pushed to all living `AsyncWriter`s are done.
+   *
+   * It must be called before the calling thread uses any library shared with the tasks.
+   */
+  static void FlushAll() {
+    auto lock = std::unique_lock(GetRegistryMutex());
+    for (auto *writer : GetRegistry()) {
+      writer->Flush();
+    }
+  }
+};
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_ASYNC_WRITER_HPP_
@@ -0,0 +1,132 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_MESH_HALO_HPP_
+#define MINI_MESH_HALO_HPP_
+
+#include <cassert>
+
+#include <utility>
+#include <vector>
+
+#include "mpi.h"
+
+namespace mini {
+namespace mesh {
+
+/**
+ * @brief Persistent point-to-point messages between neighboring ranks, whose buffers and requests are built once and reused in every exchange.
+ *
+ * Each exchange packs data into `send_buf(i)`, calls `Start`, overlaps computation with communication, calls `Wait`, and unpacks data from `recv_buf(i)`.
+ *
+ * @tparam Scalar the type of scalars in the buffers
+ */
+template <typename Scalar>
+class Halo {
+  std::vector<std::vector<Scalar>> send_bufs_, recv_bufs_;
+  std::vector<MPI_Request> requests_;
+
+  void Free() noexcept {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (finalized) {
+      return;
+    }
+    for (auto &request : requests_) {
+      if (request != MPI_REQUEST_NULL) {
+        MPI_Request_free(&request);
+      }
+    }
+    requests_.clear();
+  }
+
+ public:
+  /**
+   * @brief Build the buffers and the persistent requests.
+   *
+   * Messages from this rank to `i_rank` are tagged by `i_rank`, so the `n`-th send to a rank matches the `n`-th recv on that rank.
+   *
+   * @param send_sizes `[(i_rank, n_scalars)]`, the messages to be sent
+   * @param recv_sizes `[(i_rank, n_scalars)]`, the messages to be received
+   * @param comm the communicator
+   * @param datatype the MPI datatype of `Scalar`
+   */
+  Halo(std::vector<std::pair<int, int>> const &send_sizes,
+      std::vector<std::pair<int, int>> const &recv_sizes,
+      MPI_Comm comm, MPI_Datatype datatype) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    requests_.reserve(send_sizes.size() + recv_sizes.size());
+    for (auto [i_rank, size] : send_sizes) {
+      auto &buf = send_bufs_.emplace_back(size);
+      auto &request = requests_.emplace_back();
+      MPI_Send_init(buf.data(), size, datatype, i_rank, /* tag = */i_rank,
+          comm, &request);
+    }
+    for (auto [i_rank, size] : recv_sizes) {
+      auto &buf = recv_bufs_.emplace_back(size);
+      auto &request = requests_.emplace_back();
+      MPI_Recv_init(buf.data(), size, datatype, i_rank, /* tag = */rank,
+          comm, &request);
+    }
+  }
+  Halo() = default;
+  Halo(const Halo &) = delete;
+  Halo &operator=(const Halo &) = delete;
+  // Moving std::vector keeps the addresses of the buffers bound to requests.
+  Halo(Halo &&that) noexcept
+      : send_bufs_(std::move(that.send_bufs_)),
+        recv_bufs_(std::move(that.recv_bufs_)),
+        requests_(std::move(that.requests_)) {
+    that.requests_.clear();
+  }
+  Halo &operator=(Halo &&that) noexcept {
+    if (this != &that) {
+      Free();
+      send_bufs_ = std::move(that.send_bufs_);
+      recv_bufs_ = std::move(that.recv_bufs_);
+      requests_ = std::move(that.requests_);
+      that.requests_.clear();
+    }
+    return *this;
+  }
+  ~Halo() noexcept {
+    Free();
+  }
+
+  std::vector<Scalar> &send_buf(int i) {
+    return send_bufs_[i];
+  }
+  std::vector<Scalar> &recv_buf(int i) {
+    return recv_bufs_[i];
+  }
+  int CountSendBufs() const {
+    return send_bufs_.size();
+  }
+  int CountRecvBufs() const {
+    return recv_bufs_.size();
+  }
+
+  /**
+   * @brief Start all sends and recvs, which should be called after packing `send_buf`s.
+   *
+   */
+  void Start() {
+    if (requests_.size()) {
+      MPI_Startall(requests_.size(), requests_.data());
+    }
+  }
+
+  /**
+   * @brief Wait until all sends and recvs started by `Start` are done, so `recv_buf`s can be unpacked.
+   *
+   */
+  void Wait() {
+    if (requests_.size()) {
+      MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+    }
+  }
+};
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_HALO_HPP_
@@ -0,0 +1,1273 @@
+// Copyright 2024 PEI Weicheng
+
+#ifndef MINI_MESH_PARALLEL_SHUFFLER_HPP_
+#define MINI_MESH_PARALLEL_SHUFFLER_HPP_
+
+#include <concepts>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mpi.h"
+#include "pcgnslib.h"
+#ifdef ENABLE_PARMETIS
+#include "parmetis.h"
+#endif
+
+#include "mini/mesh/cgns.hpp"
+#include "mini/mesh/metis.hpp"
+#include "mini/mesh/partition.hpp"
+
+namespace mini {
+namespace mesh {
+
+/**
+ * @brief Partition a CGNS mesh and shuffle it into the layout expected by `part::Part`, using all ranks of a communicator.
+ *
+ * Unlike `Shuffler::PartitionAndShuffle`, which runs on a single rank and holds the whole mesh in its memory, each rank here only reads a slab of nodes, cells and faces by `cgp_*` calls.
+ * The dual graph is built by matching faces on the ranks that own their smallest nodes.
+ * It is partitioned by ParMETIS if `ENABLE_PARMETIS` is defined, otherwise the cells are sorted along a Morton curve through their centers by a parallel sample sort and cut into parts of almost equal sizes, so no rank ever holds the whole graph.
+ * The parts got along the curve are balanced, but their interfaces are larger than those got by a graph partitioner, so callers are expected to use `Shuffler` unless `ENABLE_PARMETIS` is defined or the mesh does not fit into the memory of one rank.
+ * Each part is then sent to the rank of the same id, which writes it into the shuffled file and writes its own partition info.
+ *
+ * @tparam Int the type of integers
+ * @tparam Real the type of real numbers
+ */
+template <std::integral Int, std::floating_point Real>
+class ParallelShuffler {
+ public:
+  using ElementType = cgns::ElementType;
+  using BC = cgns::BC<Real>;
+
+  /**
+   * @brief Partition `old_cgns_name` into as many parts as the ranks in `comm`, then write `case_name/shuffled.cgns` and the part info in `case_name/partition/`.
+   *
+   * It must be called by all ranks in `comm`.
+   */
+  static void PartitionAndShuffle(std::string const &case_name,
+      std::string const &old_cgns_name, MPI_Comm comm = MPI_COMM_WORLD);
+
+ private:
+  static constexpr int kBase = 1;
+  static constexpr int kMaxNpe = 8;
+  static constexpr auto kRealType
+      = sizeof(Real) == 8 ? CGNS_ENUMV(RealDouble) : CGNS_ENUMV(RealSingle);
+  static const MPI_Datatype kMpiIntType;
+  static const MPI_Datatype kMpiRealType;
+
+  struct Sect {
+    std::string name;
+    ElementType type;
+    int i_zone, i_sect, i_sect_old, dim, npe;
+    cgsize_t first, first_old, n_cells;
+    Int head{-1};  // the global id of its first cell or face
+  };
+  struct Zone {
+    std::string name;
+    cgsize_t n_nodes, n_cells;
+    Int node_head;  // the metis id of its first node
+    std::vector<int> sects;  // indices in `sects_`
+    std::vector<BC> bocos;
+  };
+  struct Family {
+    char name[33], child[33];
+  };
+  // records sent between ranks
+  struct Pair {
+    Int first, second;
+  };
+  struct FaceKey {
+    std::array<Int, 4> nodes;  // sorted metis ids, followed by -1s
+    Int source;  // a cell if >= 0, or the (-1 - source)-th face if < 0
+  };
+  struct Element {
+    Int metis, new_id;
+    int i_sect, ghost;
+    std::array<Int, kMaxNpe> nodes;  // metis ids
+  };
+  struct CurvePoint {
+    uint64_t key;  // the position on a Morton curve
+    Int m_cell;
+  };
+  struct Adjacency {
+    Int i, j, part_j;
+  };
+  struct Node {
+    Int metis, new_id;
+    int i_zone;
+    Real xyz[3];
+  };
+  struct Numbering {
+    std::vector<Int> new_ids;  // [i_local] -> 0-based id in its group
+    std::vector<Pair> ranges;  // [i_group * n_parts + i_part] -> [head, tail)
+  };
+
+  MPI_Comm comm_;
+  int rank_, size_, cell_dim_, phys_dim_;
+  char base_name_[33];
+  std::vector<Zone> zones_;  // [i_zone - 1]
+  std::vector<Sect> sects_;
+  std::vector<int> cell_sects_, face_sects_;  // indices in `sects_`
+  std::vector<Family> families_;
+  // `*_dist_[r]` is the first global id on rank `r`
+  std::vector<Int> node_dist_, cell_dist_, face_dist_;
+  // data in the slabs owned by this rank
+  std::vector<Real> x_, y_, z_;
+  std::vector<Int> node_parts_;
+  std::vector<Int> cell_nodes_, face_nodes_;  // [i_local * kMaxNpe + k]
+  std::vector<int> cell_sect_, face_sect_;  // [i_local] -> index in `sects_`
+  std::vector<Int> adj_range_, adj_index_;  // CSR of the dual graph
+  std::vector<Pair> holders_;  // { face, local cell holding it }
+  std::vector<Int> cell_parts_, face_parts_;
+  Numbering node_numbering_, cell_numbering_, face_numbering_;
+
+  explicit ParallelShuffler(MPI_Comm comm)
+      : comm_(comm) {
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+  }
+
+  /**
+   * @brief Split `n` items into `size_` almost equal slabs.
+   */
+  std::vector<Int> Distribute(Int n) const {
+    auto dist = std::vector<Int>(size_ + 1);
+    for (int r = 0; r <= size_; ++r) {
+      dist[r] = n / size_ * r + std::min<Int>(r, n % size_);
+    }
+    return dist;
+  }
+  static int GetOwner(std::vector<Int> const &dist, Int i) {
+    auto iter = std::upper_bound(dist.begin(), dist.end(), i);
+    return iter - dist.begin() - 1;
+  }
+  Int head(std::vector<Int> const &dist) const {
+    return dist[rank_];
+  }
+  Int tail(std::vector<Int> const &dist) const {
+    return dist[rank_ + 1];
+  }
+  int GetZoneOfNode(Int m_node) const {
+    int i_zone = zones_.size();
+    while (zones_[i_zone - 1].node_head > m_node) {
+      --i_zone;
+    }
+    return i_zone;
+  }
+  int GetSectOfItem(std::vector<int> const &sects, Int i_item) const {
+    auto iter = std::upper_bound(sects.begin(), sects.end(), i_item,
+        [this](Int i, int i_sect) { return i < sects_[i_sect].head; });
+    assert(iter != sects.begin());
+    return *(iter - 1);
+  }
+
+  /**
+   * @brief Send `send[r]` to rank `r` and receive `recv[r]` from rank `r`.
+   *
+   * Since `MPI_Alltoallv` takes `int` counts and displacements, the bytes are sent in rounds, in each of which at most `INT_MAX / size_` bytes are sent to each rank.
+   */
+  template <class T>
+  std::vector<std::vector<T>> Exchange(
+      std::vector<std::vector<T>> const &send) const {
+    static_assert(std::is_trivially_copyable_v<T>);
+    auto send_bytes = std::vector<uint64_t>(size_);
+    auto recv_bytes = std::vector<uint64_t>(size_);
+    for (int r = 0; r < size_; ++r) {
+      send_bytes[r] = send[r].size() * sizeof(T);
+    }
+    MPI_Alltoall(send_bytes.data(), 1, MPI_UINT64_T,
+        recv_bytes.data(), 1, MPI_UINT64_T, comm_);
+    auto recv = std::vector<std::vector<T>>(size_);
+    uint64_t max_bytes = 0;
+    for (int r = 0; r < size_; ++r) {
+      recv[r].resize(recv_bytes[r] / sizeof(T));
+      max_bytes = std::max({ max_bytes, send_bytes[r], recv_bytes[r] });
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &max_bytes, 1, MPI_UINT64_T, MPI_MAX, comm_);
+    uint64_t round_bytes = std::numeric_limits<int>::max() / size_;
+    auto send_counts = std::vector<int>(size_);
+    auto recv_counts = std::vector<int>(size_);
+    auto send_displs = std::vector<int>(size_ + 1);
+    auto recv_displs = std::vector<int>(size_ + 1);
+    auto send_buf = std::vector<char>(), recv_buf = std::vector<char>();
+    for (uint64_t offset = 0; offset < max_bytes; offset += round_bytes) {
+      auto get_count = [offset, round_bytes](uint64_t n_bytes) -> int {
+        return n_bytes > offset ? std::min(round_bytes, n_bytes - offset) : 0;
+      };
+      for (int r = 0; r < size_; ++r) {
+        send_counts[r] = get_count(send_bytes[r]);
+        recv_counts[r] = get_count(recv_bytes[r]);
+        send_displs[r + 1] = send_displs[r] + send_counts[r];
+        recv_displs[r + 1] = recv_displs[r] + recv_counts[r];
+      }
+      send_buf.resize(send_displs[size_]);
+      for (int r = 0; r < size_; ++r) {
+        if (send_counts[r]) {
+          std::memcpy(send_buf.data() + send_displs[r],
+              reinterpret_cast<char const *>(send[r].data()) + offset,
+              send_counts[r]);
+        }
+      }
+      recv_buf.resize(recv_displs[size_]);
+      MPI_Alltoallv(send_buf.data(), send_counts.data(), send_displs.data(),
+          MPI_BYTE, recv_buf.data(), recv_counts.data(), recv_displs.data(),
+          MPI_BYTE, comm_);
+      for (int r = 0; r < size_; ++r) {
+        if (recv_counts[r]) {
+          std::memcpy(reinterpret_cast<char *>(recv[r].data()) + offset,
+              recv_buf.data() + recv_displs[r], recv_counts[r]);
+        }
+      }
+    }
+    return recv;
+  }
+
+  /**
+   * @brief Get the corner-node lists of the faces (or edges in 2d) of a cell.
+   */
+  static std::vector<std::vector<int>> const &GetFaces(ElementType type) {
+    static const std::vector<std::vector<int>> tri{
+        {0, 1}, {1, 2}, {2, 0} };
+    static const std::vector<std::vector<int>> quad{
+        {0, 1}, {1, 2}, {2, 3}, {3, 0} };
+    static const std::vector<std::vector<int>> tetra{
+        {0, 2, 1}, {0, 1, 3}, {1, 2, 3}, {2, 0, 3} };
+    static const std::vector<std::vector<int>> pyra{
+        {0, 3, 2, 1}, {0, 1, 4}, {1, 2, 4}, {2, 3, 4}, {3, 0, 4} };
+    static const std::vector<std::vector<int>> penta{
+        {0, 2, 1}, {0, 1, 4, 3}, {1, 2, 5, 4}, {2, 0, 3, 5}, {3, 4, 5} };
+    static const std::vector<std::vector<int>> hexa{
+        {0, 3, 2, 1}, {0, 1, 5, 4}, {1, 2, 6, 5},
+        {2, 3, 7, 6}, {0, 4, 7, 3}, {4, 5, 6, 7} };
+    switch (type) {
+    case CGNS_ENUMV(TRI_3): return tri;
+    case CGNS_ENUMV(QUAD_4): return quad;
+    case CGNS_ENUMV(TETRA_4): return tetra;
+    case CGNS_ENUMV(PYRA_5): return pyra;
+    case CGNS_ENUMV(PENTA_6): return penta;
+    case CGNS_ENUMV(HEXA_8): return hexa;
+    default:
+      throw std::invalid_argument("Unsupported cell type.");
+    }
+    return hexa;
+  }
+  static FaceKey GetFaceKey(Int const *nodes, std::vector<int> const &face,
+      Int source) {
+    auto key = FaceKey();
+    key.nodes.fill(-1);
+    int n = face.size();
+    for (int k = 0; k < n; ++k) {
+      key.nodes[k] = nodes[face[k]];
+    }
+    std::sort(key.nodes.begin(), key.nodes.begin() + n);
+    key.source = source;
+    return key;
+  }
+
+  void ReadMetadata(int i_file);
+  void ReadNodes(int i_file);
+  void ReadElements(int i_file, std::vector<int> const &sects,
+      std::vector<Int> const &dist, std::vector<Int> *nodes,
+      std::vector<int> *sect_of_items);
+  void BuildDualGraph();
+  void PartitionCells();
+  std::vector<std::array<Real, 3>> GetCellCenters() const;
+  static uint64_t GetMortonKey(std::array<Real, 3> const &xyz,
+      std::array<Real, 3> const &min, std::array<Real, 3> const &max);
+  void PartitionCellsAlongCurve();
+  void PartitionNodesAndFaces();
+  Numbering Renumber(std::vector<int> const &groups,
+      std::vector<Int> const &parts, int n_groups) const;
+  void NumberNodesCellsAndFaces();
+  void WriteParts(std::string const &case_name);
+};
+
+template <std::integral Int, std::floating_point Real>
+MPI_Datatype const ParallelShuffler<Int, Real>::kMpiIntType
+    = sizeof(Int) == 8 ? MPI_LONG : MPI_INT;
+
+template <std::integral Int, std::floating_point Real>
+MPI_Datatype const ParallelShuffler<Int, Real>::kMpiRealType
+    = sizeof(Real) == 8 ? MPI_DOUBLE : MPI_FLOAT;
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::ReadMetadata(int i_file) {
+  if (cg_base_read(i_file, kBase, base_name_, &cell_dim_, &phys_dim_)) {
+    cgp_error_exit();
+  }
+  int n_zones;
+  if (cg_nzones(i_file, kBase, &n_zones)) {
+    cgp_error_exit();
+  }
+  Int n_nodes = 0, n_cells = 0, n_faces = 0;
+  for (int i_zone = 1; i_zone <= n_zones; ++i_zone) {
+    auto &zone = zones_.emplace_back();
+    char name[33];
+    cgsize_t zone_size[3];
+    if (cg_zone_read(i_file, kBase, i_zone, name, zone_size)) {
+      cgp_error_exit();
+    }
+    zone.name = name;
+    zone.n_nodes = zone_size[0];
+    zone.n_cells = zone_size[1];
+    zone.node_head = n_nodes;
+    n_nodes += zone.n_nodes;
+    int n_sects;
+    if (cg_nsections(i_file, kBase, i_zone, &n_sects)) {
+      cgp_error_exit();
+    }
+    auto sects = std::vector<Sect>(n_sects);
+    for (int i_sect = 1; i_sect <= n_sects; ++i_sect) {
+      auto &sect = sects[i_sect - 1];
+      cgsize_t first, last;
+      int n_boundary_cells, parent_flag;
+      if (cg_section_read(i_file, kBase, i_zone, i_sect, name, &sect.type,
+          &first, &last, &n_boundary_cells, &parent_flag)) {
+        cgp_error_exit();
+      }
+      if (sect.type == CGNS_ENUMV(MIXED)) {
+        throw std::invalid_argument("MIXED sections are not supported.");
+      }
+      sect.name = name;
+      sect.i_zone = i_zone;
+      sect.i_sect_old = i_sect;
+      sect.first_old = first;
+      sect.n_cells = last - first + 1;
+      sect.dim = cgns::dim(sect.type);
+      sect.npe = cgns::CountNodesByType(sect.type);
+    }
+    // sort sections in the same way as `cgns::Zone::SortSectionsByDim()`
+    std::ranges::stable_sort(sects, [](Sect const &l, Sect const &r) {
+      return l.dim > r.dim;
+    });
+    cgsize_t i_next = 1;
+    for (int i_sect = 1; i_sect <= n_sects; ++i_sect) {
+      auto &sect = sects[i_sect - 1];
+      sect.i_sect = i_sect;
+      sect.first = i_next;
+      i_next += sect.n_cells;
+      if (sect.dim == cell_dim_) {
+        sect.head = n_cells;
+        n_cells += sect.n_cells;
+        cell_sects_.emplace_back(sects_.size());
+      } else if (sect.dim + 1 == cell_dim_) {
+        sect.head = n_faces;
+        n_faces += sect.n_cells;
+        face_sects_.emplace_back(sects_.size());
+      }
+      if (sect.head >= 0 && sect.npe > kMaxNpe) {
+        throw std::invalid_argument("Unsupported element type.");
+      }
+      zone.sects.emplace_back(sects_.size());
+      sects_.emplace_back(sect);
+    }
+    // read BCs in the same way as `cgns::ZoneBC::Read()`
+    int n_bocos;
+    if (cg_nbocos(i_file, kBase, i_zone, &n_bocos)) {
+      cgp_error_exit();
+    }
+    zone.bocos.resize(n_bocos);
+    for (int i_boco = 1; i_boco <= n_bocos; ++i_boco) {
+      auto &boco = zone.bocos[i_boco - 1];
+      cg_boco_info(i_file, kBase, i_zone, i_boco,
+          boco.name, &boco.type, &boco.ptset_type, &boco.n_pnts,
+          &boco.normal_index, &boco.normal_list_size,
+          &boco.normal_data_type, &boco.n_mesh);
+      assert(boco.n_pnts == 2);
+      cg_boco_read(i_file, kBase, i_zone, i_boco, boco.ptset, nullptr);
+      cg_goto(i_file, kBase, "Zone_t", i_zone,
+          "ZoneBC_t", 1, "BC_t", i_boco, "end");
+      cg_gridlocation_read(&boco.location);
+      if (boco.type == CGNS_ENUMV(FamilySpecified)) {
+        cg_famname_read(boco.family);
+      } else {
+        boco.family[0] = '\0';
+      }
+    }
+  }
+  // read families in the same way as `cgns::Base::ReadFamilies()`
+  int n_families;
+  if (cg_nfamilies(i_file, kBase, &n_families)) {
+    cgp_error_exit();
+  }
+  families_.resize(n_families);
+  for (int i_family = 1; i_family <= n_families; ++i_family) {
+    auto &family = families_[i_family - 1];
+    int n_boco, n_geom, n_child;
+    cg_family_read(i_file, kBase, i_family, family.name, &n_boco, &n_geom);
+    cg_nfamily_names(i_file, kBase, i_family, &n_child);
+    if (n_child > 1) {
+      throw std::runtime_error("Currently, each Family_t object can have at most one FamilyName_t child.");
+    }
+    char child_family_name[33];
+    family.child[0] = '\0';
+    if (n_child == 1) {
+      cg_family_name_read(i_file, kBase, i_family, 1,
+          family.child, child_family_name);
+    }
+  }
+  if (n_cells < size_) {
+    throw std::invalid_argument("Too many ranks for too few cells.");
+  }
+  node_dist_ = Distribute(n_nodes);
+  cell_dist_ = Distribute(n_cells);
+  face_dist_ = Distribute(n_faces);
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::ReadNodes(int i_file) {
+  Int n_local = tail(node_dist_) - head(node_dist_);
+  x_.resize(n_local);
+  y_.resize(n_local);
+  z_.resize(n_local);
+  for (auto &zone : zones_) {
+    int i_zone = &zone - zones_.data() + 1;
+    Int m_head = std::max(head(node_dist_), zone.node_head);
+    Int m_tail = std::min(tail(node_dist_), zone.node_head + zone.n_nodes);
+    // every rank joins the collective read, even if it reads nothing
+    cgsize_t range_min[] = { 1 }, range_max[] = { 1 };
+    Real *xyz[] = { nullptr, nullptr, nullptr };
+    if (m_head < m_tail) {
+      range_min[0] = m_head - zone.node_head + 1;
+      range_max[0] = m_tail - zone.node_head;
+      Int offset = m_head - head(node_dist_);
+      xyz[0] = x_.data() + offset;
+      xyz[1] = y_.data() + offset;
+      xyz[2] = z_.data() + offset;
+    }
+    for (int i_coord = 1; i_coord <= 3; ++i_coord) {
+      if (cgp_coord_read_data(i_file, kBase, i_zone, i_coord,
+          range_min, range_max, xyz[i_coord - 1])) {
+        cgp_error_exit();
+      }
+    }
+  }
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::ReadElements(int i_file,
+    std::vector<int> const &sects, std::vector<Int> const &dist,
+    std::vector<Int> *nodes, std::vector<int> *sect_of_items) {
+  Int n_local = tail(dist) - head(dist);
+  nodes->assign(n_local * kMaxNpe, -1);
+  sect_of_items->resize(n_local);
+  for (int i_sect : sects) {
+    auto &sect = sects_[i_sect];
+    auto &zone = zones_[sect.i_zone - 1];
+    Int m_head = std::max(head(dist), sect.head);
+    Int m_tail = std::min(tail(dist), sect.head + sect.n_cells);
+    // every rank joins the collective read, even if it reads nothing
+    cgsize_t first = sect.first_old, last = sect.first_old;
+    auto buffer = std::vector<cgsize_t>();
+    if (m_head < m_tail) {
+      first = sect.first_old + (m_head - sect.head);
+      last = sect.first_old + (m_tail - sect.head) - 1;
+      buffer.resize((m_tail - m_head) * sect.npe);
+    }
+    if (cgp_elements_read_data(i_file, kBase, sect.i_zone, sect.i_sect_old,
+        first, last, m_head < m_tail ? buffer.data() : nullptr)) {
+      cgp_error_exit();
+    }
+    for (Int m = m_head; m < m_tail; ++m) {
+      Int i_local = m - head(dist);
+      (*sect_of_items)[i_local] = i_sect;
+      auto *i_node_list = &buffer[(m - m_head) * sect.npe];
+      for (int k = 0; k < sect.npe; ++k) {
+        (*nodes)[i_local * kMaxNpe + k] = zone.node_head + i_node_list[k] - 1;
+      }
+    }
+  }
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::BuildDualGraph() {
+  // send each face to the owner of its smallest node
+  auto send_keys = std::vector<std::vector<FaceKey>>(size_);
+  for (Int i_local = 0; i_local < cell_sect_.size(); ++i_local) {
+    auto *nodes = &cell_nodes_[i_local * kMaxNpe];
+    Int m_cell = head(cell_dist_) + i_local;
+    for (auto &face : GetFaces(sects_[cell_sect_[i_local]].type)) {
+      auto key = GetFaceKey(nodes, face, m_cell);
+      send_keys[GetOwner(node_dist_, key.nodes[0])].emplace_back(key);
+    }
+  }
+  auto face_corners = std::vector<int>{ 0, 1, 2, 3 };
+  for (Int i_local = 0; i_local < face_sect_.size(); ++i_local) {
+    auto *nodes = &face_nodes_[i_local * kMaxNpe];
+    Int i_face = head(face_dist_) + i_local;
+    face_corners.resize(sects_[face_sect_[i_local]].npe);
+    auto key = GetFaceKey(nodes, face_corners, -1 - i_face);
+    send_keys[GetOwner(node_dist_, key.nodes[0])].emplace_back(key);
+  }
+  auto recv_keys = Exchange(send_keys);
+  send_keys.clear();
+  auto keys = std::vector<FaceKey>();
+  for (auto &recv : recv_keys) {
+    keys.insert(keys.end(), recv.begin(), recv.end());
+  }
+  recv_keys.clear();
+  // keys of the same face are adjacent after sorting, cells first
+  std::ranges::sort(keys, [](FaceKey const &l, FaceKey const &r) {
+    return l.nodes < r.nodes || (l.nodes == r.nodes && l.source > r.source);
+  });
+  auto send_edges = std::vector<std::vector<Pair>>(size_);
+  auto send_holders = std::vector<std::vector<Pair>>(size_);
+  for (std::size_t i_head = 0, i_tail; i_head < keys.size(); i_head = i_tail) {
+    i_tail = i_head + 1;
+    while (i_tail < keys.size() && keys[i_tail].nodes == keys[i_head].nodes) {
+      ++i_tail;
+    }
+    auto i_face = i_head;
+    while (i_face < i_tail && keys[i_face].source >= 0) {
+      ++i_face;
+    }
+    int n_cells = i_face - i_head;
+    if (n_cells == 2) {
+      Int i = keys[i_head].source, j = keys[i_head + 1].source;
+      send_edges[GetOwner(cell_dist_, i)].emplace_back(i, j);
+      send_edges[GetOwner(cell_dist_, j)].emplace_back(j, i);
+    } else if (n_cells > 2) {
+      throw std::runtime_error("A face is shared by more than two cells.");
+    }
+    for (; i_face < i_tail; ++i_face) {
+      if (n_cells == 0) {
+        throw std::runtime_error("A face is not held by any cell.");
+      }
+      // the face goes with the cell having the largest id
+      Int m_cell = keys[i_head].source;
+      send_holders[GetOwner(cell_dist_, m_cell)].emplace_back(
+          -1 - keys[i_face].source, m_cell);
+    }
+  }
+  keys.clear();
+  // build the CSR representation of the local part of the dual graph
+  auto edges = std::vector<Pair>();
+  for (auto &recv : Exchange(send_edges)) {
+    edges.insert(edges.end(), recv.begin(), recv.end());
+  }
+  std::ranges::sort(edges, [](Pair const &l, Pair const &r) {
+    return l.first < r.first || (l.first == r.first && l.second < r.second);
+  });
+  Int n_local = tail(cell_dist_) - head(cell_dist_);
+  adj_range_.assign(n_local + 1, 0);
+  adj_index_.clear();
+  adj_index_.reserve(edges.size());
+  for (auto [i, j] : edges) {
+    ++adj_range_[i - head(cell_dist_) + 1];
+    adj_index_.emplace_back(j);
+  }
+  for (Int i_local = 0; i_local < n_local; ++i_local) {
+    adj_range_[i_local + 1] += adj_range_[i_local];
+  }
+  holders_.clear();
+  for (auto &recv : Exchange(send_holders)) {
+    for (auto [i_face, m_cell] : recv) {
+      holders_.emplace_back(i_face, m_cell - head(cell_dist_));
+    }
+  }
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::PartitionCells() {
+  Int n_local = tail(cell_dist_) - head(cell_dist_);
+  cell_parts_.assign(n_local, 0);
+  if (size_ == 1) {
+    return;
+  }
+#ifdef ENABLE_PARMETIS
+  static_assert(sizeof(Int) == sizeof(idx_t),
+      "`Int` and `idx_t` must have the same size.");
+  idx_t weight_flag = 0, numbering_flag = 0, n_constraints = 1;
+  idx_t n_parts = size_, n_cut_edges;
+  auto weight_of_each_part = std::vector<real_t>(n_parts, 1.0 / n_parts);
+  real_t unbalance = 1.05;
+  idx_t options[] = { 0, 0, 0 };
+  auto error_code = ParMETIS_V3_PartKway(cell_dist_.data(), adj_range_.data(),
+      adj_index_.data(), nullptr, nullptr, &weight_flag, &numbering_flag,
+      &n_constraints, &n_parts, weight_of_each_part.data(), &unbalance,
+      options, &n_cut_edges, cell_parts_.data(), &comm_);
+  if (error_code != METIS_OK) {
+    throw std::runtime_error("ParMETIS_V3_PartKway() failed.");
+  }
+#else
+  PartitionCellsAlongCurve();
+#endif
+}
+
+template <std::integral Int, std::floating_point Real>
+std::vector<std::array<Real, 3>>
+ParallelShuffler<Int, Real>::GetCellCenters() const {
+  // query the coordinates of the nodes used by local cells
+  auto send_queries = std::vector<std::vector<Int>>(size_);
+  for (Int m_node : cell_nodes_) {
+    if (m_node >= 0) {
+      send_queries[GetOwner(node_dist_, m_node)].emplace_back(m_node);
+    }
+  }
+  for (auto &queries : send_queries) {
+    std::ranges::sort(queries);
+    queries.erase(std::unique(queries.begin(), queries.end()), queries.end());
+  }
+  auto recv_queries = Exchange(send_queries);
+  auto send_answers = std::vector<std::vector<Node>>(size_);
+  for (int r = 0; r < size_; ++r) {
+    for (Int m_node : recv_queries[r]) {
+      auto i_local = m_node - head(node_dist_);
+      auto &node = send_answers[r].emplace_back();
+      node.metis = m_node;
+      node.xyz[0] = x_[i_local];
+      node.xyz[1] = y_[i_local];
+      node.xyz[2] = z_[i_local];
+    }
+  }
+  auto m_node_to_xyz = std::unordered_map<Int, std::array<Real, 3>>();
+  for (auto &recv : Exchange(send_answers)) {
+    for (auto &node : recv) {
+      m_node_to_xyz[node.metis] = { node.xyz[0], node.xyz[1], node.xyz[2] };
+    }
+  }
+  // average the nodes of each cell
+  auto centers = std::vector<std::array<Real, 3>>(cell_sect_.size());
+  for (Int i_local = 0; i_local < cell_sect_.size(); ++i_local) {
+    auto &center = centers[i_local];
+    center.fill(0);
+    int npe = sects_[cell_sect_[i_local]].npe;
+    for (int k = 0; k < npe; ++k) {
+      auto &xyz = m_node_to_xyz.at(cell_nodes_[i_local * kMaxNpe + k]);
+      for (int d = 0; d < 3; ++d) {
+        center[d] += xyz[d] / npe;
+      }
+    }
+  }
+  return centers;
+}
+
+template <std::integral Int, std::floating_point Real>
+uint64_t ParallelShuffler<Int, Real>::GetMortonKey(
+    std::array<Real, 3> const &xyz, std::array<Real, 3> const &min,
+    std::array<Real, 3> const &max) {
+  constexpr int kBits = 21;
+  constexpr uint64_t kMaxIndex = (uint64_t(1) << kBits) - 1;
+  std::array<uint64_t, 3> ijk;
+  for (int d = 0; d < 3; ++d) {
+    auto extent = max[d] - min[d];
+    ijk[d] = extent > 0 ? (xyz[d] - min[d]) / extent * kMaxIndex : 0;
+  }
+  uint64_t key = 0;
+  for (int b = kBits - 1; b >= 0; --b) {
+    for (int d = 0; d < 3; ++d) {
+      key = (key << 1) | ((ijk[d] >> b) & 1);
+    }
+  }
+  return key;
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::PartitionCellsAlongCurve() {
+  auto centers = GetCellCenters();
+  std::array<Real, 3> min, max;
+  min.fill(std::numeric_limits<Real>::max());
+  max.fill(std::numeric_limits<Real>::lowest());
+  for (auto &center : centers) {
+    for (int d = 0; d < 3; ++d) {
+      min[d] = std::min(min[d], center[d]);
+      max[d] = std::max(max[d], center[d]);
+    }
+  }
+  MPI_Allreduce(MPI_IN_PLACE, min.data(), 3, kMpiRealType, MPI_MIN, comm_);
+  MPI_Allreduce(MPI_IN_PLACE, max.data(), 3, kMpiRealType, MPI_MAX, comm_);
+  // sort the cells along the curve by sample sort
+  auto less = [](CurvePoint const &l, CurvePoint const &r) {
+    return l.key < r.key || (l.key == r.key && l.m_cell < r.m_cell);
+  };
+  Int n_local = cell_sect_.size();
+  auto items = std::vector<CurvePoint>(n_local);
+  for (Int i_local = 0; i_local < n_local; ++i_local) {
+    items[i_local].key = GetMortonKey(centers[i_local], min, max);
+    items[i_local].m_cell = head(cell_dist_) + i_local;
+  }
+  std::ranges::sort(items, less);
+  int n_samples = std::min(size_, 64);
+  auto samples = std::vector<CurvePoint>(n_samples);
+  for (int i = 0; i < n_samples; ++i) {
+    samples[i] = items[i * n_local / n_samples];
+  }
+  auto all_samples = std::vector<CurvePoint>(n_samples * size_);
+  MPI_Allgather(samples.data(), sizeof(CurvePoint) * n_samples, MPI_BYTE,
+      all_samples.data(), sizeof(CurvePoint) * n_samples, MPI_BYTE, comm_);
+  std::ranges::sort(all_samples, less);
+  auto splitters = std::vector<CurvePoint>(size_ - 1);
+  for (int r = 1; r < size_; ++r) {
+    splitters[r - 1] = all_samples[r * all_samples.size() / size_];
+  }
+  auto send_items = std::vector<std::vector<CurvePoint>>(size_);
+  for (auto &item : items) {
+    auto iter = std::upper_bound(splitters.begin(), splitters.end(), item,
+        less);
+    send_items[iter - splitters.begin()].emplace_back(item);
+  }
+  items.clear();
+  for (auto &recv : Exchange(send_items)) {
+    items.insert(items.end(), recv.begin(), recv.end());
+  }
+  std::ranges::sort(items, less);
+  // cut the sorted cells into parts of almost equal sizes
+  Int n_items = items.size(), offset = 0, n_cells = cell_dist_.back();
+  MPI_Exscan(&n_items, &offset, 1, kMpiIntType, MPI_SUM, comm_);
+  if (rank_ == 0) {
+    offset = 0;
+  }
+  auto send_parts = std::vector<std::vector<Pair>>(size_);
+  for (Int i = 0; i < n_items; ++i) {
+    Int m_cell = items[i].m_cell;
+    Int part = int64_t(offset + i) * size_ / n_cells;
+    send_parts[GetOwner(cell_dist_, m_cell)].emplace_back(m_cell, part);
+  }
+  for (auto &recv : Exchange(send_parts)) {
+    for (auto [m_cell, part] : recv) {
+      cell_parts_[m_cell - head(cell_dist_)] = part;
+    }
+  }
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::PartitionNodesAndFaces() {
+  // a node belongs to the min-id part among its user cells
+  auto node_to_part = std::unordered_map<Int, Int>();
+  for (Int i_local = 0; i_local < cell_parts_.size(); ++i_local) {
+    auto part = cell_parts_[i_local];
+    for (int k = 0; k < kMaxNpe; ++k) {
+      auto m_node = cell_nodes_[i_local * kMaxNpe + k];
+      if (m_node < 0) {
+        break;
+      }
+      auto [iter, inserted] = node_to_part.emplace(m_node, part);
+      if (!inserted) {
+        iter->second = std::min(iter->second, part);
+      }
+    }
+  }
+  auto send_nodes = std::vector<std::vector<Pair>>(size_);
+  for (auto [m_node, part] : node_to_part) {
+    send_nodes[GetOwner(node_dist_, m_node)].emplace_back(m_node, part);
+  }
+  node_to_part.clear();
+  // nodes not used by any cell are put into the last part
+  node_parts_.assign(tail(node_dist_) - head(node_dist_), size_ - 1);
+  for (auto &recv : Exchange(send_nodes)) {
+    for (auto [m_node, part] : recv) {
+      auto &node_part = node_parts_[m_node - head(node_dist_)];
+      node_part = std::min(node_part, part);
+    }
+  }
+  // a face belongs to the part of its holder
+  auto send_faces = std::vector<std::vector<Pair>>(size_);
+  for (auto [i_face, i_local] : holders_) {
+    send_faces[GetOwner(face_dist_, i_face)].emplace_back(
+        i_face, cell_parts_[i_local]);
+  }
+  face_parts_.assign(tail(face_dist_) - head(face_dist_), -1);
+  for (auto &recv : Exchange(send_faces)) {
+    for (auto [i_face, part] : recv) {
+      face_parts_[i_face - head(face_dist_)] = part;
+    }
+  }
+  assert(std::ranges::none_of(face_parts_, [](Int p) { return p < 0; }));
+}
+
+template <std::integral Int, std::floating_point Real>
+typename ParallelShuffler<Int, Real>::Numbering
+ParallelShuffler<Int, Real>::Renumber(std::vector<int> const &groups,
+    std::vector<Int> const &parts, int n_groups) const {
+  // items are sorted by (part, old id) in each group, and the items on lower ranks have lower old ids
+  auto n_pairs = n_groups * size_;
+  auto counts = std::vector<Int>(n_pairs);
+  for (Int i_local = 0; i_local < parts.size(); ++i_local) {
+    ++counts[groups[i_local] * size_ + parts[i_local]];
+  }
+  auto offsets = std::vector<Int>(n_pairs);
+  auto totals = std::vector<Int>(n_pairs);
+  MPI_Exscan(counts.data(), offsets.data(), n_pairs, kMpiIntType, MPI_SUM,
+      comm_);
+  if (rank_ == 0) {
+    std::ranges::fill(offsets, 0);
+  }
+  MPI_Allreduce(counts.data(), totals.data(), n_pairs, kMpiIntType, MPI_SUM,
+      comm_);
+  auto numbering = Numbering();
+  numbering.ranges.resize(n_pairs);
+  for (int i_group = 0; i_group < n_groups; ++i_group) {
+    Int i_next = 0;
+    for (int i_part = 0; i_part < size_; ++i_part) {
+      auto i_pair = i_group * size_ + i_part;
+      numbering.ranges[i_pair] = { i_next, i_next + totals[i_pair] };
+      offsets[i_pair] += i_next;
+      i_next += totals[i_pair];
+    }
+  }
+  numbering.new_ids.resize(parts.size());
+  for (Int i_local = 0; i_local < parts.size(); ++i_local) {
+    numbering.new_ids[i_local]
+        = offsets[groups[i_local] * size_ + parts[i_local]]++;
+  }
+  return numbering;
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::NumberNodesCellsAndFaces() {
+  auto node_zones = std::vector<int>(node_parts_.size());
+  for (Int i_local = 0; i_local < node_parts_.size(); ++i_local) {
+    node_zones[i_local] = GetZoneOfNode(head(node_dist_) + i_local) - 1;
+  }
+  node_numbering_ = Renumber(node_zones, node_parts_, zones_.size());
+  // sections are numbered by their positions in `sects_`
+  cell_numbering_ = Renumber(cell_sect_, cell_parts_, sects_.size());
+  face_numbering_ = Renumber(face_sect_, face_parts_, sects_.size());
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::WriteParts(std::string const &case_name) {
+  /* Query the parts of adjacent cells: */
+  auto send_queries = std::vector<std::vector<Int>>(size_);
+  for (Int j : adj_index_) {
+    send_queries[GetOwner(cell_dist_, j)].emplace_back(j);
+  }
+  for (auto &queries : send_queries) {
+    std::ranges::sort(queries);
+    queries.erase(std::unique(queries.begin(), queries.end()), queries.end());
+  }
+  auto recv_queries = Exchange(send_queries);
+  auto send_answers = std::vector<std::vector<Pair>>(size_);
+  for (int r = 0; r < size_; ++r) {
+    for (Int j : recv_queries[r]) {
+      send_answers[r].emplace_back(j, cell_parts_[j - head(cell_dist_)]);
+    }
+  }
+  auto m_cell_to_part = std::unordered_map<Int, Int>();
+  for (auto &recv : Exchange(send_answers)) {
+    for (auto [j, part] : recv) {
+      m_cell_to_part.emplace(j, part);
+    }
+  }
+  /* Send cells, faces, adjacency and nodes to their parts: */
+  auto send_elements = std::vector<std::vector<Element>>(size_);
+  auto send_adjs = std::vector<std::vector<Adjacency>>(size_);
+  for (Int i_local = 0; i_local < cell_parts_.size(); ++i_local) {
+    auto element = Element();
+    element.metis = head(cell_dist_) + i_local;
+    element.i_sect = cell_sect_[i_local];
+    element.new_id = cell_numbering_.new_ids[i_local];
+    element.ghost = false;
+    std::copy_n(&cell_nodes_[i_local * kMaxNpe], kMaxNpe,
+        element.nodes.begin());
+    auto part = cell_parts_[i_local];
+    send_elements[part].emplace_back(element);
+    element.ghost = true;
+    auto ghost_parts = std::set<Int>();
+    for (Int r = adj_range_[i_local]; r < adj_range_[i_local + 1]; ++r) {
+      auto j = adj_index_[r];
+      auto part_j = m_cell_to_part.at(j);
+      send_adjs[part].emplace_back(element.metis, j, part_j);
+      if (part_j != part && ghost_parts.emplace(part_j).second) {
+        send_elements[part_j].emplace_back(element);
+      }
+    }
+  }
+  m_cell_to_part.clear();
+  auto send_faces = std::vector<std::vector<Element>>(size_);
+  for (Int i_local = 0; i_local < face_parts_.size(); ++i_local) {
+    auto element = Element();
+    element.metis = head(face_dist_) + i_local;
+    element.i_sect = face_sect_[i_local];
+    element.new_id = face_numbering_.new_ids[i_local];
+    element.ghost = false;
+    std::copy_n(&face_nodes_[i_local * kMaxNpe], kMaxNpe,
+        element.nodes.begin());
+    send_faces[face_parts_[i_local]].emplace_back(element);
+  }
+  auto send_nodes = std::vector<std::vector<Node>>(size_);
+  for (Int i_local = 0; i_local < node_parts_.size(); ++i_local) {
+    auto node = Node();
+    node.metis = head(node_dist_) + i_local;
+    node.i_zone = GetZoneOfNode(node.metis);
+    node.new_id = node_numbering_.new_ids[i_local] + 1;
+    node.xyz[0] = x_[i_local];
+    node.xyz[1] = y_[i_local];
+    node.xyz[2] = z_[i_local];
+    send_nodes[node_parts_[i_local]].emplace_back(node);
+  }
+  auto elements = std::vector<Element>();
+  for (auto &recv : Exchange(send_elements)) {
+    elements.insert(elements.end(), recv.begin(), recv.end());
+  }
+  auto adjs = std::vector<Adjacency>();
+  for (auto &recv : Exchange(send_adjs)) {
+    adjs.insert(adjs.end(), recv.begin(), recv.end());
+  }
+  auto faces = std::vector<Element>();
+  for (auto &recv : Exchange(send_faces)) {
+    faces.insert(faces.end(), recv.begin(), recv.end());
+  }
+  auto nodes = std::vector<Node>();
+  for (auto &recv : Exchange(send_nodes)) {
+    nodes.insert(nodes.end(), recv.begin(), recv.end());
+  }
+  /* Query the parts and new ids of used nodes: */
+  for (auto &queries : send_queries) {
+    queries.clear();
+  }
+  for (auto &element : elements) {
+    for (auto m_node : element.nodes) {
+      if (m_node >= 0) {
+        send_queries[GetOwner(node_dist_, m_node)].emplace_back(m_node);
+      }
+    }
+  }
+  for (auto &queries : send_queries) {
+    std::ranges::sort(queries);
+    queries.erase(std::unique(queries.begin(), queries.end()), queries.end());
+  }
+  recv_queries = Exchange(send_queries);
+  for (int r = 0; r < size_; ++r) {
+    send_answers[r].clear();
+    for (Int m_node : recv_queries[r]) {
+      auto i_local = m_node - head(node_dist_);
+      send_answers[r].emplace_back(m_node, node_parts_[i_local]);
+      send_answers[r].emplace_back(node_numbering_.new_ids[i_local] + 1, 0);
+    }
+  }
+  // [m_node] -> { part, new_id }
+  auto m_node_to_info = std::unordered_map<Int, Pair>();
+  for (auto &recv : Exchange(send_answers)) {
+    for (std::size_t i = 0; i < recv.size(); i += 2) {
+      m_node_to_info.emplace(recv[i].first,
+          Pair{ recv[i].second, recv[i + 1].first });
+    }
+  }
+  /* Find the nodes shared with other parts: */
+  // [i_part] -> metis ids of nodes owned by `i_part` but used here
+  auto part_adj_nodes = std::map<Int, std::set<Int>>();
+  // [m_cell] -> npe
+  auto m_cell_to_npe = std::unordered_map<Int, int>();
+  for (auto &element : elements) {
+    m_cell_to_npe.emplace(element.metis, sects_[element.i_sect].npe);
+    for (auto m_node : element.nodes) {
+      if (m_node < 0) {
+        break;
+      }
+      auto node_part = m_node_to_info.at(m_node).first;
+      if (node_part != rank_) {
+        part_adj_nodes[node_part].emplace(m_node);
+      }
+    }
+  }
+  auto send_adj_nodes = std::vector<std::vector<Int>>(size_);
+  for (auto &[i_part, m_nodes] : part_adj_nodes) {
+    send_adj_nodes[i_part].assign(m_nodes.begin(), m_nodes.end());
+  }
+  auto recv_adj_nodes = Exchange(send_adj_nodes);
+  send_adj_nodes.clear();
+  /* Write the shuffled mesh by all ranks: */
+  auto new_cgns_name = case_name + "/shuffled.cgns";
+  int i_file, i_base;
+  if (cgp_open(new_cgns_name.c_str(), CG_MODE_WRITE, &i_file) ||
+      cg_base_write(i_file, base_name_, cell_dim_, phys_dim_, &i_base)) {
+    cgp_error_exit();
+  }
+  assert(i_base == kBase);
+  auto zone_to_nodes = std::vector<std::vector<Node const *>>(zones_.size());
+  for (auto &node : nodes) {
+    zone_to_nodes[node.i_zone - 1].emplace_back(&node);
+  }
+  auto sect_to_elements = std::vector<std::vector<Element const *>>(
+      sects_.size());
+  for (auto &element : elements) {
+    if (!element.ghost) {
+      sect_to_elements[element.i_sect].emplace_back(&element);
+    }
+  }
+  for (auto &face : faces) {
+    sect_to_elements[face.i_sect].emplace_back(&face);
+  }
+  for (int i_zone = 1; i_zone <= zones_.size(); ++i_zone) {
+    auto &zone = zones_[i_zone - 1];
+    int i_zone_new;
+    cgsize_t zone_size[3] = { zone.n_nodes, zone.n_cells, 0 };
+    if (cg_zone_write(i_file, kBase, zone.name.c_str(), zone_size,
+        CGNS_ENUMV(Unstructured), &i_zone_new)) {
+      cgp_error_exit();
+    }
+    assert(i_zone_new == i_zone);
+    // every rank joins each collective write, even if it writes nothing
+    auto [node_head, node_tail]
+        = node_numbering_.ranges[(i_zone - 1) * size_ + rank_];
+    auto n_nodes = node_tail - node_head;
+    cgsize_t range_min[] = { n_nodes ? node_head + 1 : 1 };
+    cgsize_t range_max[] = { n_nodes ? node_tail : 1 };
+    auto coords = std::vector<std::vector<Real>>(3, std::vector<Real>(n_nodes));
+    auto node_fields = std::vector<std::vector<Real>>(2,
+        std::vector<Real>(n_nodes));
+    for (auto *node : zone_to_nodes[i_zone - 1]) {
+      auto i = node->new_id - 1 - node_head;
+      for (int d = 0; d < 3; ++d) {
+        coords[d][i] = node->xyz[d];
+      }
+      node_fields[0][i] = rank_;
+      node_fields[1][i] = node->metis;
+    }
+    char const *coord_names[] = { "CoordinateX", "CoordinateY", "CoordinateZ" };
+    for (int d = 0; d < 3; ++d) {
+      int i_coord;
+      if (cgp_coord_write(i_file, kBase, i_zone, kRealType, coord_names[d],
+          &i_coord) || cgp_coord_write_data(i_file, kBase, i_zone, i_coord,
+          range_min, range_max, n_nodes ? coords[d].data() : nullptr)) {
+        cgp_error_exit();
+      }
+    }
+    // write BCs in the same way as `cgns::ZoneBC::Write()`
+    for (int i_boco = 1; i_boco <= zone.bocos.size(); ++i_boco) {
+      auto boco = zone.bocos[i_boco - 1];
+      for (int i_sect : zone.sects) {
+        if (sects_[i_sect].name == boco.name) {
+          boco.ptset[0] = sects_[i_sect].first;
+          boco.ptset[1] = sects_[i_sect].first + sects_[i_sect].n_cells - 1;
+        }
+      }
+      int i_boco_new;
+      cg_boco_write(i_file, kBase, i_zone, boco.name, boco.type,
+          boco.ptset_type, boco.n_pnts, boco.ptset, &i_boco_new);
+      assert(i_boco_new == i_boco);
+      cg_goto(i_file, kBase, "Zone_t", i_zone,
+          "ZoneBC_t", 1, "BC_t", i_boco, "end");
+      cg_boco_gridlocation_write(i_file, kBase, i_zone, i_boco,
+          boco.location);
+      if (boco.type == CGNS_ENUMV(FamilySpecified)) {
+        cg_famname_write(boco.family);
+      }
+    }
+    // write cells and faces with new node ids
+    auto cell_fields = std::vector<std::vector<Real>>(2);
+    auto cell_ranges = std::vector<Pair>();
+    for (int i_sect : zone.sects) {
+      auto &sect = sects_[i_sect];
+      if (sect.head < 0) {
+        continue;
+      }
+      auto const &numbering = sect.dim == cell_dim_
+          ? cell_numbering_ : face_numbering_;
+      auto [head, tail] = numbering.ranges[i_sect * size_ + rank_];
+      auto n_cells = tail - head;
+      auto i_node_list = std::vector<cgsize_t>(n_cells * sect.npe);
+      auto metis_ids = std::vector<Real>(n_cells);
+      for (auto *element : sect_to_elements[i_sect]) {
+        auto i = element->new_id - head;
+        for (int k = 0; k < sect.npe; ++k) {
+          i_node_list[i * sect.npe + k]
+              = m_node_to_info.at(element->nodes[k]).second;
+        }
+        metis_ids[i] = element->metis;
+      }
+      int i_sect_new;
+      cgsize_t first = n_cells ? sect.first + head : sect.first;
+      cgsize_t last = n_cells ? sect.first + tail - 1 : sect.first;
+      if (cgp_section_write(i_file, kBase, i_zone, sect.name.c_str(),
+          sect.type, sect.first, sect.first + sect.n_cells - 1, 0,
+          &i_sect_new) || cgp_elements_write_data(i_file, kBase, i_zone,
+          i_sect_new, first, last, n_cells ? i_node_list.data() : nullptr)) {
+        cgp_error_exit();
+      }
+      assert(i_sect_new == sect.i_sect);
+      if (sect.dim == cell_dim_) {
+        cell_ranges.emplace_back(first, last);
+        cell_fields[0].emplace_back(n_cells);
+        cell_fields[1].insert(cell_fields[1].end(),
+            metis_ids.begin(), metis_ids.end());
+      }
+    }
+    // write `PartIndex` and `MetisIndex` in the same way as `mapper::CgnsToMetis::WriteParts()`
+    char const *field_names[] = { "PartIndex", "MetisIndex" };
+    int i_soln;
+    if (cg_sol_write(i_file, kBase, i_zone, "DataOnNodes",
+        CGNS_ENUMV(Vertex), &i_soln)) {
+      cgp_error_exit();
+    }
+    for (int i = 0; i < 2; ++i) {
+      int i_field;
+      if (cgp_field_write(i_file, kBase, i_zone, i_soln, kRealType,
+          field_names[i], &i_field) || cgp_field_write_data(i_file, kBase,
+          i_zone, i_soln, i_field, range_min, range_max,
+          n_nodes ? node_fields[i].data() : nullptr)) {
+        cgp_error_exit();
+      }
+    }
+    if (cg_sol_write(i_file, kBase, i_zone, "DataOnCells",
+        CGNS_ENUMV(CellCenter), &i_soln)) {
+      cgp_error_exit();
+    }
+    auto n_cells_sum = cell_fields[1].size();
+    auto part_ids = std::vector<Real>(n_cells_sum, rank_);
+    for (int i = 0; i < 2; ++i) {
+      int i_field;
+      if (cgp_field_write(i_file, kBase, i_zone, i_soln, kRealType,
+          field_names[i], &i_field)) {
+        cgp_error_exit();
+      }
+      auto *data = i ? cell_fields[1].data() : part_ids.data();
+      for (int k = 0; k < cell_ranges.size(); ++k) {
+        auto [first, last] = cell_ranges[k];
+        Int n_cells = cell_fields[0][k];
+        cgsize_t cell_min[] = { first }, cell_max[] = { last };
+        if (cgp_field_write_data(i_file, kBase, i_zone, i_soln, i_field,
+            cell_min, cell_max, n_cells ? data : nullptr)) {
+          cgp_error_exit();
+        }
+        data += n_cells;
+      }
+    }
+  }
+  // write families in the same way as `cgns::Family::Write()`
+  for (int i_family = 1; i_family <= families_.size(); ++i_family) {
+    auto &family = families_[i_family - 1];
+    int i_family_new;
+    cg_family_write(i_file, kBase, family.name, &i_family_new);
+    char const *child_name = family.child[0] ? family.child : family.name;
+    cg_family_name_write(i_file, kBase, i_family_new, child_name,
+        family.name);
+  }
+  if (cgp_close(i_file)) {
+    cgp_error_exit();
+  }
+  /* Write the part info in the same way as `Shuffler::WritePartitionInfo()`: */
+  using partition::Table;
+  auto info = partition::Info();
+  // ranges are written even if empty, and empty ones are written as `0 0`
+  auto get_range = [](Pair range, Int first) -> Pair {
+    auto [head, tail] = range;
+    return head < tail ? Pair{ first + head, first + tail } : Pair{ 0, 0 };
+  };
+  // node ranges
+  for (int z = 1; z <= zones_.size(); ++z) {
+    auto [head, tail] = get_range(
+        node_numbering_.ranges[(z - 1) * size_ + rank_], 1);
+    info.Append(Table::kNodeRanges, { z, head, tail });
+  }
+  // send nodes info
+  for (int i_part = 0; i_part < size_; ++i_part) {
+    auto &m_nodes = recv_adj_nodes[i_part];
+    assert(std::ranges::is_sorted(m_nodes));
+    for (auto m_node : m_nodes) {
+      info.Append(Table::kSendNodes, { i_part, m_node });
+    }
+  }
+  // adjacent nodes
+  for (auto &[i_part, m_nodes] : part_adj_nodes) {
+    for (auto m_node : m_nodes) {
+      info.Append(Table::kRecvNodes, { i_part, m_node,
+          GetZoneOfNode(m_node), m_node_to_info.at(m_node).second });
+    }
+  }
+  // cell ranges
+  for (int i_sect : cell_sects_) {
+    auto &sect = sects_[i_sect];
+    auto [head, tail] = get_range(
+        cell_numbering_.ranges[i_sect * size_ + rank_], sect.first);
+    info.Append(Table::kCellRanges, { sect.i_zone, sect.i_sect, head, tail });
+  }
+  // inner adjacency
+  std::ranges::sort(adjs, [](Adjacency const &l, Adjacency const &r) {
+    return l.i < r.i || (l.i == r.i && l.j < r.j);
+  });
+  for (auto [i, j, part_j] : adjs) {
+    if (part_j == rank_ && i < j) {
+      info.Append(Table::kInnerAdjacency, { i, j });
+    }
+  }
+  // interpart adjacency
+  std::ranges::stable_sort(adjs, [](Adjacency const &l, Adjacency const &r) {
+    return l.part_j < r.part_j;
+  });
+  for (auto [i, j, part_j] : adjs) {
+    if (part_j != rank_) {
+      info.Append(Table::kInterpartAdjacency, { part_j, i, j,
+          m_cell_to_npe.at(i), m_cell_to_npe.at(j) });
+    }
+  }
+  // face ranges
+  for (int i_sect : face_sects_) {
+    auto &sect = sects_[i_sect];
+    auto [head, tail] = get_range(
+        face_numbering_.ranges[i_sect * size_ + rank_], sect.first);
+    info.Append(Table::kFaceRanges, { sect.i_zone, sect.i_sect, head, tail });
+  }
+  info.Write(partition::GetFileName(case_name, rank_));
+}
+
+template <std::integral Int, std::floating_point Real>
+void ParallelShuffler<Int, Real>::PartitionAndShuffle(
+    std::string const &case_name, std::string const &old_cgns_name,
+    MPI_Comm comm) {
+  auto shuffler = ParallelShuffler(comm);
+  auto print = [&shuffler](char const *message) {
+    if (shuffler.rank_ == 0) {
+      std::printf("[Done] %s\n", message);
+    }
+  };
+  if (shuffler.rank_ == 0) {
+    char cmd[1024];
+    std::snprintf(cmd, sizeof(cmd), "mkdir -p %s/partition",
+        case_name.c_str());
+    if (std::system(cmd))
+      throw std::runtime_error(cmd + std::string(" failed."));
+    print(cmd);
+  }
+  cgp_mpi_comm(comm);
+  int i_file;
+  if (cgp_open(old_cgns_name.c_str(), CG_MODE_READ, &i_file)) {
+    cgp_error_exit();
+  }
+  shuffler.ReadMetadata(i_file);
+  shuffler.ReadNodes(i_file);
+  shuffler.ReadElements(i_file, shuffler.cell_sects_, shuffler.cell_dist_,
+      &shuffler.cell_nodes_, &shuffler.cell_sect_);
+  shuffler.ReadElements(i_file, shuffler.face_sects_, shuffler.face_dist_,
+      &shuffler.face_nodes_, &shuffler.face_sect_);
+  if (cgp_close(i_file)) {
+    cgp_error_exit();
+  }
+  print("ParallelShuffler::Read*");
+  shuffler.BuildDualGraph();
+  print("ParallelShuffler::BuildDualGraph");
+  shuffler.PartitionCells();
+  shuffler.PartitionNodesAndFaces();
+  shuffler.NumberNodesCellsAndFaces();
+  if (shuffler.rank_ == 0) {
+    std::printf("[Done] partition `%s` into %d parts.\n",
+        old_cgns_name.c_str(), shuffler.size_);
+  }
+  MPI_Barrier(comm);  // wait until `case_name/partition` is made
+  shuffler.WriteParts(case_name);
+  MPI_Barrier(comm);
+  if (shuffler.rank_ == 0) {
+    std::printf("[Done] the %d-part `./%s/shuffled.cgns` has been shuffled.\n",
+        shuffler.size_, case_name.c_str());
+  }
+}
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_PARALLEL_SHUFFLER_HPP_
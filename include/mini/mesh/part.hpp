@@ -8,6 +8,7 @@
 #include <cassert>
 
 #include <algorithm>
+#include <array>
 #include <fstream>
 #include <iostream>
 #include <ios>
@@ -24,7 +25,10 @@
 #include "mpi.h"
 #include "pcgnslib.h"
 #include "mini/algebra/eigen.hpp"
+#include "mini/mesh/async_writer.hpp"
 #include "mini/mesh/cgns.hpp"
+#include "mini/mesh/halo.hpp"
+#include "mini/mesh/partition.hpp"
 #include "mini/coordinate/face.hpp"
 #include "mini/integrator/face.hpp"
 #include "mini/coordinate/cell.hpp"
@@ -174,6 +178,10 @@ struct Face {
     assert(sharer_);
     return *sharer_;
   }
+  Cell *sharer_ptr() {
+    assert(sharer_);
+    return sharer_;
+  }
   Global const &HolderToSharer() const {
     return holder_to_sharer_;
   }
@@ -186,7 +194,6 @@ struct Face {
 template <std::integral Int, mini::polynomial::General Poly>
 struct Cell {
   using Polynomial = Poly;
-  using PolynomialUptr = std::unique_ptr<Polynomial>;
   using Scalar = typename Polynomial::Scalar;
   using Integrator = integrator::Cell<Scalar>;
   using IntegratorUptr = std::unique_ptr<Integrator>;
@@ -211,7 +218,7 @@ struct Cell {
  private:
   CoordinateUptr coordinate_ptr_;
   IntegratorUptr integrator_ptr_;
-  PolynomialUptr polynomial_ptr_;
+  Polynomial polynomial_;  // stored inline, so coeffs are contiguous with Cells
   Scalar length_;
 
  public:
@@ -226,7 +233,7 @@ struct Cell {
   Cell(CoordinateUptr &&coordinate_ptr, IntegratorUptr &&integrator_ptr, Int m_cell)
       : coordinate_ptr_(std::move(coordinate_ptr)),
         integrator_ptr_(std::move(integrator_ptr)),
-        polynomial_ptr_(std::make_unique<Polynomial>(*integrator_ptr_)),
+        polynomial_(*integrator_ptr_),
         length_(std::cbrt(volume()) * 0.5), metis_id(m_cell) {
   }
   Cell() = default;
@@ -263,10 +270,10 @@ struct Cell {
     return *coordinate_ptr_;
   }
   Polynomial const &polynomial() const {
-    return *polynomial_ptr_;
+    return polynomial_;
   }
   Polynomial &polynomial() {
-    return *polynomial_ptr_;
+    return polynomial_;
   }
   Global LocalToGlobal(const Local &local) const {
     return coordinate().LocalToGlobal(local);
@@ -427,7 +434,6 @@ class Part {
   using CellIndex = cgns::CellIndex<Int>;
   using Coordinates = part::Coordinates<Int, Scalar>;
   using Section = part::Section<Int, Poly>;
-  static constexpr int kLineWidth = 128;
   static constexpr int kFields = Section::kFields;
   static constexpr int i_base = 1;
   static constexpr int i_grid = 1;
@@ -437,11 +443,37 @@ class Part {
       = sizeof(Scalar) == 8 ? CGNS_ENUMV(RealDouble) : CGNS_ENUMV(RealSingle);
   static const MPI_Datatype kMpiIntType;
   static const MPI_Datatype kMpiRealType;
+  using Table = partition::Table;
+
+  template <int N>
+  static std::array<Int, N> GetColumns(partition::Info const &info,
+      Table table, Int i_row) {
+    auto columns = std::array<Int, N>();
+    std::copy_n(info.GetRow(table, i_row), N, columns.begin());
+    return columns;
+  }
 
  public:
-  Part(std::string const &directory, int rank, int size)
+  /**
+   * @brief Construct a new Part object, which only communicates with the other `Part`s on the same communicator.
+   *
+   * `cgp_mpi_comm(comm)` should be called before reading or writing any CGNS file.
+   *
+   * @param directory the directory holding the shuffled mesh and the partition files
+   * @param rank the rank of this process in `comm`
+   * @param size the number of processes in `comm`
+   * @param comm the communicator shared by all `Part`s of the same mesh
+   */
+  Part(std::string const &directory, int rank, int size,
+      MPI_Comm comm = MPI_COMM_WORLD)
       : directory_(directory), cgns_file_(directory + "/shuffled.cgns"),
-        rank_(rank), size_(size) {
+        comm_(comm), rank_(rank), size_(size) {
+#ifndef NDEBUG
+    int comm_rank, comm_size;
+    MPI_Comm_rank(comm, &comm_rank);
+    MPI_Comm_size(comm, &comm_size);
+    assert(rank == comm_rank && size == comm_size);
+#endif
   }
 
   /**
@@ -451,17 +483,18 @@ class Part {
    * 
    */
   void BuildGeometry() {
+    AsyncWriter::FlushAll();
     int i_file;
     if (cgp_open(cgns_file_.c_str(), CG_MODE_READ, &i_file)) {
       cgp_error_exit();
     }
-    auto txt_file = directory_ + "/partition/" + std::to_string(rank_) + ".txt";
-    auto istrm = std::ifstream(txt_file);
-    BuildLocalNodes(istrm, i_file);
-    auto [recv_nodes, recv_coords] = ShareGhostNodes(istrm);
+    auto info = partition::Info::Read(
+        partition::GetFileName(directory_, rank_));
+    BuildLocalNodes(info, i_file);
+    auto [recv_nodes, recv_coords] = ShareGhostNodes(info);
     BuildGhostNodes(recv_nodes, recv_coords);
-    BuildLocalCells(istrm, i_file);
-    auto ghost_adj = BuildAdj(istrm);
+    BuildLocalCells(info, i_file);
+    auto ghost_adj = BuildAdj(info);
     auto recv_cells = ShareGhostCells(ghost_adj);
     auto m_to_recv_cells = BuildGhostCells(ghost_adj, recv_cells);
     FillCellPtrs(ghost_adj);
@@ -469,7 +502,8 @@ class Part {
     AddGhostCellId();
     BuildLocalFaces();
     BuildGhostFaces(ghost_adj, recv_cells, m_to_recv_cells);
-    BuildBoundaryFaces(istrm, i_file);
+    FillFacePtrs();
+    BuildBoundaryFaces(info, i_file);
     if (cgp_close(i_file)) {
       cgp_error_exit();
     }
@@ -489,6 +523,9 @@ class Part {
   int mpi_size() const {
     return size_;
   }
+  MPI_Comm mpi_comm() const {
+    return comm_;
+  }
 
  private:
   int SolnNameToId(int i_file, int i_base, int i_zone,
@@ -532,16 +569,13 @@ class Part {
     assert(i_field <= n_fields);
     return i_field;
   }
-  void BuildLocalNodes(std::ifstream &istrm, int i_file) {
+  void BuildLocalNodes(partition::Info const &info, int i_file) {
     if (cg_base_read(i_file, i_base, base_name_, &cell_dim_, &phys_dim_)) {
       cgp_error_exit();
     }
-    char line[kLineWidth];
-    istrm.getline(line, kLineWidth); assert(line[0] == '#');
     // node coordinates
-    while (istrm.getline(line, kLineWidth) && line[0] != '#') {
-      int i_zone, head, tail;
-      std::sscanf(line, "%d %d %d", &i_zone, &head, &tail);
+    for (Int i = 0, n = info.CountRows(Table::kNodeRanges); i < n; ++i) {
+      auto [i_zone, head, tail] = GetColumns<3>(info, Table::kNodeRanges, i);
       auto node_group = Coordinates(head, tail - head);
       if (cg_zone_read(i_file, i_base, i_zone,
           node_group.zone_name_, node_group.zone_size_[0])) {
@@ -578,13 +612,11 @@ class Part {
   std::pair<
     std::map<Int, std::vector<Int>>,
     std::vector<std::vector<Scalar>>
-  > ShareGhostNodes(std::ifstream &istrm) {
-    char line[kLineWidth];
+  > ShareGhostNodes(partition::Info const &info) {
     // send nodes info
     std::map<Int, std::vector<Int>> send_nodes;
-    while (istrm.getline(line, kLineWidth) && line[0] != '#') {
-      int i_part, m_node;
-      std::sscanf(line, "%d %d", &i_part, &m_node);
+    for (Int i = 0, n = info.CountRows(Table::kSendNodes); i < n; ++i) {
+      auto [i_part, m_node] = GetColumns<2>(info, Table::kSendNodes, i);
       send_nodes[i_part].emplace_back(m_node);
     }
     std::vector<MPI_Request> requests;
@@ -603,13 +635,13 @@ class Part {
       int tag = i_part;
       auto &request = requests.emplace_back();
       MPI_Isend(coords.data(), n_reals, kMpiRealType, i_part, tag,
-          MPI_COMM_WORLD, &request);
+          comm_, &request);
     }
     // recv nodes info
     std::map<Int, std::vector<Int>> recv_nodes;
-    while (istrm.getline(line, kLineWidth) && line[0] != '#') {
-      int i_part, m_node, i_zone, i_node;
-      std::sscanf(line, "%d %d %d %d", &i_part, &m_node, &i_zone, &i_node);
+    for (Int i = 0, n = info.CountRows(Table::kRecvNodes); i < n; ++i) {
+      auto [i_part, m_node, i_zone, i_node]
+          = GetColumns<4>(info, Table::kRecvNodes, i);
       recv_nodes[i_part].emplace_back(m_node);
       m_to_node_index_.emplace(m_node, NodeIndex(i_zone, i_node));
     }
@@ -621,7 +653,7 @@ class Part {
       int tag = rank_;
       auto &request = requests.emplace_back();
       MPI_Irecv(coords.data(), n_reals, kMpiRealType, i_part, tag,
-          MPI_COMM_WORLD, &request);
+          comm_, &request);
     }
     // wait until all send/recv finish
     std::vector<MPI_Status> statuses(requests.size());
@@ -686,12 +718,11 @@ class Part {
     return { std::move(coordinate_uptr), std::move(integrator_uptr) };
   }
 
-  void BuildLocalCells(std::ifstream &istrm, int i_file) {
-    char line[kLineWidth];
+  void BuildLocalCells(partition::Info const &info, int i_file) {
     // build local cells
-    while (istrm.getline(line, kLineWidth) && line[0] != '#') {
-      int i_zone, i_sect, head, tail;
-      std::sscanf(line, "%d %d %d %d", &i_zone, &i_sect, &head, &tail);
+    for (Int i = 0, n = info.CountRows(Table::kCellRanges); i < n; ++i) {
+      auto [i_zone, i_sect, head, tail]
+          = GetColumns<4>(info, Table::kCellRanges, i);
       cgsize_t range_min[] = { head };
       cgsize_t range_max[] = { tail - 1 };
       cgsize_t mem_dimensions[] = { tail - head };
@@ -767,7 +798,7 @@ class Part {
   }
   void AddGhostCellId() {
     Int id = CountLocalCells();
-    for (auto &[_, cell] : ghost_cells_) {
+    for (auto &cell : ghost_cells_) {
       cell.id_ = id++;
     }
     assert(CountGhostCells() + CountLocalCells() == id);
@@ -803,12 +834,12 @@ class Part {
     std::vector<std::pair<Int, Int>>
         m_cell_pairs;
   };
-  GhostAdj BuildAdj(std::ifstream &istrm) {
-    char line[kLineWidth];
+  GhostAdj BuildAdj(partition::Info const &info) {
     // local adjacency
-    while (istrm.getline(line, kLineWidth) && line[0] != '#') {
-      int i, j;
-      std::sscanf(line, "%d %d", &i, &j);
+    auto n_local_adjs = info.CountRows(Table::kInnerAdjacency);
+    local_adjs_.reserve(n_local_adjs);
+    for (Int r = 0; r < n_local_adjs; ++r) {
+      auto [i, j] = GetColumns<2>(info, Table::kInnerAdjacency, r);
       local_adjs_.emplace_back(i, j);
     }
     // ghost adjacency
@@ -816,9 +847,10 @@ class Part {
     auto &send_npes = ghost_adj.send_npes;
     auto &recv_npes = ghost_adj.recv_npes;
     auto &m_cell_pairs = ghost_adj.m_cell_pairs;
-    while (istrm.getline(line, kLineWidth) && line[0] != '#') {
-      int p, i, j, npe_i, npe_j;
-      std::sscanf(line, "%d %d %d %d %d", &p, &i, &j, &npe_i, &npe_j);
+    for (Int r = 0, n = info.CountRows(Table::kInterpartAdjacency);
+        r < n; ++r) {
+      auto [p, i, j, npe_i, npe_j]
+          = GetColumns<5>(info, Table::kInterpartAdjacency, r);
       send_npes[p][i] = npe_i;
       recv_npes[p][j] = npe_j;
       m_cell_pairs.emplace_back(i, j);
@@ -849,7 +881,7 @@ class Part {
       int tag = i_part;
       auto &request = requests.emplace_back();
       MPI_Isend(send_buf.data(), n_ints, kMpiIntType, i_part, tag,
-          MPI_COMM_WORLD, &request);
+          comm_, &request);
     }
     // recv cell.i_zone and cell.node_id_list
     std::vector<std::vector<Int>> recv_cells;
@@ -864,7 +896,7 @@ class Part {
       recv_buf.resize(n_ints);
       auto &request = requests.emplace_back();
       MPI_Irecv(recv_buf.data(), n_ints, kMpiIntType, i_part, tag,
-          MPI_COMM_WORLD, &request);
+          comm_, &request);
     }
     // wait until all send/recv finish
     std::vector<MPI_Status> statuses(requests.size());
@@ -881,6 +913,12 @@ class Part {
     auto &recv_npes = ghost_adj.recv_npes;
     // build ghost cells
     std::unordered_map<Int, GhostCellIndex> m_to_recv_cells;
+    // reserved in advance, so that pointers to ghost cells never dangle
+    Int n_ghost_cells = 0;
+    for (auto &[i_part, npes] : recv_npes) {
+      n_ghost_cells += npes.size();
+    }
+    ghost_cells_.reserve(n_ghost_cells);
     int i_source = 0;
     for (auto &[i_part, npes] : recv_npes) {
       auto &recv_buf = recv_cells.at(i_source);
@@ -892,9 +930,9 @@ class Part {
         auto *i_node_list = &recv_buf[index];
         auto [coordinate_uptr, integrator_uptr]
             = BuildIntegratorForCell(npe, i_zone, i_node_list);
-        auto cell = Cell(std::move(coordinate_uptr),
+        m_to_ghost_cell_.emplace(m_cell, ghost_cells_.size());
+        ghost_cells_.emplace_back(std::move(coordinate_uptr),
             std::move(integrator_uptr), m_cell);
-        ghost_cells_[m_cell] = std::move(cell);
         index += npe;
       }
       ++i_source;
@@ -919,17 +957,26 @@ class Part {
       auto &curr_part = recv_cell_ptrs_[i_part];
       assert(curr_part.empty());
       for (auto [m_cell, npe] : npes) {
-        auto &cell = ghost_cells_.at(m_cell);
+        auto &cell = ghost_cells_.at(m_to_ghost_cell_.at(m_cell));
         curr_part.emplace_back(&cell);
       }
     }
-    InitializeRequestsAndBuffers(kFields,
-        &requests_, &send_coeffs_, &recv_coeffs_);
-    assert(send_cell_ptrs_.size() == send_coeffs_.size());
-    assert(recv_cell_ptrs_.size() == recv_coeffs_.size());
-    assert(requests_.size() == send_coeffs_.size() + recv_coeffs_.size());
+    coeff_halo_ = BuildCellHalo(kFields);
+  }
+  Cell const &GetLocalCell(Int m_cell) const {
+    auto &index = m_to_cell_index_.at(m_cell);
+    return local_cells_.at(index.i_zone).at(index.i_sect)[index.i_cell];
   }
   void BuildLocalFaces() {
+    // number faces in the order of their cells, so that face loops walk cells
+    auto get_key = [this](std::pair<Int, Int> const &m_pair) {
+      auto i = GetLocalCell(m_pair.first).id();
+      auto j = GetLocalCell(m_pair.second).id();
+      return std::make_pair(std::min(i, j), std::max(i, j));
+    };
+    std::ranges::sort(local_adjs_, {}, get_key);
+    // reserved in advance, so that pointers to local faces never dangle
+    local_faces_.reserve(local_adjs_.size());
     // build local faces
     for (auto [m_holder, m_sharer] : local_adjs_) {
       auto &holder_info = m_to_cell_index_[m_holder];
@@ -966,17 +1013,23 @@ class Part {
           face_node_list, face_npe);
       auto [coordinate_uptr, integrator_uptr]
           = BuildIntegratorForFace(face_npe, i_zone, face_node_list);
-      auto face_uptr = std::make_unique<Face>(std::move(coordinate_uptr),
+      auto &face = local_faces_.emplace_back(std::move(coordinate_uptr),
           std::move(integrator_uptr), &holder, &sharer, local_faces_.size());
-      holder.adj_faces_.emplace_back(face_uptr.get());
-      sharer.adj_faces_.emplace_back(face_uptr.get());
-      local_faces_.emplace_back(std::move(face_uptr));
+      holder.adj_faces_.emplace_back(&face);
+      sharer.adj_faces_.emplace_back(&face);
     }
   }
   void BuildGhostFaces(GhostAdj const &ghost_adj,
       std::vector<std::vector<Int>> const &recv_cells,
       std::unordered_map<Int, GhostCellIndex> const &m_to_recv_cells) {
-    auto &m_cell_pairs = ghost_adj.m_cell_pairs;
+    // number faces in the order of their holders
+    auto m_cell_pairs = ghost_adj.m_cell_pairs;
+    auto get_key = [this](std::pair<Int, Int> const &m_pair) {
+      return std::make_pair(GetLocalCell(m_pair.first).id(), m_pair.second);
+    };
+    std::ranges::sort(m_cell_pairs, {}, get_key);
+    // reserved in advance, so that pointers to ghost faces never dangle
+    ghost_faces_.reserve(m_cell_pairs.size());
     // build ghost faces
     for (auto [m_holder, m_sharer] : m_cell_pairs) {
       auto &holder_info = m_to_cell_index_[m_holder];
@@ -1003,18 +1056,38 @@ class Part {
       // let the normal vector point from holder to sharer
       auto &zone = local_cells_[i_zone];
       auto &holder = zone[holder_info.i_sect][holder_info.i_cell];
-      auto &sharer = ghost_cells_.at(m_sharer);
+      auto &sharer = ghost_cells_.at(m_to_ghost_cell_.at(m_sharer));
       holder.adj_cells_.emplace_back(&sharer);
       auto *face_node_list = common_nodes.data();
       coordinate::SortNodesOnFace(holder.coordinate(), &holder_nodes[holder_head],
           face_node_list, face_npe);
       auto [coordinate_uptr, integrator_uptr]
           = BuildIntegratorForFace(face_npe, i_zone, face_node_list);
-      auto face_uptr = std::make_unique<Face>(std::move(coordinate_uptr),
+      auto &face = ghost_faces_.emplace_back(std::move(coordinate_uptr),
           std::move(integrator_uptr), &holder, &sharer,
           local_faces_.size() + ghost_faces_.size());
-      holder.adj_faces_.emplace_back(face_uptr.get());
-      ghost_faces_.emplace_back(std::move(face_uptr));
+      holder.adj_faces_.emplace_back(&face);
+    }
+  }
+  void FillFacePtrs() {
+    auto ghost_cell_to_part = std::unordered_map<Cell const *, Int>();
+    for (auto &[i_part, cell_ptrs] : recv_cell_ptrs_) {
+      for (auto *cell_ptr : cell_ptrs) {
+        ghost_cell_to_part[cell_ptr] = i_part;
+      }
+    }
+    for (auto &face : ghost_faces_) {
+      auto i_part = ghost_cell_to_part.at(&face.sharer());
+      ghost_face_ptrs_[i_part].emplace_back(&face);
+    }
+    // Both sides of a ghost face see the same pair of cells, so sorting faces
+    // by that pair lets them agree on the order of faces in messages.
+    auto get_key = [](Face const *face_ptr) {
+      auto i = face_ptr->holder().metis_id, j = face_ptr->sharer().metis_id;
+      return std::make_pair(std::min(i, j), std::max(i, j));
+    };
+    for (auto &[i_part, face_ptrs] : ghost_face_ptrs_) {
+      std::ranges::sort(face_ptrs, {}, get_key);
     }
   }
 
@@ -1067,10 +1140,125 @@ class Part {
       }
     }
   }
+  /**
+   * @brief Write the mesh into `<directory>/<grid_name>.cgns`, to which the files written by later calls of `WriteSolutions` are linked.
+   *
+   * Since the mesh never changes, each of those files only holds the solutions.
+   */
+  void WriteGrid(std::string const &grid_name = "Grid") {
+    AsyncWriter::FlushAll();
+    auto cgns_file = directory_ + "/" + grid_name + ".cgns";
+    CreateFile(cgns_file, "", comm_);
+    int i_file;
+    if (cgp_open(cgns_file.c_str(), CG_MODE_MODIFY, &i_file)) {
+      cgp_error_exit();
+    }
+    WriteGridData(i_file);
+    if (cgp_close(i_file)) {
+      cgp_error_exit();
+    }
+    // linked by a path relative to `directory_`
+    grid_file_ = grid_name + ".cgns";
+  }
   void WriteSolutions(std::string const &soln_name = "0") const {
+    AsyncWriter::FlushAll();
+    WriteSolutions(soln_name, comm_,
+        [](Section const &section, int i_field) {
+          return section.GetField(i_field).data();
+        });
+  }
+  /**
+   * @brief Copy the fields gathered by `GatherSolutions` and let `writer` write them in the background.
+   *
+   * The copies are made before returning, so the fields can be modified at once.
+   * All CGNS calls of the task, including `cgp_mpi_comm`, are made on the background thread, while the other CGNS calls of `Part` wait for it by `AsyncWriter::FlushAll`.
+   */
+  void WriteSolutions(std::string const &soln_name, AsyncWriter *writer) const {
+    // copied in the same order as being written
+    auto fields = std::make_shared<std::vector<std::vector<Scalar>>>();
+    int n_zones = local_nodes_.size();
+    for (int i_zone = 1; i_zone <= n_zones; ++i_zone) {
+      auto &zone = local_cells_.at(i_zone);
+      int n_sects = zone.size();
+      for (int i_field = 1; i_field <= kFields; ++i_field) {
+        for (int i_sect = 1; i_sect <= n_sects; ++i_sect) {
+          auto &field = zone.at(i_sect).GetField(i_field);
+          fields->emplace_back(field.begin(), field.end());
+        }
+      }
+    }
+    writer->Push([this, soln_name, fields](MPI_Comm comm) {
+      cgp_mpi_comm(comm);
+      auto i_field = fields->begin();
+      try {
+        WriteSolutions(soln_name, comm, [&i_field](Section const &, int) {
+          return (i_field++)->data();
+        });
+      } catch (...) {
+        cgp_mpi_comm(comm_);
+        throw;
+      }
+      cgp_mpi_comm(comm_);
+    });
+  }
+
+ private:
+  template <class GetFieldData>
+  void WriteSolutions(std::string const &soln_name, MPI_Comm comm,
+      GetFieldData &&get_field_data) const {
     int n_zones = local_nodes_.size();
-    int i_file, i;
     auto cgns_file = directory_ + "/" + soln_name + ".cgns";
+    CreateFile(cgns_file, grid_file_, comm);
+    int i_file;
+    if (cgp_open(cgns_file.c_str(), CG_MODE_MODIFY, &i_file)) {
+      cgp_error_exit();
+    }
+    if (grid_file_.empty()) {
+      WriteGridData(i_file);
+    }
+    for (int i_zone = 1; i_zone <= n_zones; ++i_zone) {
+      int n_solns;
+      if (cg_nsols(i_file, i_base, i_zone, &n_solns)) {
+        cgp_error_exit();
+      }
+      int i_soln;
+      if (cg_sol_write(i_file, i_base, i_zone, "DataOnCells",
+          CGNS_ENUMV(CellCenter), &i_soln)) {
+        cgp_error_exit();
+      }
+      auto &zone = local_cells_.at(i_zone);
+      for (int i_field = 1; i_field <= kFields; ++i_field) {
+        int n_sects = zone.size();
+        for (int i_sect = 1; i_sect <= n_sects; ++i_sect) {
+          auto &section = zone.at(i_sect);
+          auto field_name = "Field" + std::to_string(i_field);
+          int field_id;
+          if (cgp_field_write(i_file, i_base, i_zone, i_soln, kRealType,
+              field_name.c_str(),  &field_id)) {
+            cgp_error_exit();
+          }
+          // assert(field_id == i_field);
+          cgsize_t first[] = { section.head() };
+          cgsize_t last[] = { section.tail() - 1 };
+          if (cgp_field_write_data(i_file, i_base, i_zone, i_soln, i_field,
+              first, last, get_field_data(section, i_field))) {
+            cgp_error_exit();
+          }
+        }
+      }
+    }
+    if (cgp_close(i_file)) {
+      cgp_error_exit();
+    }
+  }
+
+  /**
+   * @brief Create a file holding the base and the zones, whose grids are either empty or linked to `grid_file`.
+   */
+  void CreateFile(std::string const &cgns_file,
+      std::string const &grid_file, MPI_Comm comm) const {
+    int n_zones = local_nodes_.size();
+    int i_file, i;
     if (rank_ == 0) {
       if (cg_open(cgns_file.c_str(), CG_MODE_WRITE, &i_file)) {
         cgp_error_exit();
@@ -1086,19 +1274,44 @@ class Part {
             || i != i_zone) {
           cgp_error_exit();
         }
-        if (cg_grid_write(i_file, i_base, i_zone, "GridCoordinates", &i)
-            || i != i_grid) {
-          cgp_error_exit();
+        if (grid_file.empty()) {
+          if (cg_grid_write(i_file, i_base, i_zone, "GridCoordinates", &i)
+              || i != i_grid) {
+            cgp_error_exit();
+          }
+        } else {
+          LinkGrid(i_file, i_zone, grid_file);
         }
       }
       if (cg_close(i_file)) {
         cgp_error_exit();
       }
     }
-    MPI_Barrier(MPI_COMM_WORLD);
-    if (cgp_open(cgns_file.c_str(), CG_MODE_MODIFY, &i_file)) {
+    MPI_Barrier(comm);
+  }
+  void LinkGrid(int i_file, int i_zone, std::string const &grid_file) const {
+    auto &node_group = local_nodes_.at(i_zone);
+    auto zone_path = std::string("/") + base_name_ + "/"
+        + node_group.zone_name_ + "/";
+    if (cg_goto(i_file, i_base, "Zone_t", i_zone, "end")) {
+      cgp_error_exit();
+    }
+    if (cg_link_write("GridCoordinates", grid_file.c_str(),
+        (zone_path + "GridCoordinates").c_str())) {
       cgp_error_exit();
     }
+    int n_sects = connectivities_.at(i_zone).size();
+    for (int i_sect = 1; i_sect <= n_sects; ++i_sect) {
+      auto &sect = connectivities_.at(i_zone).at(i_sect);
+      if (cg_link_write(sect.name, grid_file.c_str(),
+          (zone_path + sect.name).c_str())) {
+        cgp_error_exit();
+      }
+    }
+  }
+  void WriteGridData(int i_file) const {
+    int n_zones = local_nodes_.size();
+    int i;
     for (int i_zone = 1; i_zone <= n_zones; ++i_zone) {
       // write node coordinates
       auto &node_group = local_nodes_.at(i_zone);
@@ -1135,41 +1348,12 @@ class Part {
           cgp_error_exit();
         }
       }
-      int n_solns;
-      if (cg_nsols(i_file, i_base, i_zone, &n_solns)) {
-        cgp_error_exit();
-      }
-      int i_soln;
-      if (cg_sol_write(i_file, i_base, i_zone, "DataOnCells",
-          CGNS_ENUMV(CellCenter), &i_soln)) {
-        cgp_error_exit();
-      }
-      auto &zone = local_cells_.at(i_zone);
-      for (int i_field = 1; i_field <= kFields; ++i_field) {
-        int n_sects = zone.size();
-        for (int i_sect = 1; i_sect <= n_sects; ++i_sect) {
-          auto &section = zone.at(i_sect);
-          auto field_name = "Field" + std::to_string(i_field);
-          int field_id;
-          if (cgp_field_write(i_file, i_base, i_zone, i_soln, kRealType,
-              field_name.c_str(),  &field_id)) {
-            cgp_error_exit();
-          }
-          // assert(field_id == i_field);
-          cgsize_t first[] = { section.head() };
-          cgsize_t last[] = { section.tail() - 1 };
-          if (cgp_field_write_data(i_file, i_base, i_zone, i_soln, i_field,
-              first, last, section.GetField(i_field).data())) {
-            cgp_error_exit();
-          }
-        }
-      }
-    }
-    if (cgp_close(i_file)) {
-      cgp_error_exit();
     }
   }
+
+ public:
   void ReadSolutions(std::string const &soln_name) {
+    AsyncWriter::FlushAll();
     int n_zones = local_nodes_.size();
     int i_file;
     auto cgns_file = directory_ + "/" + soln_name + ".cgns";
@@ -1206,113 +1390,148 @@ class Part {
       cgp_error_exit();
     }
   }
+  using Halo = mesh::Halo<Scalar>;
+
   /**
-   * @brief Initialize data structures used in ShareGhostCellData and UpdateGhostCellData.
+   * @brief Build a Halo used in ShareGhostCellData and UpdateGhostCellData.
+   * 
+   * It should be called once and only once before the main loop.
    * 
    * @param n_scalar_per_cell 
-   * @param requests_ptr 
-   * @param send_data_ptr 
-   * @param recv_data_ptr 
+   * @return Halo 
    */
-  void InitializeRequestsAndBuffers(Int n_scalar_per_cell,
-      std::vector<MPI_Request> *requests_ptr,
-      std::vector<std::vector<Scalar>> *send_data_ptr,
-      std::vector<std::vector<Scalar>> *recv_data_ptr) const {
-    assert(requests_ptr->empty());
-    assert(send_data_ptr->empty());
-    assert(recv_data_ptr->empty());
-    for (auto &[i_part, cell_ptrs] : send_cell_ptrs_) {
-      send_data_ptr->emplace_back(cell_ptrs.size() * n_scalar_per_cell);
-    }
-    for (auto &[i_part, cell_ptrs] : recv_cell_ptrs_) {
-      recv_data_ptr->emplace_back(cell_ptrs.size() * n_scalar_per_cell);
-    }
-    requests_ptr->resize(send_data_ptr->size() + recv_data_ptr->size());
+  Halo BuildCellHalo(Int n_scalar_per_cell) const {
+    return BuildHalo(send_cell_ptrs_, recv_cell_ptrs_, n_scalar_per_cell);
   }
 
   /**
-   * @brief Register the sharing of data on `Cell`s between neighboring `Part`s.
+   * @brief Start the sharing of data on `Cell`s between neighboring `Part`s.
    * 
    * @tparam M 
-   * @param requests_ptr 
-   * @param send_data_ptr 
-   * @param recv_data_ptr 
-   * @param move_data_from_cell_to_buffer 
+   * @param halo the Halo built by BuildCellHalo
+   * @param move_data_from_cell_to_buffer `(Cell const *, Scalar *) -> Scalar *`
    */
   template <class M>
-  void ShareGhostCellData(std::vector<MPI_Request> *requests_ptr,
-      std::vector<std::vector<Scalar>> *send_data_ptr,
-      std::vector<std::vector<Scalar>> *recv_data_ptr,
-      M &&move_data_from_cell_to_buffer) {
-    int i_req = 0;
-    // send Data on ghost Cells of each neighboring Part
-    int i_buf = 0;
-    for (auto &[i_part, cell_ptrs] : send_cell_ptrs_) {
-      auto &send_buf = send_data_ptr->at(i_buf++);
-      Scalar *data = send_buf.data();
-      for (auto *cell_ptr : cell_ptrs) {
-        data = move_data_from_cell_to_buffer(cell_ptr, data);
-      }
-      assert(data == send_buf.data() + send_buf.size());
-      int tag = i_part;
-      auto &request = requests_ptr->at(i_req++);
-      MPI_Isend(send_buf.data(), send_buf.size(), kMpiRealType, i_part, tag,
-          MPI_COMM_WORLD, &request);
-    }
-    // recv Data on ghost Cells from each neighboring Part
-    i_buf = 0;
-    for (auto &[i_part, cell_ptrs] : recv_cell_ptrs_) {
-      auto &recv_buf = recv_data_ptr->at(i_buf++);
-      int tag = rank_;
-      auto &request = requests_ptr->at(i_req++);
-      MPI_Irecv(recv_buf.data(), recv_buf.size(), kMpiRealType, i_part, tag,
-          MPI_COMM_WORLD, &request);
-    }
-    assert(i_req == send_data_ptr->size() + recv_data_ptr->size());
+  void ShareGhostCellData(Halo *halo, M &&move_data_from_cell_to_buffer) const {
+    ShareData(send_cell_ptrs_, halo,
+        std::forward<M>(move_data_from_cell_to_buffer));
   }
   void ShareGhostCellCoeffs() {
     auto operation = [](Cell const *cell_ptr, Scalar *data) -> Scalar * {
       return cell_ptr->polynomial().WriteCoeffTo(data);
     };
-    ShareGhostCellData(&requests_, &send_coeffs_, &recv_coeffs_, operation);
+    ShareGhostCellData(&coeff_halo_, operation);
   }
 
   /**
    * @brief Finish the sharing of data on `Cell`s between neighboring `Part`s.
    * 
    * @tparam M 
-   * @param requests_ptr 
-   * @param recv_data_ptr 
-   * @param move_data_from_buffer_to_cell 
+   * @param halo the Halo passed to ShareGhostCellData
+   * @param move_data_from_buffer_to_cell `(Cell *, Scalar const *) -> Scalar const *`
    */
   template <class M>
-  void UpdateGhostCellData(std::vector<MPI_Request> *requests_ptr,
-      std::vector<std::vector<Scalar>> *recv_data_ptr,
-      M &&move_data_from_buffer_to_cell) {
+  void UpdateGhostCellData(Halo *halo, M &&move_data_from_buffer_to_cell) const {
+    UpdateData(recv_cell_ptrs_, halo,
+        std::forward<M>(move_data_from_buffer_to_cell));
+  }
+  void UpdateGhostCellCoeffs() {
+    auto operation = [](Cell *cell_ptr, Scalar const *data) -> Scalar const * {
+      return cell_ptr->polynomial().GetCoeffFrom(data);
+    };
+    UpdateGhostCellData(&coeff_halo_, operation);
+  }
+
+  /**
+   * @brief Build a Halo used in ShareGhostFaceData and UpdateGhostFaceData.
+   * 
+   * It should be called once and only once before the main loop.
+   * 
+   * @param n_scalar_per_face 
+   * @return Halo 
+   */
+  Halo BuildFaceHalo(Int n_scalar_per_face) const {
+    return BuildHalo(ghost_face_ptrs_, ghost_face_ptrs_, n_scalar_per_face);
+  }
+
+  /**
+   * @brief Start the sharing of data on ghost `Face`s between neighboring `Part`s.
+   * 
+   * Each ghost `Face` sends data of its holder (a local `Cell`) and receives data of its sharer (a ghost `Cell`), which is much less than sharing whole `Cell`s if only data on `Face`s are needed.
+   * 
+   * @tparam M 
+   * @param halo the Halo built by BuildFaceHalo
+   * @param move_data_from_face_to_buffer `(Face const *, Scalar *) -> Scalar *`
+   */
+  template <class M>
+  void ShareGhostFaceData(Halo *halo, M &&move_data_from_face_to_buffer) const {
+    ShareData(ghost_face_ptrs_, halo,
+        std::forward<M>(move_data_from_face_to_buffer));
+  }
+
+  /**
+   * @brief Finish the sharing of data on ghost `Face`s between neighboring `Part`s.
+   * 
+   * @tparam M 
+   * @param halo the Halo passed to ShareGhostFaceData
+   * @param move_data_from_buffer_to_face `(Face *, Scalar const *) -> Scalar const *`
+   */
+  template <class M>
+  void UpdateGhostFaceData(Halo *halo, M &&move_data_from_buffer_to_face) const {
+    UpdateData(ghost_face_ptrs_, halo,
+        std::forward<M>(move_data_from_buffer_to_face));
+  }
+
+ private:
+  template <class T>
+  Halo BuildHalo(std::map<Int, std::vector<T>> const &send_ptrs,
+      std::map<Int, std::vector<T>> const &recv_ptrs,
+      Int n_scalar_per_item) const {
+    auto send_sizes = std::vector<std::pair<int, int>>();
+    for (auto &[i_part, ptrs] : send_ptrs) {
+      send_sizes.emplace_back(i_part, ptrs.size() * n_scalar_per_item);
+    }
+    auto recv_sizes = std::vector<std::pair<int, int>>();
+    for (auto &[i_part, ptrs] : recv_ptrs) {
+      recv_sizes.emplace_back(i_part, ptrs.size() * n_scalar_per_item);
+    }
+    return Halo(send_sizes, recv_sizes, comm_, kMpiRealType);
+  }
+  template <class T, class M>
+  static void ShareData(std::map<Int, std::vector<T>> const &send_ptrs,
+      Halo *halo, M &&move_data_to_buffer) {
+    assert(send_ptrs.size() == halo->CountSendBufs());
+    // pack data on inter Cells (or ghost Faces) for each neighboring Part
+    int i_buf = 0;
+    for (auto &[i_part, ptrs] : send_ptrs) {
+      auto &send_buf = halo->send_buf(i_buf++);
+      Scalar *data = send_buf.data();
+      for (auto *ptr : ptrs) {
+        data = move_data_to_buffer(ptr, data);
+      }
+      assert(data == send_buf.data() + send_buf.size());
+    }
+    halo->Start();
+  }
+  template <class T, class M>
+  static void UpdateData(std::map<Int, std::vector<T>> const &recv_ptrs,
+      Halo *halo, M &&move_data_from_buffer) {
+    assert(recv_ptrs.size() == halo->CountRecvBufs());
     // wait until all send/recv finish
-    std::vector<MPI_Status> statuses(requests_ptr->size());
-    MPI_Waitall(requests_ptr->size(), requests_ptr->data(), statuses.data());
-    int req_size = requests_ptr->size();
-    requests_ptr->clear();
-    requests_ptr->resize(req_size);
-    // update coeffs
+    halo->Wait();
+    // unpack data on ghost Cells (or ghost Faces) from each neighboring Part
     int i_buf = 0;
-    for (auto &[i_part, cell_ptrs] : recv_cell_ptrs_) {
-      auto &recv_buf = recv_data_ptr->at(i_buf++);
+    for (auto &[i_part, ptrs] : recv_ptrs) {
+      auto &recv_buf = halo->recv_buf(i_buf++);
       Scalar const *data = recv_buf.data();
-      for (auto *cell_ptr : cell_ptrs) {
-        data = move_data_from_buffer_to_cell(cell_ptr, data);
+      for (auto *ptr : ptrs) {
+        data = move_data_from_buffer(ptr, data);
       }
       assert(data == recv_buf.data() + recv_buf.size());
     }
   }
-  void UpdateGhostCellCoeffs() {
-    auto operation = [](Cell *cell_ptr, Scalar const *data) -> Scalar const * {
-      return cell_ptr->polynomial().GetCoeffFrom(data);
-    };
-    UpdateGhostCellData(&requests_, &recv_coeffs_, operation);
-  }
 
+ public:
   // Viewers of `Cell`s and `Face`s:
   /**
    * @brief Get a range of `(Cell const &)`, which contains all ghost `Cell`s.
@@ -1320,7 +1539,7 @@ class Part {
    * @return std::ranges::input_range 
    */
   std::ranges::input_range auto GetGhostCells() const {
-    return ghost_cells_ | std::views::values;
+    return ghost_cells_ | std::views::all;
   }
   /**
    * @brief Get a range of `(Cell const &)`, which contains all local `Cell`s.
@@ -1364,8 +1583,7 @@ class Part {
    * @return std::ranges::input_range the range of `Face`s
    */
   std::ranges::input_range auto GetLocalFaces() const {
-    auto t = [](auto &uptr) -> const Face & { return *uptr; };
-    return local_faces_ | std::views::transform(t);
+    return local_faces_ | std::views::all;
   }
   /**
    * @brief Get a range of `(const Face &)` for ghost `Face`s.
@@ -1373,8 +1591,7 @@ class Part {
    * @return std::ranges::input_range the range of `Face`s
    */
   std::ranges::input_range auto GetGhostFaces() const {
-    auto t = [](auto &uptr) -> const Face & { return *uptr; };
-    return ghost_faces_ | std::views::transform(t);
+    return ghost_faces_ | std::views::all;
   }
   /**
    * @brief Get a range of `(Face *)` for `Face`s on a given `Section`.
@@ -1384,9 +1601,8 @@ class Part {
    */
   std::ranges::input_range auto
   GetBoundaryFacePointers(std::string const &name) {
-    cgns::ShiftedVector<std::unique_ptr<Face>> &faces
-        = *name_to_faces_.at(name);
-    auto t = [](auto &uptr) -> Face * { return uptr.get(); };
+    std::vector<Face> &faces = *name_to_faces_.at(name);
+    auto t = [](Face &face) -> Face * { return &face; };
     return faces | std::views::transform(t);
   }
   /**
@@ -1408,11 +1624,18 @@ class Part {
    */
   std::ranges::input_range auto
   GetBoundaryFaces() const {
-    auto t = [](auto &uptr) -> const Face & { return *uptr; };
     return bound_faces_
         | std::views::values | std::views::join
-        | std::views::values | std::views::join
-        | std::views::transform(t);
+        | std::views::values | std::views::join;
+  }
+  /**
+   * @brief Get the local nodes of a given zone.
+   * 
+   * @param i_zone the 1-based index of the zone
+   * @return Coordinates const & the coordinates of local nodes
+   */
+  Coordinates const &GetLocalNodes(Int i_zone) const {
+    return local_nodes_.at(i_zone);
   }
 
  private:
@@ -1434,26 +1657,30 @@ class Part {
       cell_data_;  // [i_cell] -> global i_dof of the Cell's 0th local i_dof
   std::map<Int, std::vector<Cell *>>
       send_cell_ptrs_, recv_cell_ptrs_;  // [i_part] -> vector<Cell *>
-  std::vector<std::vector<Scalar>>
-      send_coeffs_, recv_coeffs_;
-  std::unordered_map<Int, Cell>
-      ghost_cells_;  // [m_cell] -> a Cell obj
+  Halo coeff_halo_;
+  std::map<Int, std::vector<Face *>>
+      ghost_face_ptrs_;  // [i_part] -> vector<Face *>
+  std::vector<Cell>
+      ghost_cells_;  // [i_cell - CountLocalCells()] -> a Cell obj
+  std::unordered_map<Int, Int>
+      m_to_ghost_cell_;  // [m_cell] -> index in `ghost_cells_`
   std::vector<std::pair<Int, Int>>
       local_adjs_;  // [i_pair] -> { m_holder, m_sharer }
-  std::vector<std::unique_ptr<Face>>
-      local_faces_, ghost_faces_;  // [i_face] -> a uptr of Face
-  std::map<Int, std::map<Int, cgns::ShiftedVector<std::unique_ptr<Face>>>>
-      bound_faces_;  // [i_zone][i_sect][i_face] -> a uptr of Face
-  std::unordered_map<std::string, cgns::ShiftedVector<std::unique_ptr<Face>> *>
+  std::vector<Face>
+      local_faces_, ghost_faces_;  // [i_face] -> a Face obj
+  std::map<Int, std::map<Int, std::vector<Face>>>
+      bound_faces_;  // [i_zone][i_sect][i_face - head] -> a Face obj
+  std::unordered_map<std::string, std::vector<Face> *>
       name_to_faces_;
-  std::vector<MPI_Request> requests_;
   std::array<std::string, kComponents> field_names_;
   const std::string directory_;
   const std::string cgns_file_;
+  std::string grid_file_;  // empty if each solution file holds the grid
+  MPI_Comm comm_;
   int rank_, size_, cell_dim_, phys_dim_;
   char base_name_[33];
 
-  void BuildBoundaryFaces(std::ifstream &istrm, int i_file) {
+  void BuildBoundaryFaces(partition::Info const &info, int i_file) {
     // build a map from (i_zone, i_node) to cells using it
     std::unordered_map<Int, std::unordered_map<Int, std::vector<Int>>>
         z_n_to_m_cells;  // [i_zone][i_node] -> vector of `m_cell`s
@@ -1472,15 +1699,16 @@ class Part {
         }
       }
     }
-    char line[kLineWidth];
     Int face_id = local_faces_.size() + ghost_faces_.size();
     // build boundary faces
     std::unordered_map<std::string, std::pair<int, int>>
         name_to_z_s;  // name -> { i_zone, i_sect }
-    while (istrm.getline(line, kLineWidth) && line[0] != '#') {
-      int i_zone, i_sect, head, tail;
-      std::sscanf(line, "%d %d %d %d", &i_zone, &i_sect, &head, &tail);
+    for (Int i = 0, n = info.CountRows(Table::kFaceRanges); i < n; ++i) {
+      auto [i_zone, i_sect, head, tail]
+          = GetColumns<4>(info, Table::kFaceRanges, i);
       auto &faces = bound_faces_[i_zone][i_sect];
+      // reserved in advance, so that pointers to boundary faces never dangle
+      faces.reserve(tail - head);
       cgsize_t range_min[] = { head };
       cgsize_t range_max[] = { tail - 1 };
       cgsize_t mem_dimensions[] = { tail - head };
@@ -1531,16 +1759,15 @@ class Part {
         }
         auto [coordinate_uptr, integrator_uptr]
             = BuildIntegratorForFace(npe, i_zone, face_node_list);
-        auto face_uptr = std::make_unique<Face>(std::move(coordinate_uptr),
+        auto &face = faces.emplace_back(std::move(coordinate_uptr),
             std::move(integrator_uptr), holder_ptr, nullptr, face_id++);
         // the face's normal vector always point from holder to the exterior
-        assert((face_uptr->center() - holder_ptr->center()).dot(
-            face_uptr->integrator().GetNormalFrame(0)[0]) > 0);
-        holder_ptr->boundary_faces_.emplace_back(face_uptr.get());
-        faces.emplace_back(std::move(face_uptr));
+        assert((face.center() - holder_ptr->center()).dot(
+            face.integrator().GetNormalFrame(0)[0]) > 0);
+        holder_ptr->boundary_faces_.emplace_back(&face);
       }
     }
-    // build name to cgns::ShiftedVector of faces
+    // build name to vector of faces
     for (auto &[name, z_s] : name_to_z_s) {
       auto [i_zone, i_sect] = z_s;
       auto &faces = bound_faces_.at(i_zone).at(i_sect);
@@ -1571,7 +1798,7 @@ class Part {
       if (std::system(temp))
         throw std::runtime_error(temp + std::string(" failed."));
     }
-    MPI_Barrier(MPI_COMM_WORLD);
+    MPI_Barrier(comm_);
     std::snprintf(temp, sizeof(temp), "%s/%s/%d.%s",
         directory_.c_str(), soln_name.c_str(), rank_, suffix.c_str());
     return std::ofstream(temp,
@@ -0,0 +1,142 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_MESH_PARTITION_HPP_
+#define MINI_MESH_PARTITION_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <fstream>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace mini {
+namespace mesh {
+
+/**
+ * @brief The binary partition info shared by `Shuffler`, `ParallelShuffler` and `part::Part`.
+ *
+ */
+namespace partition {
+
+/**
+ * @brief The tables in a partition info file, in the order of being read by `part::Part`.
+ *
+ */
+enum Table : int {
+  kNodeRanges,  // i_zone i_node_head i_node_tail
+  kSendNodes,  // i_part i_node_metis
+  kRecvNodes,  // i_part i_node_metis i_zone i_node
+  kCellRanges,  // i_zone i_sect i_cell_head i_cell_tail
+  kInnerAdjacency,  // i_cell_metis j_cell_metis
+  kInterpartAdjacency,  // i_part i_cell_metis j_cell_metis i_node_npe j_node_npe
+  kFaceRanges,  // i_zone i_sect i_face_head i_face_tail
+  kTables
+};
+
+constexpr std::array<std::int64_t, kTables> kColumns{ 3, 2, 4, 4, 2, 5, 4 };
+
+/**
+ * @brief Increased whenever the layout below changes.
+ *
+ * A file begins with `kMagic`, `kVersion` and `kTables`, followed by `(n_columns, n_rows)` of each table, followed by all rows of all tables.
+ * All numbers are stored as native-endian `int64_t`s, so each table can be loaded by a single read.
+ */
+constexpr std::int64_t kVersion = 1;
+constexpr char kMagic[8] = { 'm', 'i', 'n', 'i', 'P', 'A', 'R', 'T' };
+
+inline std::string GetFileName(std::string const &case_name, int i_part) {
+  return case_name + "/partition/" + std::to_string(i_part) + ".bin";
+}
+
+/**
+ * @brief The partition info of a part, which is a set of tables of integers.
+ *
+ */
+class Info {
+  std::array<std::vector<std::int64_t>, kTables> tables_;
+
+ public:
+  void Append(Table table, std::initializer_list<std::int64_t> row) {
+    assert(row.size() == kColumns[table]);
+    tables_[table].insert(tables_[table].end(), row.begin(), row.end());
+  }
+  std::int64_t CountRows(Table table) const {
+    return tables_[table].size() / kColumns[table];
+  }
+  std::int64_t const *GetRow(Table table, std::int64_t i_row) const {
+    assert(0 <= i_row && i_row < CountRows(table));
+    return tables_[table].data() + i_row * kColumns[table];
+  }
+
+  void Write(std::string const &file_name) const {
+    auto ostrm = std::ofstream(file_name, std::ios::binary);
+    if (!ostrm) {
+      throw std::runtime_error("Cannot open " + file_name);
+    }
+    std::array<std::int64_t, 2 + 2 * kTables> header;
+    header[0] = kVersion;
+    header[1] = kTables;
+    for (int i = 0; i < kTables; ++i) {
+      header[2 + 2 * i] = kColumns[i];
+      header[3 + 2 * i] = CountRows(Table(i));
+    }
+    ostrm.write(kMagic, sizeof(kMagic));
+    ostrm.write(reinterpret_cast<char const *>(header.data()),
+        sizeof(header));
+    for (auto &table : tables_) {
+      ostrm.write(reinterpret_cast<char const *>(table.data()),
+          sizeof(std::int64_t) * table.size());
+    }
+  }
+  static Info Read(std::string const &file_name) {
+    auto istrm = std::ifstream(file_name, std::ios::binary);
+    if (!istrm) {
+      throw std::runtime_error("Cannot open " + file_name);
+    }
+    char magic[sizeof(kMagic)];
+    std::array<std::int64_t, 2 + 2 * kTables> header;
+    istrm.read(magic, sizeof(magic));
+    istrm.read(reinterpret_cast<char *>(header.data()), sizeof(header));
+    if (!istrm || std::memcmp(magic, kMagic, sizeof(kMagic))) {
+      throw std::runtime_error(file_name + " is not a partition info file.");
+    }
+    if (header[0] != kVersion) {
+      throw std::runtime_error(file_name + " has version "
+          + std::to_string(header[0]) + ", but version "
+          + std::to_string(kVersion) + " is expected.");
+    }
+    if (header[1] != kTables) {
+      throw std::runtime_error(file_name + " has "
+          + std::to_string(header[1]) + " tables, but "
+          + std::to_string(kTables) + " tables are expected.");
+    }
+    auto info = Info();
+    for (int i = 0; i < kTables; ++i) {
+      auto n_columns = header[2 + 2 * i], n_rows = header[3 + 2 * i];
+      if (n_columns != kColumns[i] || n_rows < 0) {
+        throw std::runtime_error(file_name + " has a table of "
+            + std::to_string(n_rows) + " rows and "
+            + std::to_string(n_columns) + " columns, but "
+            + std::to_string(kColumns[i]) + " columns are expected.");
+      }
+      auto &table = info.tables_[i];
+      table.resize(kColumns[i] * header[3 + 2 * i]);
+      istrm.read(reinterpret_cast<char *>(table.data()),
+          sizeof(std::int64_t) * table.size());
+    }
+    if (!istrm) {
+      throw std::runtime_error(file_name + " is truncated.");
+    }
+    return info;
+  }
+};
+
+}  // namespace partition
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_PARTITION_HPP_
@@ -20,6 +20,7 @@
 #include "mini/mesh/cgns.hpp"
 #include "mini/mesh/metis.hpp"
 #include "mini/mesh/mapper.hpp"
+#include "mini/mesh/partition.hpp"
 
 namespace mini {
 namespace mesh {
@@ -433,52 +434,44 @@ void Shuffler<Int, Real>::WritePartitionInfo(std::string const &case_name) {
       }
     }
   }
-  /* Write part info to txts: */
+  /* Write part info to binary files: */
+  using partition::Table;
   for (int p = 0; p < n_parts_; ++p) {
-    auto ostrm = std::ofstream(case_name + "/partition/" + std::to_string(p)
-        + ".txt"/*, std::ios::binary */);
+    auto info = partition::Info();
     // node ranges
-    ostrm << "# i_zone i_node_head i_node_tail\n";
     for (int z = 1; z <= n_zones; ++z) {
       auto [head, tail] = part_to_nodes[p][z];
-      if (true) {
-        ostrm << z << ' ' << head << ' ' << tail << '\n';
-      }
+      info.Append(Table::kNodeRanges, { z, head, tail });
     }
     // send nodes info
-    ostrm << "# i_part i_node_metis\n";
     for (auto &[recv_pid, nodes] : sendp_recvp_nodes[p]) {
       for (auto i : nodes) {
-        ostrm << recv_pid << ' ' << i << '\n';
+        info.Append(Table::kSendNodes, { recv_pid, i });
       }
     }
     // adjacent nodes
-    ostrm << "# i_part i_node_metis i_zone i_node\n";
     for (auto &[i_part, nodes] : part_adj_nodes[p]) {
       for (auto mid : nodes) {
-        auto &info = mapper_->metis_to_cgns_for_nodes[mid];
-        int zid = info.i_zone, nid = info.i_node;
-        ostrm << i_part << ' ' << mid << ' ' << zid << ' ' << nid << '\n';
+        auto &info_m = mapper_->metis_to_cgns_for_nodes[mid];
+        int zid = info_m.i_zone, nid = info_m.i_node;
+        info.Append(Table::kRecvNodes, { i_part, mid, zid, nid });
       }
     }
     // cell ranges
-    ostrm << "# i_zone i_sect i_cell_head i_cell_tail\n";
     for (int z = 1; z <= n_zones; ++z) {
       auto n_sects = part_to_cells[p][z].size() - 1;
       for (int s = 1; s <= n_sects; ++s) {
         auto [head, tail] = part_to_cells[p][z][s];
         if (base.GetZone(z).GetSection(s).dim() == base.GetCellDim()) {
-          ostrm << z << ' ' << s << ' ' << head << ' ' << tail << '\n';
+          info.Append(Table::kCellRanges, { z, s, head, tail });
         }
       }
     }
     // inner adjacency
-    ostrm << "# i_cell_metis j_cell_metis\n";
     for (auto [i, j] : inner_adjs[p]) {
-      ostrm << i << ' ' << j << '\n';
+      info.Append(Table::kInnerAdjacency, { i, j });
     }
     // interpart adjacency
-    ostrm << "# i_part i_cell_metis j_cell_metis i_node_npe j_node_npe\n";
     for (auto &[i_part, pairs] : part_interpart_adjs[p]) {
       for (auto [i, j] : pairs) {
         auto &info_i = mapper_->metis_to_cgns_for_cells[i];
@@ -487,22 +480,20 @@ void Shuffler<Int, Real>::WritePartitionInfo(std::string const &case_name) {
             CountNodesByType();
         int npe_j = base.GetZone(info_j.i_zone).GetSection(info_j.i_sect).
             CountNodesByType();
-        ostrm << i_part << ' ' << i << ' ' << j << ' ' << npe_i << ' ' <<
-            npe_j << '\n';
+        info.Append(Table::kInterpartAdjacency, { i_part, i, j, npe_i, npe_j });
       }
     }
     // face ranges
-    ostrm << "# i_zone i_sect i_face_head i_face_tail\n";
     for (int z = 1; z <= n_zones; ++z) {
       auto n_sects = part_to_faces[p][z].size() - 1;
       for (int s = 1; s <= n_sects; ++s) {
         auto [head, tail] = part_to_faces[p][z][s];
         if (base.GetZone(z).GetSection(s).dim() + 1 == base.GetCellDim()) {
-          ostrm << z << ' ' << s << ' ' << head << ' ' << tail << '\n';
+          info.Append(Table::kFaceRanges, { z, s, head, tail });
         }
       }
     }
-    ostrm << "#\n";
+    info.Write(partition::GetFileName(case_name, p));
   }
 }
 
@@ -2,14 +2,30 @@
 #ifndef MINI_MESH_VTK_HPP_
 #define MINI_MESH_VTK_HPP_
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <bit>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+#ifdef ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "mini/mesh/async_writer.hpp"
+
 namespace mini {
 namespace mesh {
 namespace vtk {
@@ -120,6 +136,169 @@ void DecodeBase64(std::string const &input, std::size_t n_byte,
   }
 }
 
+/**
+ * @brief Encodings of `DataArray`s in vtu files.
+ * 
+ */
+enum class Encoding {
+  kAscii,  // inline text, except that `Points` are inline base64
+  kRaw,  // raw bytes in the `AppendedData` section
+  kZlib,  // zlib-compressed raw bytes in the `AppendedData` section
+};
+
+/**
+ * @brief Precisions of floating-point `DataArray`s in vtu files.
+ * 
+ */
+enum class Precision {
+  kFloat64,
+  kFloat32,
+};
+
+/**
+ * @brief The number of uncompressed bytes in each zlib-compressed block, which is the default value used by VTK.
+ * 
+ */
+constexpr std::size_t kBlockSize = 1 << 15;
+
+/**
+ * @brief Append a given array of bytes to the `AppendedData` section.
+ * 
+ * The bytes are headed by their size, which is stored as a `UInt64`.
+ * 
+ * @param data the address of the 0th byte
+ * @param n_byte the number of bytes
+ * @param appended the `AppendedData` section
+ */
+inline void AppendRaw(Byte const *data, std::size_t n_byte,
+    std::string *appended) {
+  uint64_t header = n_byte;
+  appended->append(reinterpret_cast<Byte const *>(&header), sizeof(header));
+  appended->append(data, n_byte);
+}
+
+#ifdef ENABLE_ZLIB
+/**
+ * @brief Compress a given array of bytes block by block, then append them to the `AppendedData` section.
+ * 
+ * The compressed blocks are headed by `[n_blocks][block_size][last_block_size][compressed_size_1]...[compressed_size_n]`, each of which is stored as a `UInt64`, and `last_block_size` is 0 if the last block is full.
+ * 
+ * @param data the address of the 0th byte
+ * @param n_byte the number of bytes
+ * @param appended the `AppendedData` section
+ */
+inline void AppendZlib(Byte const *data, std::size_t n_byte,
+    std::string *appended) {
+  uint64_t n_blocks = n_byte / kBlockSize + (n_byte % kBlockSize != 0);
+  auto header = std::vector<uint64_t>(3 + n_blocks);
+  header[0] = n_blocks;
+  header[1] = kBlockSize;
+  header[2] = n_byte % kBlockSize;
+  auto compressed = std::string();
+  for (uint64_t i_block = 0; i_block < n_blocks; ++i_block) {
+    auto i_byte = i_block * kBlockSize;
+    uLong n_byte_in = std::min(kBlockSize, n_byte - i_byte);
+    uLongf n_byte_out = compressBound(n_byte_in);
+    auto offset = compressed.size();
+    compressed.resize(offset + n_byte_out);
+    auto error_code = compress(
+        reinterpret_cast<Bytef *>(compressed.data() + offset), &n_byte_out,
+        reinterpret_cast<Bytef const *>(data + i_byte), n_byte_in);
+    if (error_code != Z_OK) {
+      throw std::runtime_error("zlib's compress() failed.");
+    }
+    compressed.resize(offset + n_byte_out);
+    header[3 + i_block] = n_byte_out;
+  }
+  appended->append(reinterpret_cast<Byte const *>(header.data()),
+      sizeof(uint64_t) * header.size());
+  appended->append(compressed);
+}
+#endif
+
+/**
+ * @brief Merge the nodes whose coordinates are equal up to a given tolerance.
+ * 
+ * Nodes are hashed into bins of width `tolerance`, and each node is compared with the merged nodes in its own bin and the 26 neighboring ones, so that close nodes on different sides of a bin boundary are also merged.
+ * The values on the merged nodes are averaged, which only makes sense for continuous fields.
+ * 
+ * @param tolerance nodes whose coordinates differ by no more than it in each direction are merged
+ * @param coords the coordinates of the nodes
+ * @param values the conservative variables on the nodes
+ * @param point_data the extra fields on the nodes
+ * @param connectivity the node indices of the cells, which are updated in place
+ */
+template <typename Coord, typename Value, typename Scalar>
+void MergeNodes(Scalar tolerance, std::vector<Coord> *coords,
+    std::vector<Value> *values,
+    std::vector<std::vector<Scalar>> *point_data,
+    std::vector<int32_t> *connectivity) {
+  using Key = std::array<int64_t, 3>;
+  auto key_to_nodes = std::map<Key, std::vector<int32_t>>();
+  auto merged_coords = std::vector<Coord>();
+  auto merged_values = std::vector<Value>();
+  auto merged_point_data = std::vector<std::vector<Scalar>>(
+      point_data->size());
+  auto n_merged = std::vector<int>();
+  auto find = [&](Key const &key, Coord const &coord) -> int32_t {
+    for (int64_t i = key[0] - 1; i <= key[0] + 1; ++i) {
+      for (int64_t j = key[1] - 1; j <= key[1] + 1; ++j) {
+        for (int64_t k = key[2] - 1; k <= key[2] + 1; ++k) {
+          auto iter = key_to_nodes.find({ i, j, k });
+          if (iter == key_to_nodes.end()) {
+            continue;
+          }
+          for (int32_t i_new : iter->second) {
+            auto const &merged = merged_coords[i_new];
+            bool close = true;
+            for (int d = 0; d < 3; ++d) {
+              close = close && std::abs(merged[d] - coord[d]) <= tolerance;
+            }
+            if (close) {
+              return i_new;
+            }
+          }
+        }
+      }
+    }
+    return -1;
+  };
+  for (int32_t i_old = 0, n_old = coords->size(); i_old < n_old; ++i_old) {
+    Coord const &coord = coords->at(i_old);
+    Key key;
+    for (int d = 0; d < 3; ++d) {
+      key[d] = std::floor(coord[d] / tolerance);
+    }
+    auto i_new = find(key, coord);
+    if (i_new < 0) {
+      i_new = n_merged.size();
+      key_to_nodes[key].emplace_back(i_new);
+      merged_coords.emplace_back(coord);
+      merged_values.emplace_back(values->at(i_old));
+      for (int k = 0, K = point_data->size(); k < K; ++k) {
+        merged_point_data[k].emplace_back(point_data->at(k).at(i_old));
+      }
+      n_merged.emplace_back(1);
+    } else {
+      merged_values[i_new] += values->at(i_old);
+      for (int k = 0, K = point_data->size(); k < K; ++k) {
+        merged_point_data[k][i_new] += point_data->at(k).at(i_old);
+      }
+      n_merged[i_new]++;
+    }
+    connectivity->at(i_old) = i_new;
+  }
+  for (int i_new = 0, n_new = n_merged.size(); i_new < n_new; ++i_new) {
+    merged_values[i_new] /= n_merged[i_new];
+    for (auto &data : merged_point_data) {
+      data[i_new] /= n_merged[i_new];
+    }
+  }
+  std::swap(*coords, merged_coords);
+  std::swap(*values, merged_values);
+  std::swap(*point_data, merged_point_data);
+}
+
 /**
  * @brief Mimic VTK's cell types.
  * 
@@ -397,6 +576,9 @@ class Writer {
   static std::vector<PointData> point_data_name_and_func_;
   static std::vector<CellData> cell_data_name_and_func_;
   static ShiftByValue shift_by_value_;
+  static std::unordered_map<std::string, Precision> precisions_;
+  static Encoding encoding_;
+  static Scalar merge_tolerance_;
 
   static CellType GetCellType(int n_corners) {
     CellType cell_type;
@@ -493,11 +675,176 @@ class Writer {
     }
   }
 
+  /**
+   * @brief A copy of the static settings, which is taken on the calling thread, so that background tasks never read the static members.
+   *
+   */
+  struct Settings {
+    std::unordered_map<std::string, Precision> precisions;
+    std::vector<std::string> point_data_names, cell_data_names;
+    Encoding encoding;
+    Scalar merge_tolerance;
+
+    Precision GetPrecision(std::string const &name) const {
+      auto iter = precisions.find(name);
+      return iter == precisions.end() ? Precision::kFloat64 : iter->second;
+    }
+
+    char const *GetFloatTypeName(std::string const &name) const {
+      return GetPrecision(name) == Precision::kFloat32 ? "Float32" : "Float64";
+    }
+  };
+
+  static Settings GetSettings() {
+    auto settings = Settings{ precisions_, {}, {}, encoding_,
+        merge_tolerance_ };
+    for (auto &[name, _] : point_data_name_and_func_) {
+      settings.point_data_names.emplace_back(name);
+    }
+    for (auto &[name, _] : cell_data_name_and_func_) {
+      settings.cell_data_names.emplace_back(name);
+    }
+    return settings;
+  }
+
+  template <typename T>
+  static char const *GetTypeName() {
+    if constexpr (std::is_same_v<T, double>) {
+      return "Float64";
+    } else if constexpr (std::is_same_v<T, float>) {
+      return "Float32";
+    } else if constexpr (std::is_same_v<T, int32_t>) {
+      return "Int32";
+    } else {
+      static_assert(std::is_same_v<T, uint8_t>);
+      return "UInt8";
+    }
+  }
+
+  /**
+   * @brief Write a `DataArray`, whose values are either inline or in the `AppendedData` section.
+   * 
+   * @tparam T the type of the values
+   * @param settings the settings taken when the data were prepared
+   * @param name the name of the `DataArray`
+   * @param n_components the number of components of each tuple
+   * @param data the values to be written
+   * @param vtu the vtu file
+   * @param appended the `AppendedData` section
+   * @param inline_binary whether to write base64-encoded bytes instead of text for `Encoding::kAscii`
+   */
+  template <typename T>
+  static void WriteDataArray(Settings const &settings,
+      std::string const &name, int n_components, std::vector<T> const &data,
+      std::ofstream &vtu, std::string *appended, bool inline_binary = false) {
+    vtu << "        <DataArray type=\"" << GetTypeName<T>()
+        << "\" Name=\"" << name << "\" ";
+    if (n_components > 1) {
+      vtu << "NumberOfComponents=\"" << n_components << "\" ";
+    }
+    auto *bytes = reinterpret_cast<Byte const *>(data.data());
+    auto n_byte = sizeof(T) * data.size();
+    switch (settings.encoding) {
+    case Encoding::kAscii:
+      if (inline_binary) {
+        vtu << "format=\"binary\">\n";
+        auto encoded = EncodeBase64(bytes, n_byte);
+        auto n_char_encoded = EncodeBase64(
+            reinterpret_cast<Byte const *>(&n_byte), sizeof(n_byte));
+        while (n_char_encoded.size() < 8) {
+          n_char_encoded.push_back('=');
+        }
+        vtu << n_char_encoded;
+        vtu << encoded;
+      } else {
+        vtu << "format=\"ascii\">\n";
+        for (T value : data) {
+          if constexpr (sizeof(T) == 1) {
+            vtu << static_cast<int>(value) << ' ';
+          } else {
+            vtu << value << ' ';
+          }
+        }
+      }
+      vtu << "\n        </DataArray>\n";
+      break;
+    case Encoding::kRaw:
+      vtu << "format=\"appended\" offset=\"" << appended->size() << "\"/>\n";
+      AppendRaw(bytes, n_byte, appended);
+      break;
+    case Encoding::kZlib:
+      vtu << "format=\"appended\" offset=\"" << appended->size() << "\"/>\n";
+#ifdef ENABLE_ZLIB
+      AppendZlib(bytes, n_byte, appended);
+#endif
+      break;
+    default:
+      assert(false);
+      break;
+    }
+  }
+
+  /**
+   * @brief Write a floating-point `DataArray` in the Precision set for its name.
+   * 
+   */
+  static void WriteFloats(Settings const &settings, std::string const &name,
+      int n_components, std::vector<Scalar> const &data, std::ofstream &vtu,
+      std::string *appended, bool inline_binary = false) {
+    if (settings.GetPrecision(name) == Precision::kFloat32) {
+      auto floats = std::vector<float>(data.begin(), data.end());
+      WriteDataArray(settings, name, n_components, floats, vtu, appended,
+          inline_binary);
+    } else if constexpr (std::is_same_v<Scalar, double>) {
+      WriteDataArray(settings, name, n_components, data, vtu, appended,
+          inline_binary);
+    } else {
+      auto doubles = std::vector<double>(data.begin(), data.end());
+      WriteDataArray(settings, name, n_components, doubles, vtu, appended,
+          inline_binary);
+    }
+  }
+
  public:
   static bool LittleEndian() {
     return std::endian::native == std::endian::little;
   }
 
+  /**
+   * @brief Set the Encoding of `DataArray`s in vtu files.
+   * 
+   * @param encoding the Encoding to be used, whose default value is `Encoding::kAscii`
+   */
+  static void SetEncoding(Encoding encoding) {
+#ifndef ENABLE_ZLIB
+    if (encoding == Encoding::kZlib) {
+      throw std::invalid_argument("Encoding::kZlib requires ENABLE_ZLIB.");
+    }
+#endif
+    encoding_ = encoding;
+  }
+
+  /**
+   * @brief Set the Precision of a floating-point field (including `Points`).
+   * 
+   * @param name the name of the field
+   * @param precision the Precision to be used, whose default value is `Precision::kFloat64`
+   */
+  static void SetPrecision(std::string const &name, Precision precision) {
+    precisions_[name] = precision;
+  }
+
+  /**
+   * @brief Merge nodes shared by neighboring cells before writing.
+   * 
+   * Values on merged nodes are averaged, so this only suits continuous fields.
+   * 
+   * @param tolerance nodes whose coordinates are equal up to it are merged, non-positive values disable merging
+   */
+  static void SetMergeTolerance(Scalar tolerance) {
+    merge_tolerance_ = tolerance;
+  }
+
   /**
    * @brief Add an extra field other than the conservative variables carried by points.
    * 
@@ -525,23 +872,38 @@ class Writer {
   /**
    * @brief Write the solution carried by a given Part to a pvtu file with a given name.
    * 
+   * If `writer` is given, only the data on cells are evaluated before returning, and merging, encoding and writing are done in the background.
+   * 
    * @param part 
    * @param soln_name 
+   * @param writer 
    */
-  static void WriteSolutions(const Part &part, std::string const &soln_name) {
+  static void WriteSolutions(const Part &part, std::string const &soln_name,
+      AsyncWriter *writer = nullptr) {
     std::string endianness
         = LittleEndian() ? "\"LittleEndian\"" : "\"BigEndian\"";
     // prepare data to be written
-    auto types = std::vector<CellType>();
-    auto coords = std::vector<Coord>();
-    auto values = std::vector<Value>();
-    auto point_data = std::vector<std::vector<Scalar>>();
+    struct Snapshot {
+      std::vector<CellType> types;
+      std::vector<Coord> coords;
+      std::vector<Value> values;
+      std::vector<std::vector<Scalar>> point_data, cell_data;
+      std::array<std::string, Cell::K> field_names;
+      Settings settings;
+      std::ofstream vtu;
+    };
+    auto snapshot = std::make_shared<Snapshot>();
+    auto &[types, coords, values, point_data, cell_data, field_names,
+        settings, _] = *snapshot;
+    settings = GetSettings();
     point_data.resize(point_data_name_and_func_.size());
-    auto cell_data = std::vector<std::vector<Scalar>>();
     cell_data.resize(cell_data_name_and_func_.size());
     for (const Cell &cell : part.GetLocalCells()) {
       Prepare(cell, &types, &coords, &values, &point_data, &cell_data);
     }
+    for (int k = 0; k < Cell::K; ++k) {
+      field_names[k] = part.GetFieldName(k);
+    }
     // create the pvtu file (which refers to vtu files created by rank[0] and other ranks) by rank[0]
     if (part.mpi_rank() == 0) {
       char temp[1024];
@@ -553,23 +915,24 @@ class Writer {
       pvtu << "  <PUnstructuredGrid GhostLevel=\"1\">\n";
       pvtu << "    <PPointData>\n";
       for (int k = 0; k < Part::kComponents; ++k) {
-        pvtu << "      <PDataArray type=\"Float64\" Name=\""
-            << part.GetFieldName(k) << "\"/>\n";
+        auto const &name = part.GetFieldName(k);
+        pvtu << "      <PDataArray type=\"" << settings.GetFloatTypeName(name)
+            << "\" Name=\"" << name << "\"/>\n";
       }
-      for (auto &[name, _] : point_data_name_and_func_) {
-        pvtu << "      <PDataArray type=\"Float64\" Name=\""
-            << name << "\"/>\n";
+      for (auto &name : settings.point_data_names) {
+        pvtu << "      <PDataArray type=\"" << settings.GetFloatTypeName(name)
+            << "\" Name=\"" << name << "\"/>\n";
       }
       pvtu << "    </PPointData>\n";
       pvtu << "    <PCellData>\n";
-      for (auto &[name, _] : cell_data_name_and_func_) {
-        pvtu << "      <PDataArray type=\"Float64\" Name=\""
-            << name << "\"/>\n";
+      for (auto &name : settings.cell_data_names) {
+        pvtu << "      <PDataArray type=\"" << settings.GetFloatTypeName(name)
+            << "\" Name=\"" << name << "\"/>\n";
       }
       pvtu << "    </PCellData>\n";
       pvtu << "    <PPoints>\n";
-      pvtu << "      <PDataArray type=\"Float64\" Name=\"Points\" "
-          << "NumberOfComponents=\"3\"/>\n";
+      pvtu << "      <PDataArray type=\"" << settings.GetFloatTypeName("Points")
+          << "\" Name=\"Points\" NumberOfComponents=\"3\"/>\n";
       pvtu << "    </PPoints>\n";
       for (int i_part = 0; i_part < part.mpi_size(); ++i_part) {
         pvtu << "    <Piece Source=\"./" << soln_name << '/'
@@ -579,91 +942,96 @@ class Writer {
       pvtu << "</VTKFile>\n";
     }
     // create the vtu file by each rank
-    bool binary = false;
-    auto format = binary ? "\"binary\"" : "\"ascii\"";
-    auto vtu = part.GetFileStream(soln_name, binary, "vtu");
+    bool binary = (settings.encoding != Encoding::kAscii);
+    snapshot->vtu = part.GetFileStream(soln_name, binary, "vtu");
+    if (writer) {
+      writer->Push([snapshot, endianness](MPI_Comm) {
+        WriteVtu(snapshot.get(), endianness);
+      });
+    } else {
+      WriteVtu(snapshot.get(), endianness);
+    }
+  }
+
+ private:
+  template <class Snapshot>
+  static void WriteVtu(Snapshot *snapshot, std::string const &endianness) {
+    auto &[types, coords, values, point_data, cell_data, field_names,
+        settings, vtu] = *snapshot;
+    auto connectivity = std::vector<int32_t>(coords.size());
+    std::iota(connectivity.begin(), connectivity.end(), 0);
+    if (settings.merge_tolerance > 0) {
+      MergeNodes(settings.merge_tolerance, &coords, &values, &point_data,
+          &connectivity);
+    }
+    bool binary = (settings.encoding != Encoding::kAscii);
+    auto appended = std::string();
     vtu << "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\""
-        << " byte_order=" << endianness << " header_type=\"UInt64\">\n";
+        << " byte_order=" << endianness << " header_type=\"UInt64\"";
+    if (settings.encoding == Encoding::kZlib) {
+      vtu << " compressor=\"vtkZLibDataCompressor\"";
+    }
+    vtu << ">\n";
     vtu << "  <UnstructuredGrid>\n";
     vtu << "    <Piece NumberOfPoints=\"" << coords.size()
         << "\" NumberOfCells=\"" << types.size() << "\">\n";
     vtu << "      <PointData>\n";
     // Write the value of conservative variables carried by each Cell:
+    auto scalars = std::vector<Scalar>(values.size());
     for (int k = 0; k < Cell::K; ++k) {
-      vtu << "        <DataArray type=\"Float64\" Name=\""
-          << part.GetFieldName(k) << "\" format=" << format << ">\n";
-      for (Value const &value : values) {
-        vtu << value[k] << ' ';
+      for (int i = 0, n = values.size(); i < n; ++i) {
+        scalars[i] = values[i][k];
       }
-      vtu << "\n        </DataArray>\n";
+      WriteFloats(settings, field_names[k], 1, scalars, vtu, &appended);
     }
     // Write the value of extra fields on points:
-    for (int k = 0; k < point_data_name_and_func_.size(); ++k) {
-      auto &[name, _] = point_data_name_and_func_.at(k);
-      vtu << "        <DataArray type=\"Float64\" Name=\""
-          << name << "\" format=" << format << ">\n";
-      for (Scalar value : point_data.at(k)) {
-        vtu << value << ' ';
-      }
-      vtu << "\n        </DataArray>\n";
+    for (int k = 0; k < settings.point_data_names.size(); ++k) {
+      auto &name = settings.point_data_names.at(k);
+      WriteFloats(settings, name, 1, point_data.at(k), vtu, &appended);
     }
     vtu << "      </PointData>\n";
     vtu << "      <CellData>\n";
     // Write the value of extra fields on cells:
-    for (int k = 0; k < cell_data_name_and_func_.size(); ++k) {
-      auto &[name, _] = cell_data_name_and_func_.at(k);
-      vtu << "        <DataArray type=\"Float64\" Name=\""
-          << name << "\" format=" << format << ">\n";
-      for (Scalar value : cell_data.at(k)) {
-        vtu << value << ' ';
-      }
-      vtu << "\n        </DataArray>\n";
+    for (int k = 0; k < settings.cell_data_names.size(); ++k) {
+      auto &name = settings.cell_data_names.at(k);
+      WriteFloats(settings, name, 1, cell_data.at(k), vtu, &appended);
     }
     vtu << "      </CellData>\n";
     vtu << "      <Points>\n";
-    vtu << "        <DataArray type=\"Float64\" Name=\"Points\" "
-        << "NumberOfComponents=\"3\" format=" << "\"binary\"" << ">\n";
-    // for (auto &xyz : coords) {
-    //   for (auto v : xyz) {
-    //     vtu << v << ' ';
-    //   }
-    // }
     static_assert(sizeof(Coord) == sizeof(Scalar) * 3);
     {
-      auto [encoded, n_char] = EncodeBase64(coords.begin(), coords.end());
-      auto [n_char_encoded, _] = EncodeBase64(&n_char, (&n_char) + 1);
-      while (n_char_encoded.size() < 8) {
-        n_char_encoded.push_back('=');
-      }
-      vtu << n_char_encoded;
-      vtu << encoded;
+      auto *xyz = reinterpret_cast<Scalar const *>(coords.data());
+      scalars.assign(xyz, xyz + 3 * coords.size());
+      // keep full precision of coordinates even in ascii files
+      WriteFloats(settings, "Points", 3, scalars, vtu, &appended, true);
     }
-    vtu << "\n        </DataArray>\n";
     vtu << "      </Points>\n";
     vtu << "      <Cells>\n";
-    vtu << "        <DataArray type=\"Int32\" Name=\"connectivity\" "
-        << "format=\"ascii\">\n";
-    for (int i_node = 0; i_node < coords.size(); ++i_node) {
-      vtu << i_node << ' ';
-    }
-    vtu << "\n        </DataArray>\n";
-    vtu << "        <DataArray type=\"Int32\" Name=\"offsets\" "
-        << "format=" << format << ">\n";
+    WriteDataArray(settings, "connectivity", 1, connectivity, vtu,
+        &appended);
+    auto offsets = std::vector<int32_t>();
+    offsets.reserve(types.size());
     int offset = 0;
     for (auto type : types) {
       offset += CountNodes(type);
-      vtu << offset << ' ';
+      offsets.emplace_back(offset);
     }
-    vtu << "\n        </DataArray>\n";
-    vtu << "        <DataArray type=\"UInt8\" Name=\"types\" "
-        << "format=" << format << ">\n";
+    WriteDataArray(settings, "offsets", 1, offsets, vtu, &appended);
+    auto type_ids = std::vector<uint8_t>();
+    type_ids.reserve(types.size());
     for (auto type : types) {
-      vtu << static_cast<int>(type) << ' ';
+      type_ids.emplace_back(static_cast<uint8_t>(type));
     }
-    vtu << "\n        </DataArray>\n";
+    WriteDataArray(settings, "types", 1, type_ids, vtu, &appended);
     vtu << "      </Cells>\n";
     vtu << "    </Piece>\n";
     vtu << "  </UnstructuredGrid>\n";
+    if (binary) {
+      vtu << "  <AppendedData encoding=\"raw\">\n";
+      vtu << "   _";
+      vtu.write(appended.data(), appended.size());
+      vtu << "\n  </AppendedData>\n";
+    }
     vtu << "</VTKFile>\n";
   }
 };
@@ -680,6 +1048,17 @@ template <typename Part>
 typename Writer<Part>:: ShiftByValue
 Writer<Part>::shift_by_value_;
 
+template <typename Part>
+std::unordered_map<std::string, Precision>
+Writer<Part>::precisions_;
+
+template <typename Part>
+Encoding Writer<Part>::encoding_ = Encoding::kAscii;
+
+template <typename Part>
+typename Writer<Part>::Scalar
+Writer<Part>::merge_tolerance_ = 0;
+
 }  // namespace vtk
 }  // namespace mesh
 }  // namespace mini
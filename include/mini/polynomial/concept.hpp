@@ -5,6 +5,10 @@
 #include <concepts>
 #include <type_traits>
 
+#include <array>
+
+#include "mini/algebra/eigen.hpp"
+
 namespace mini {
 namespace polynomial {
 
@@ -69,6 +73,21 @@ concept Nodal = requires(P const &cp, P *p) {
   { p->SetValue(0, typename P::Value()) } -> std::same_as<void>;
 };
 
+/**
+ * @brief A Nodal expansion whose nodes are tensor products of 1D nodes, so that its flux divergence can be applied line by line.
+ * 
+ */
+template <typename P>
+concept TensorProduct = requires(typename P::Scalar *residual,
+    std::array<algebra::Matrix<typename P::Scalar, P::K, P::D>, P::N> const
+        &local_fluxes) {
+  requires Nodal<P>;
+
+  { P::MinusFluxDivergence(local_fluxes, residual) } -> std::same_as<void>;
+  { P::AddFluxDotBasisGradients(local_fluxes, residual) }
+      -> std::same_as<void>;
+};
+
 }  // namespace polynomial
 }  // namespace mini
 
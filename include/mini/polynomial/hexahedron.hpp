@@ -8,6 +8,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <array>
 #include <iostream>
 #include <tuple>
 #include <type_traits>
@@ -168,6 +169,20 @@ class Hexahedron : public Expansion<kComponents,
     return hessians;
   }
 
+  /* line_x_derivatives_(i, a) := derivative of the a-th Lagrange basis in the 1st dimension at the i-th node */
+  static const typename Basis::LineX::Matrix line_x_derivatives_;
+  static const typename Basis::LineY::Matrix line_y_derivatives_;
+  static const typename Basis::LineZ::Matrix line_z_derivatives_;
+  template <class Line, class LineIntegrator>
+  static typename Line::Matrix BuildLineDerivatives() {
+    auto line = Line{ LineIntegrator::BuildPoints() };
+    typename Line::Matrix derivatives;
+    for (int i = 0; i < Line::N; ++i) {
+      derivatives.row(i) = line.GetDerivatives(1, i);
+    }
+    return derivatives;
+  }
+
  private:
   void InitializeJacobian() requires(kLocal) {
     for (int ijk = 0; ijk < N; ++ijk) {
@@ -610,6 +625,74 @@ class Hexahedron : public Expansion<kComponents,
     return local_flux;
   }
 
+  /**
+   * @brief Subtract the divergence of a local flux field, which is given at all nodes, from the residual.
+   * 
+   * Since \f$ \partial_{\xi} L_{a,b,c}(\xi_i, \eta_j, \zeta_k) = L_a'(\xi_i)\,\delta_{b,j}\,\delta_{c,k} \f$, the divergence is applied line by line (sum factorization), which costs \f$ O(P^4) \f$ rather than \f$ O(P^6) \f$ operations.
+   * 
+   * @tparam FluxMatrix a matrix type which has 3 columns
+   * @param local_fluxes the local fluxes returned by `Hexahedron::GlobalFluxToLocalFlux`
+   * @param residual the beginning of all dofs
+   */
+  template <class FluxMatrix>
+  static void MinusFluxDivergence(std::array<FluxMatrix, N> const &local_fluxes,
+      Scalar *residual) {
+    for (int i = 0; i < Gx::Q; ++i) {
+      for (int j = 0; j < Gy::Q; ++j) {
+        for (int k = 0; k < Gz::Q; ++k) {
+          Value value = Value::Zero();
+          for (int a = 0; a < Gx::Q; ++a) {
+            value += line_x_derivatives_(i, a)
+                * local_fluxes[Basis::index(a, j, k)].col(X);
+          }
+          for (int b = 0; b < Gy::Q; ++b) {
+            value += line_y_derivatives_(j, b)
+                * local_fluxes[Basis::index(i, b, k)].col(Y);
+          }
+          for (int c = 0; c < Gz::Q; ++c) {
+            value += line_z_derivatives_(k, c)
+                * local_fluxes[Basis::index(i, j, c)].col(Z);
+          }
+          MinusValue(value, residual, Basis::index(i, j, k));
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Add \f$ \sum_{q} F_q \begin{bmatrix}\partial_{\xi}\\ \partial_{\eta}\\ \partial_{\zeta} \end{bmatrix} L_{a,b,c}(\xi_q, \eta_q, \zeta_q) \f$ to the residual of each basis.
+   * 
+   * It is the transpose of `Hexahedron::MinusFluxDivergence`, which is also applied line by line.
+   * 
+   * @tparam FluxMatrix a matrix type which has 3 columns
+   * @param local_fluxes the weighted local fluxes at all nodes
+   * @param residual the beginning of all dofs
+   */
+  template <class FluxMatrix>
+  static void AddFluxDotBasisGradients(
+      std::array<FluxMatrix, N> const &local_fluxes, Scalar *residual) {
+    for (int a = 0; a < Gx::Q; ++a) {
+      for (int b = 0; b < Gy::Q; ++b) {
+        for (int c = 0; c < Gz::Q; ++c) {
+          Value value = Value::Zero();
+          for (int i = 0; i < Gx::Q; ++i) {
+            value += line_x_derivatives_(i, a)
+                * local_fluxes[Basis::index(i, b, c)].col(X);
+          }
+          for (int j = 0; j < Gy::Q; ++j) {
+            value += line_y_derivatives_(j, b)
+                * local_fluxes[Basis::index(a, j, c)].col(Y);
+          }
+          for (int k = 0; k < Gz::Q; ++k) {
+            value += line_z_derivatives_(k, c)
+                * local_fluxes[Basis::index(a, b, k)].col(Z);
+          }
+          AddValueTo(value, residual, Basis::index(a, b, c));
+        }
+      }
+    }
+  }
+
   /**
    * @brief Get the associated matrix of the Jacobian at a given integratorian point.
    * 
@@ -1046,6 +1129,24 @@ std::array<typename Hexahedron<Gx, Gy, Gz, kC, kL>::Mat6xN,
 Hexahedron<Gx, Gy, Gz, kC, kL>::basis_local_hessians_ =
     Hexahedron<Gx, Gy, Gz, kC, kL>::BuildBasisLocalHessians();
 
+template <class Gx, class Gy, class Gz, int kC, bool kL>
+typename Hexahedron<Gx, Gy, Gz, kC, kL>::Basis::LineX::Matrix const
+Hexahedron<Gx, Gy, Gz, kC, kL>::line_x_derivatives_ =
+    Hexahedron<Gx, Gy, Gz, kC, kL>::BuildLineDerivatives<
+        typename Hexahedron<Gx, Gy, Gz, kC, kL>::Basis::LineX, Gx>();
+
+template <class Gx, class Gy, class Gz, int kC, bool kL>
+typename Hexahedron<Gx, Gy, Gz, kC, kL>::Basis::LineY::Matrix const
+Hexahedron<Gx, Gy, Gz, kC, kL>::line_y_derivatives_ =
+    Hexahedron<Gx, Gy, Gz, kC, kL>::BuildLineDerivatives<
+        typename Hexahedron<Gx, Gy, Gz, kC, kL>::Basis::LineY, Gy>();
+
+template <class Gx, class Gy, class Gz, int kC, bool kL>
+typename Hexahedron<Gx, Gy, Gz, kC, kL>::Basis::LineZ::Matrix const
+Hexahedron<Gx, Gy, Gz, kC, kL>::line_z_derivatives_ =
+    Hexahedron<Gx, Gy, Gz, kC, kL>::BuildLineDerivatives<
+        typename Hexahedron<Gx, Gy, Gz, kC, kL>::Basis::LineZ, Gz>();
+
 namespace {
 
 template <class Hexahedron>
@@ -0,0 +1,50 @@
+//  Copyright 2024 PEI Weicheng
+#ifndef MINI_POLYNOMIAL_TRANSFER_HPP_
+#define MINI_POLYNOMIAL_TRANSFER_HPP_
+
+#include <concepts>
+#include <type_traits>
+
+#include "mini/polynomial/concept.hpp"
+
+namespace mini {
+namespace polynomial {
+
+/**
+ * @brief Approximate a polynomial by another one defined on the same element, which might be of different degrees or on a different basis.
+ *
+ * If the target interpolates on its own quadrature points and the source can be evaluated at `Local` points, the values are taken at the local coordinates of the target's nodes, which avoids calling `Coordinate::GlobalToLocal`.
+ * Otherwise, the target's `Approximate` is called, so it is an interpolation for nodal targets and an \f$ L_2 \f$ projection for modal ones.
+ * In both cases, restricting a polynomial to a lower degree and prolonging it back is exact for polynomials of the lower degree.
+ *
+ * @tparam From the type of the source polynomial
+ * @tparam To the type of the target polynomial
+ * @param from the source polynomial
+ * @param to the target polynomial, whose integrator must be built on the same element as the source's
+ */
+template <General From, General To>
+  requires std::same_as<typename From::Value, typename To::Value>
+void Transfer(From const &from, To *to) {
+  using Global = typename From::Global;
+  constexpr bool kNodal = requires(To const &t, typename To::Value v) {
+    to->SetValue(0, v);
+    { from.LocalToValue(t.integrator().GetLocal(0)) }
+        -> std::same_as<typename To::Value>;
+    // adapters like `Extrapolation` must update their caches in `Approximate`
+    requires std::same_as<To const &, decltype(t.interpolation())>;
+  };
+  if constexpr (kNodal) {
+    for (int i = 0; i < To::N; ++i) {
+      to->SetValue(i, from.LocalToValue(to->integrator().GetLocal(i)));
+    }
+  } else {
+    to->Approximate([&from](Global const &global) {
+      return from.GlobalToValue(global);
+    });
+  }
+}
+
+}  // namespace polynomial
+}  // namespace mini
+
+#endif  // MINI_POLYNOMIAL_TRANSFER_HPP_
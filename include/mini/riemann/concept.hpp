@@ -5,6 +5,7 @@
 
 #include <concepts>
 #include <type_traits>
+#include <vector>
 
 namespace mini {
 namespace riemann {
@@ -43,6 +44,18 @@ concept Convective =
     HasConvectiveData<R> &&
     HasConvectiveMethods<R, typename R::Conservative>;
 
+/**
+ * @brief Convective solvers that can get the upwind fluxes at a batch of points in one call.
+ *
+ * See `rotated::Euler::GetFluxesUpwind` for the meaning of the arguments.
+ */
+template <typename R>
+concept Batched = Convective<R> && requires(std::vector<R> const &riemanns,
+    typename R::Batch const &value, typename R::Batch *flux) {
+  requires std::integral<decltype(R::kMaxBatch)>;
+  { R::GetFluxesUpwind(riemanns, value, value, flux) } -> std::same_as<void>;
+};
+
 template <typename R>
 concept HasDiffusiveData = requires {
   typename R::Diffusion;
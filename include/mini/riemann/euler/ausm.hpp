@@ -5,6 +5,7 @@
 
 #include <array>
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 
 #include "mini/riemann/euler/types.hpp"
@@ -35,6 +36,23 @@ class AdvectionUpstreamSplittingMethod {
   static Flux GetFlux(const Primitive& state) {
     return Gas::PrimitiveToFlux(state);
   }
+  /**
+   * @brief The batched version of `GetFluxUpwind`, in which all branches are replaced by masks, so that each column is processed by SIMD instructions.
+   *
+   * @tparam Batch an instance of `euler::Batch`
+   * @param left the primitive states on the left side, one row per point
+   * @param right the primitive states on the right side, one row per point
+   * @param flux the upwind fluxes, one row per point
+   */
+  template <class Batch>
+  static void GetFluxesUpwind(Batch const &left, Batch const &right,
+      Batch *flux) {
+    assert(left.rows() == right.rows());
+    constexpr bool kPositive = false, kNegative = true;
+    flux->setZero(left.rows(), kComponents);
+    AddSignedFluxes<kPositive>(left, flux);
+    AddSignedFluxes<kNegative>(right, flux);
+  }
 
  private:
   static Flux BuildFlux(const Primitive& primitive, Scalar enthalpy)
@@ -69,6 +87,33 @@ class AdvectionUpstreamSplittingMethod {
     flux.momentumX() += p;
     return flux;
   }
+  template <bool kNegative, class Batch>
+  static void AddSignedFluxes(Batch const &state, Batch *flux) {
+    auto rho = state.col(0).array();
+    auto u = state.col(1).array();
+    auto p = state.col(kComponents - 1).array();
+    auto a = (Gas::Gamma() * p / rho).sqrt().eval();
+    auto uu = (u * u).eval();
+    for (int d = 2; d <= kDimensions; ++d) {
+      uu += state.col(d).array().square();
+    }
+    auto h = (a * a / Gas::GammaMinusOne() + 0.5 * uu).eval();
+    auto mach = (u / a).eval();
+    auto signed_mach = ((1 + (kNegative ? -mach : mach)) * 0.5).eval();
+    auto subsonic = (mach.abs() <= 1).eval();
+    auto opposite = (signed_mach < 0).eval();
+    auto mach_split = (signed_mach.square() * (kNegative ? -1 : 1)).eval();
+    mach = subsonic.select(mach_split, opposite.select(Scalar(0), mach));
+    auto p_split = subsonic.select(p * signed_mach,
+        opposite.select(Scalar(0), p)).eval();
+    auto mass_flux = (rho * a * mach).eval();
+    flux->col(0).array() += mass_flux;
+    for (int d = 1; d <= kDimensions; ++d) {
+      flux->col(d).array() += mass_flux * state.col(d).array();
+    }
+    flux->col(1).array() += p_split;
+    flux->col(kComponents - 1).array() += mass_flux * h;
+  }
 };
 
 }  //  namespace euler
@@ -5,6 +5,7 @@
 
 #include <array>
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 
 #include "mini/riemann/euler/types.hpp"
@@ -46,6 +47,76 @@ class HartenLaxLeerContact {
   static Flux GetFlux(const Primitive& state) {
     return Gas::PrimitiveToFlux(state);
   }
+  /**
+   * @brief The batched version of `GetFluxUpwind`, in which all branches are replaced by masks, so that each column is processed by SIMD instructions.
+   *
+   * @tparam Batch an instance of `euler::Batch`
+   * @param left the primitive states on the left side, one row per point
+   * @param right the primitive states on the right side, one row per point
+   * @param flux the upwind fluxes, one row per point
+   */
+  template <class Batch>
+  static void GetFluxesUpwind(Batch const &left, Batch const &right,
+      Batch *flux) {
+    assert(left.rows() == right.rows());
+    auto rho_left = left.col(0).array(), rho_right = right.col(0).array();
+    auto u_left = left.col(1).array(), u_right = right.col(1).array();
+    auto p_left = left.col(kComponents - 1).array();
+    auto p_right = right.col(kComponents - 1).array();
+    // speeds of waves
+    auto a_left = (Gas::Gamma() * p_left / rho_left).sqrt().eval();
+    auto a_right = (Gas::Gamma() * p_right / rho_right).sqrt().eval();
+    auto p_estimate = ((p_left + p_right - (u_right - u_left)
+        * (rho_left + rho_right) * (a_left + a_right) / 4) / 2).max(Scalar(0)).eval();
+    auto get_q = [&p_estimate](auto const &p_k) {
+      auto q = (1 + Gas::GammaPlusOneOverTwo() * (p_estimate / p_k - 1)
+          / Gas::Gamma()).sqrt();
+      return (p_estimate <= p_k).select(Scalar(1), q).eval();
+    };
+    auto wave_left = (u_left - a_left * get_q(p_left)).eval();
+    auto wave_right = (u_right + a_right * get_q(p_right)).eval();
+    auto wave_star = ((p_right - p_left
+        + rho_left * u_left * (wave_left - u_left)
+        - rho_right * u_right * (wave_right - u_right))
+        / (rho_left * (wave_left - u_left)
+        - rho_right * (wave_right - u_right))).eval();
+    // fluxes on both sides, then add the jumps across the star region
+    Batch flux_left, flux_right;
+    Gas::PrimitiveToFlux(left, &flux_left);
+    Gas::PrimitiveToFlux(right, &flux_right);
+    auto add_star_jump = [&wave_star](Batch const &state, auto const &wave_k,
+        Batch *flux_k) {
+      auto rho = state.col(0).array();
+      auto u = state.col(1).array();
+      auto p = state.col(kComponents - 1).array();
+      auto rho_times_uu = (rho * u * u).eval();
+      for (int d = 2; d <= kDimensions; ++d) {
+        rho_times_uu += rho * state.col(d).array().square();
+      }
+      auto energy = (p * Gas::OneOverGammaMinusOne() + 0.5 * rho_times_uu);
+      auto temp = (rho * (wave_k - u) / (wave_k - wave_star)).eval();
+      // flux_k += wave_k * (u_star_k - u_k)
+      flux_k->col(0).array() += wave_k * (temp - rho);
+      flux_k->col(1).array() += wave_k * (temp * wave_star - rho * u);
+      for (int d = 2; d <= kDimensions; ++d) {
+        auto v = state.col(d).array();
+        flux_k->col(d).array() += wave_k * (temp - rho) * v;
+      }
+      flux_k->col(kComponents - 1).array() += wave_k * (temp
+          * (energy / rho + (wave_star - u)
+              * (wave_star + p / (rho * (wave_k - u)))) - energy);
+    };
+    Batch flux_star_left = flux_left, flux_star_right = flux_right;
+    add_star_jump(left, wave_left, &flux_star_left);
+    add_star_jump(right, wave_right, &flux_star_right);
+    flux->resize(left.rows(), kComponents);
+    for (int k = 0; k < kComponents; ++k) {
+      flux->col(k).array() = (wave_left >= 0).select(
+          flux_left.col(k).array(), (wave_right <= 0).select(
+          flux_right.col(k).array(), (wave_star >= 0).select(
+          flux_star_left.col(k).array(), flux_star_right.col(k).array())));
+    }
+  }
 
  private:
   Speed wave_star_;
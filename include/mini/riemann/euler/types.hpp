@@ -183,6 +183,15 @@ struct Conservatives : public Tuple<ScalarType, kDimensions> {
   using Base::Base;
 };
 
+/**
+ * @brief Tuples at a batch of points stored as structure-of-arrays, i.e. `batch.col(k)` holds the k-th component at all points.
+ *
+ * Since the number of rows is bounded by `kMaxPoints`, a `Batch` lives on the stack.
+ */
+template <std::floating_point Scalar, int kDimensions, int kMaxPoints = 64>
+using Batch = Eigen::Matrix<Scalar, Eigen::Dynamic, kDimensions + 2,
+    Eigen::ColMajor, kMaxPoints, kDimensions + 2>;
+
 template <std::floating_point ScalarType, double kGamma>
 class IdealGas {
  public:
@@ -319,6 +328,56 @@ class IdealGas {
     flux_x.energy() += primitive.p() * primitive.u();
     return flux_x;
   }
+
+  /**
+   * @brief The batched version of `ConservativeToPrimitive`, which has the same treatment of nonpositive densities and negative pressures.
+   */
+  template <class Batch>
+  static void ConservativeToPrimitive(Batch const &conservative,
+      Batch *primitive) {
+    constexpr int kDimensions = Batch::ColsAtCompileTime - 2;
+    *primitive = conservative;
+    auto rho = conservative.col(0).array();
+    auto positive = (rho > 0);
+    auto rho_times_uu = (rho * 0).eval();  // i.e. 2 * dynamic pressure
+    for (int d = 1; d <= kDimensions; ++d) {
+      auto momentum = conservative.col(d).array();
+      auto velocity = (momentum / rho).eval();
+      rho_times_uu += momentum * velocity;
+      primitive->col(d).array() = positive.select(velocity, momentum);
+    }
+    auto energy = conservative.col(kDimensions + 1).array();
+    auto p = ((energy - 0.5 * rho_times_uu) * GammaMinusOne()).eval();
+    primitive->col(kDimensions + 1).array() = positive.select(p, energy);
+    // same as the two calls of `SetZeroIfNegative` in the scalar version
+    auto invalid = (rho < 0 || energy < 0 || (positive && p < 0)).eval();
+    for (int k = 0; k < kDimensions + 2; ++k) {
+      primitive->col(k).array() = invalid.select(Scalar(0), primitive->col(k).array());
+    }
+  }
+  /**
+   * @brief The batched version of `PrimitiveToFlux`.
+   */
+  template <class Batch>
+  static void PrimitiveToFlux(Batch const &primitive, Batch *flux) {
+    constexpr int kDimensions = Batch::ColsAtCompileTime - 2;
+    auto rho = primitive.col(0).array();
+    auto u = primitive.col(1).array();
+    auto p = primitive.col(kDimensions + 1).array();
+    auto rho_u = (rho * u).eval();
+    auto rho_times_uu = (rho * 0).eval();
+    flux->resize(primitive.rows(), kDimensions + 2);
+    flux->col(0).array() = rho_u;
+    for (int d = 1; d <= kDimensions; ++d) {
+      auto velocity = primitive.col(d).array();
+      rho_times_uu += rho * velocity * velocity;
+      flux->col(d).array() = rho_u * velocity;
+    }
+    flux->col(1).array() += p;
+    flux->col(kDimensions + 1).array() =
+        (p * GammaOverGammaMinusOne() + 0.5 * rho_times_uu) * u;
+  }
+
   static auto GetFluxMatrix(Conservatives<Scalar, 3> const& cv) {
     using FluxMatrix = typename FluxTuple<Scalar, 3>::FluxMatrix;
     FluxMatrix mat;
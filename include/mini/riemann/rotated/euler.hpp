@@ -6,12 +6,16 @@
 #include <concepts>
 
 #include <algorithm>
+#include <array>
+#include <cassert>
+#include <iterator>
 #include <type_traits>
 #include <utility>
 #include <iostream>
 
 #include "mini/algebra/eigen.hpp"
 #include "mini/riemann/euler/eigen.hpp"
+#include "mini/riemann/euler/types.hpp"
 #include "mini/constant/index.hpp"
 
 namespace mini {
@@ -39,9 +43,15 @@ class Euler {
   using Primitive = typename Base::Primitive;
   using Value = typename Flux::Base;
 
+  constexpr static int kMaxBatch = 64;
+  using Batch = euler::Batch<Scalar, kDimensions, kMaxBatch>;
+
   void Rotate(const Frame &frame) {
     frame_ = &frame;
   }
+  Frame const &frame() const {
+    return *frame_;
+  }
   Vector const &normal() const {
     return a();
   }
@@ -157,6 +167,75 @@ class Euler {
     auto primitive_right = Gas::ConservativeToPrimitive(conservative_right);
     return GlobalPrimitivePairToGlobalFlux(&primitive__left, &primitive_right);
   }
+  /**
+   * @brief Get the upwind fluxes at a batch of points on a face, each of which has its own solver.
+   *
+   * The states are rotated and converted column by column, and the unrotated solver is called once for the whole batch if it provides a batched `GetFluxesUpwind`, otherwise once for each point.
+   *
+   * @tparam Riemanns a random-access range of `Euler` or its derived classes
+   * @param riemanns `riemanns[i]` is the solver at the i-th point
+   * @param left the conservative states on the left side, one row per point
+   * @param right the conservative states on the right side, one row per point
+   * @param flux the upwind fluxes in the global frame, one row per point
+   */
+  template <class Riemanns>
+  static void GetFluxesUpwind(Riemanns const &riemanns,
+      Batch const &left, Batch const &right, Batch *flux) {
+    int n = left.rows();
+    assert(n == right.rows() && n <= kMaxBatch && n <= std::ssize(riemanns));
+    // frames in the structure-of-arrays format, i.e. axes[k][d][i]
+    using Column = Eigen::Array<Scalar, Eigen::Dynamic, 1, Eigen::ColMajor,
+        kMaxBatch, 1>;
+    std::array<std::array<Column, kDimensions>, kDimensions> axes;
+    for (int k = 0; k < kDimensions; ++k) {
+      for (int d = 0; d < kDimensions; ++d) {
+        axes[k][d].resize(n);
+        for (int i = 0; i < n; ++i) {
+          axes[k][d][i] = static_cast<Euler const &>(riemanns[i]).frame()[k][d];
+        }
+      }
+    }
+    auto global_to_normal = [&axes](Batch const &global, Batch *normal) {
+      *normal = global;
+      for (int k = 0; k < kDimensions; ++k) {
+        auto p_k = normal->col(1 + k).array();
+        p_k = global.col(1).array() * axes[k][0];
+        for (int d = 1; d < kDimensions; ++d) {
+          p_k += global.col(1 + d).array() * axes[k][d];
+        }
+      }
+    };
+    Batch normal__left, normal_right;
+    global_to_normal(left, &normal__left);
+    global_to_normal(right, &normal_right);
+    Batch primitive__left, primitive_right;
+    Gas::ConservativeToPrimitive(normal__left, &primitive__left);
+    Gas::ConservativeToPrimitive(normal_right, &primitive_right);
+    Batch normal_flux;
+    if constexpr (requires {
+        Base::GetFluxesUpwind(primitive__left, primitive_right, &normal_flux);
+    }) {
+      Base::GetFluxesUpwind(primitive__left, primitive_right, &normal_flux);
+    } else {
+      normal_flux.resize(n, kComponents);
+      for (int i = 0; i < n; ++i) {
+        Primitive primitive_i__left = primitive__left.row(i).transpose();
+        Primitive primitive_i_right = primitive_right.row(i).transpose();
+        auto const &riemann = static_cast<Euler const &>(riemanns[i]);
+        normal_flux.row(i) = riemann.unrotated_euler_.GetFluxUpwind(
+            primitive_i__left, primitive_i_right).transpose();
+      }
+    }
+    // normal to global
+    *flux = normal_flux;
+    for (int d = 0; d < kDimensions; ++d) {
+      auto p_d = flux->col(1 + d).array();
+      p_d = normal_flux.col(1).array() * axes[0][d];
+      for (int k = 1; k < kDimensions; ++k) {
+        p_d += normal_flux.col(1 + k).array() * axes[k][d];
+      }
+    }
+  }
   Flux GetFluxOnInviscidWall(Conservative const &conservative_interior) const {
 #ifdef SOLVE_RIEMANN_PROBLEM_ON_INVISCID_WALL_
     auto primitive__left = Gas::ConservativeToPrimitive(conservative_interior);
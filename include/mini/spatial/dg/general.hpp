@@ -2,9 +2,11 @@
 #ifndef MINI_SPATIAL_DG_GENERAL_HPP_
 #define MINI_SPATIAL_DG_GENERAL_HPP_
 
+#include <array>
 #include <cassert>
 #include <functional>
 #include <memory>
+#include <ranges>
 #include <vector>
 #include <stdexcept>
 #include <string>
@@ -33,6 +35,16 @@ class General : public spatial::FiniteElement<P, R> {
   using Value = typename Base::Value;
   using Temporal = typename Base::Temporal;
   using Column = typename Base::Column;
+  using FluxMatrix = typename Base::FluxMatrix;
+  using Mat1xN = algebra::Matrix<Scalar, 1, Polynomial::N>;
+  using Mat3xN = algebra::Matrix<Scalar, 3, Polynomial::N>;
+
+ protected:
+  // [i_cell][i_gauss], empty unless BuildBasisTables() is called
+  std::vector<std::vector<Mat1xN>> cell_basis_values_;
+  std::vector<std::vector<Mat3xN>> cell_basis_gradients_;
+  // [i_face][i_gauss], empty unless BuildBasisTables() is called
+  std::vector<std::vector<Mat1xN>> holder_basis_values_, sharer_basis_values_;
 
  public:
   explicit General(Part *part_ptr)
@@ -48,22 +60,157 @@ class General : public spatial::FiniteElement<P, R> {
     return "DG::General";
   }
 
+  /**
+   * @brief Tabulate the basis values (and gradients) at the quadrature points of all local cells and all faces.
+   * 
+   * Since the basis of each cell never changes, the residual can then be evaluated by small dense products, instead of re-evaluating the basis at each quadrature point.
+   * The memory cost is \f$ 4N \f$ scalars per volume quadrature point and \f$ 2N \f$ scalars per face quadrature point, so it is not called by default.
+   */
+  void BuildBasisTables() {
+    // `Value`s are got by `coeff() * basis_values.transpose()` from the tables
+    static_assert(!Polynomial::kLocal);
+    auto const &part = this->part();
+    cell_basis_values_.resize(part.CountLocalCells());
+    cell_basis_gradients_.resize(part.CountLocalCells());
+    for (Cell const &cell : part.GetLocalCells()) {
+      auto const &integrator = cell.integrator();
+      auto const &polynomial = cell.polynomial();
+      auto n = integrator.CountPoints();
+      auto &values = cell_basis_values_.at(cell.id());
+      auto &gradients = cell_basis_gradients_.at(cell.id());
+      values.resize(n);
+      gradients.resize(n);
+      for (int q = 0; q < n; ++q) {
+        const auto &xyz = integrator.GetGlobal(q);
+        values[q] = polynomial.GlobalToBasisValues(xyz);
+        gradients[q] = polynomial.GlobalToBasisGlobalGradients(xyz);
+      }
+    }
+    // `riemann_` is indexed by the ids of local, ghost and boundary faces
+    auto n_faces = this->riemann_.size();
+    holder_basis_values_.resize(n_faces);
+    sharer_basis_values_.resize(n_faces);
+    auto build_face_tables = [this](std::ranges::input_range auto faces,
+        bool with_sharer) {
+      for (Face const &face : faces) {
+        auto const &integrator = face.integrator();
+        auto n = integrator.CountPoints();
+        auto &holder_values = holder_basis_values_.at(face.id());
+        holder_values.resize(n);
+        for (int q = 0; q < n; ++q) {
+          const auto &coord = integrator.GetGlobal(q);
+          holder_values[q] = face.holder().GlobalToBasisValues(coord);
+        }
+        if (!with_sharer) { continue; }
+        auto &sharer_values = sharer_basis_values_.at(face.id());
+        sharer_values.resize(n);
+        for (int q = 0; q < n; ++q) {
+          const auto &coord = integrator.GetGlobal(q);
+          sharer_values[q] = face.sharer().GlobalToBasisValues(coord);
+        }
+      }
+    };
+    build_face_tables(part.GetLocalFaces(), true);
+    build_face_tables(part.GetGhostFaces(), true);
+    build_face_tables(part.GetBoundaryFaces(), false);
+  }
+
+  bool HasBasisTables() const {
+    return !cell_basis_values_.empty();
+  }
+
   virtual Value GetValueJump(Face const &face, int i_flux_point) const {
+    if (HasBasisTables()) {
+      auto const &holder_values = holder_basis_values_[face.id()];
+      auto const &sharer_values = sharer_basis_values_[face.id()];
+      return GetValue(face.holder(), holder_values[i_flux_point])
+           - GetValue(face.sharer(), sharer_values[i_flux_point]);
+    }
     const auto &global = face.integrator().GetGlobal(i_flux_point);
     return face.holder().polynomial().GlobalToValue(global)
          - face.sharer().polynomial().GlobalToValue(global);
   }
 
+ protected:  // lookup the tables if built, otherwise evaluate the basis
+  Mat1xN GetBasisValues(Cell const &cell, int q) const {
+    if (HasBasisTables()) {
+      return cell_basis_values_[cell.id()][q];
+    }
+    return cell.GlobalToBasisValues(cell.integrator().GetGlobal(q));
+  }
+  Mat3xN GetBasisGradients(Cell const &cell, int q) const {
+    if (HasBasisTables()) {
+      return cell_basis_gradients_[cell.id()][q];
+    }
+    const auto &xyz = cell.integrator().GetGlobal(q);
+    return cell.polynomial().GlobalToBasisGlobalGradients(xyz);
+  }
+  Mat1xN GetHolderBasisValues(Face const &face, int q) const {
+    if (HasBasisTables()) {
+      return holder_basis_values_[face.id()][q];
+    }
+    return face.holder().GlobalToBasisValues(face.integrator().GetGlobal(q));
+  }
+  Mat1xN GetSharerBasisValues(Face const &face, int q) const {
+    if (HasBasisTables()) {
+      return sharer_basis_values_[face.id()][q];
+    }
+    return face.sharer().GlobalToBasisValues(face.integrator().GetGlobal(q));
+  }
+  static Value GetValue(Cell const &cell, Mat1xN const &basis_values) {
+    return cell.polynomial().coeff() * basis_values.transpose();
+  }
+  Value GetHolderValue(Face const &face, int q,
+      Mat1xN const &basis_values) const {
+    if (HasBasisTables()) {
+      return GetValue(face.holder(), basis_values);
+    }
+    return face.holder().GlobalToValue(face.integrator().GetGlobal(q));
+  }
+  Value GetSharerValue(Face const &face, int q,
+      Mat1xN const &basis_values) const {
+    if (HasBasisTables()) {
+      return GetValue(face.sharer(), basis_values);
+    }
+    return face.sharer().GlobalToValue(face.integrator().GetGlobal(q));
+  }
+
+  FluxMatrix GetTabulatedFluxMatrix(Cell const &cell, int q) const
+      requires(!mini::riemann::Diffusive<Riemann>) {
+    if (!HasBasisTables()) {
+      return Base::GetFluxMatrix(cell, q);
+    }
+    return Riemann::GetFluxMatrix(GetValue(cell, GetBasisValues(cell, q)));
+  }
+  FluxMatrix GetTabulatedFluxMatrix(Cell const &cell, int q) const
+      requires(mini::riemann::ConvectiveDiffusive<Riemann>) {
+    if (!HasBasisTables()) {
+      return Base::GetFluxMatrix(cell, q);
+    }
+    Value value = GetValue(cell, GetBasisValues(cell, q));
+    auto gradient = (GetBasisGradients(cell, q)
+        * cell.polynomial().coeff().transpose()).eval();
+    FluxMatrix flux_matrix;
+    if (Base::IsViscousOnly()) {
+      flux_matrix.setZero();
+    } else {
+      flux_matrix = Riemann::Convection::GetFluxMatrix(value);
+    }
+    if (!Base::IsConvectionOnly()) {
+      const auto &property = Riemann::Diffusion::GetPropertyOnCell(cell.id(), q);
+      Riemann::MinusViscousFlux(&flux_matrix, property, value, gradient);
+    }
+    return flux_matrix;
+  }
+
  protected:  // implement pure virtual methods declared in Base
   void AddFluxDivergence(Cell const &cell, Scalar *residual) const override {
     assert(residual);
     const auto &integrator = cell.integrator();
     for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
-      const auto &xyz = integrator.GetGlobal(q);
-      auto flux = Base::GetFluxMatrix(cell, q);
+      auto flux = GetTabulatedFluxMatrix(cell, q);
       flux *= integrator.GetGlobalWeight(q);
-      auto grad = cell.polynomial().GlobalToBasisGlobalGradients(xyz);
-      Coeff prod = flux * grad;
+      Coeff prod = flux * GetBasisGradients(cell, q);
       Polynomial::AddToResidual(prod, residual);
     }
   }
@@ -71,22 +218,76 @@ class General : public spatial::FiniteElement<P, R> {
       Scalar *holder_data, Scalar *sharer_data) const override {
     const auto &riemanns = this->GetRiemannSolvers(face);
     const auto &integrator = face.integrator();
-    const auto &holder = face.holder();
-    const auto &sharer = face.sharer();
+    if constexpr (mini::riemann::Batched<Riemann>) {
+      if (integrator.CountPoints() <= Riemann::kMaxBatch) {
+        AddBatchedFluxToHolderAndSharer(face, holder_data, sharer_data);
+        return;
+      }
+    }
     for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
-      const auto &coord = integrator.GetGlobal(q);
-      Value u_holder = holder.GlobalToValue(coord);
-      Value u_sharer = sharer.GlobalToValue(coord);
+      Mat1xN holder_basis_values = GetHolderBasisValues(face, q);
+      Mat1xN sharer_basis_values = GetSharerBasisValues(face, q);
+      Value u_holder = GetHolderValue(face, q, holder_basis_values);
+      Value u_sharer = GetSharerValue(face, q, sharer_basis_values);
       Value flux = riemanns[q].GetFluxUpwind(u_holder, u_sharer);
       flux *= -integrator.GetGlobalWeight(q);
-      Coeff prod = flux * holder.GlobalToBasisValues(coord);
+      Coeff prod = flux * holder_basis_values;
+      assert(holder_data);
+      Polynomial::AddToResidual(prod, holder_data);
+      if (nullptr == sharer_data) { continue; }
+      prod = -flux * sharer_basis_values;
+      Polynomial::AddToResidual(prod, sharer_data);
+    }
+  }
+  /**
+   * @brief Gather the values at all quadrature points on a face, solve the Riemann problems in one call, then scatter the fluxes.
+   */
+  void AddBatchedFluxToHolderAndSharer(Face const &face,
+      Scalar *holder_data, Scalar *sharer_data) const
+      requires(mini::riemann::Batched<Riemann>) {
+    using Batch = typename Riemann::Batch;
+    const auto &integrator = face.integrator();
+    int n = integrator.CountPoints();
+    Batch u_holder(n, Riemann::kComponents), flux;
+    Batch u_sharer(n, Riemann::kComponents);
+    // evaluated once for both gathering and scattering
+    std::array<Mat1xN, Riemann::kMaxBatch> holder_basis_values;
+    std::array<Mat1xN, Riemann::kMaxBatch> sharer_basis_values;
+    for (int q = 0; q < n; ++q) {
+      holder_basis_values[q] = GetHolderBasisValues(face, q);
+      sharer_basis_values[q] = GetSharerBasisValues(face, q);
+      u_holder.row(q) = GetHolderValue(face, q,
+          holder_basis_values[q]).transpose();
+      u_sharer.row(q) = GetSharerValue(face, q,
+          sharer_basis_values[q]).transpose();
+    }
+    Riemann::GetFluxesUpwind(this->GetRiemannSolvers(face),
+        u_holder, u_sharer, &flux);
+    for (int q = 0; q < n; ++q) {
+      Value flux_q = flux.row(q).transpose();
+      flux_q *= -integrator.GetGlobalWeight(q);
+      Coeff prod = flux_q * holder_basis_values[q];
       assert(holder_data);
       Polynomial::AddToResidual(prod, holder_data);
       if (nullptr == sharer_data) { continue; }
-      prod = -flux * sharer.GlobalToBasisValues(coord);
+      prod = -flux_q * sharer_basis_values[q];
       Polynomial::AddToResidual(prod, sharer_data);
     }
   }
+  /**
+   * @brief Nothing is added, since viscous terms of DG are integrated only inside cells, and convective upwind fluxes are skipped here as declared in Base.
+   *
+   * For the same reason, faces are skipped in the viscous-only mode.
+   */
+  void AddFluxToHolder(Face const &face, Scalar *holder_data) const override {
+    assert(holder_data);
+  }
+  void AddFluxToSharer(Face const &face, Scalar *sharer_data) const override {
+    assert(sharer_data);
+  }
+  bool HasViscousFluxOnFaces() const override {
+    return false;
+  }
 
  protected:  // virtual methods that might be overriden in subclasses
   void AddFluxOnInviscidWalls(Column *residual) const override {
@@ -97,11 +298,11 @@ class General : public spatial::FiniteElement<P, R> {
         const auto &holder = face.holder();
         Scalar *holder_data = this->AddCellDataOffset(residual, holder.id());
         for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
-          const auto &coord = integrator.GetGlobal(q);
-          Value u_holder = holder.GlobalToValue(coord);
+          Mat1xN basis_values = GetHolderBasisValues(face, q);
+          Value u_holder = GetHolderValue(face, q, basis_values);
           Value flux = riemanns[q].GetFluxOnInviscidWall(u_holder);
           flux *= -integrator.GetGlobalWeight(q);
-          Coeff prod = flux * holder.GlobalToBasisValues(coord);
+          Coeff prod = flux * basis_values;
           Polynomial::AddToResidual(prod, holder_data);
         }
       }
@@ -115,11 +316,11 @@ class General : public spatial::FiniteElement<P, R> {
         const auto &holder = face.holder();
         Scalar *holder_data = this->AddCellDataOffset(residual, holder.id());
         for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
-          const auto &coord = integrator.GetGlobal(q);
-          Value u_holder = holder.GlobalToValue(coord);
+          Mat1xN basis_values = GetHolderBasisValues(face, q);
+          Value u_holder = GetHolderValue(face, q, basis_values);
           Value flux = riemanns[q].GetFluxOnSupersonicOutlet(u_holder);
           flux *= -integrator.GetGlobalWeight(q);
-          Coeff prod = flux * holder.GlobalToBasisValues(coord);
+          Coeff prod = flux * basis_values;
           Polynomial::AddToResidual(prod, holder_data);
         }
       }
@@ -134,10 +335,11 @@ class General : public spatial::FiniteElement<P, R> {
         Scalar *holder_data = this->AddCellDataOffset(residual, holder.id());
         for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
           const auto &coord = integrator.GetGlobal(q);
+          Mat1xN basis_values = GetHolderBasisValues(face, q);
           Value u_given = func(coord, this->t_curr_);
           Value flux = riemanns[q].GetFluxOnSupersonicInlet(u_given);
           flux *= -integrator.GetGlobalWeight(q);
-          Coeff prod = flux * holder.GlobalToBasisValues(coord);
+          Coeff prod = flux * basis_values;
           Polynomial::AddToResidual(prod, holder_data);
         }
       }
@@ -152,11 +354,12 @@ class General : public spatial::FiniteElement<P, R> {
         Scalar *holder_data = this->AddCellDataOffset(residual, holder.id());
         for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
           const auto &coord = integrator.GetGlobal(q);
-          Value u_inner = holder.GlobalToValue(coord);
+          Mat1xN basis_values = GetHolderBasisValues(face, q);
+          Value u_inner = GetHolderValue(face, q, basis_values);
           Value u_given = func(coord, this->t_curr_);
           Value flux = riemanns[q].GetFluxOnSubsonicInlet(u_inner, u_given);
           flux *= -integrator.GetGlobalWeight(q);
-          Coeff prod = flux * holder.GlobalToBasisValues(coord);
+          Coeff prod = flux * basis_values;
           Polynomial::AddToResidual(prod, holder_data);
         }
       }
@@ -171,11 +374,12 @@ class General : public spatial::FiniteElement<P, R> {
         Scalar *holder_data = this->AddCellDataOffset(residual, holder.id());
         for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
           const auto &coord = integrator.GetGlobal(q);
-          Value u_inner = holder.GlobalToValue(coord);
+          Mat1xN basis_values = GetHolderBasisValues(face, q);
+          Value u_inner = GetHolderValue(face, q, basis_values);
           Value u_given = func(coord, this->t_curr_);
           Value flux = riemanns[q].GetFluxOnSubsonicOutlet(u_inner, u_given);
           flux *= -integrator.GetGlobalWeight(q);
-          Coeff prod = flux * holder.GlobalToBasisValues(coord);
+          Coeff prod = flux * basis_values;
           Polynomial::AddToResidual(prod, holder_data);
         }
       }
@@ -190,11 +394,12 @@ class General : public spatial::FiniteElement<P, R> {
         Scalar *holder_data = this->AddCellDataOffset(residual, holder.id());
         for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
           const auto &coord = integrator.GetGlobal(q);
-          Value u_inner = holder.GlobalToValue(coord);
+          Mat1xN basis_values = GetHolderBasisValues(face, q);
+          Value u_inner = GetHolderValue(face, q, basis_values);
           Value u_given = func(coord, this->t_curr_);
           Value flux = riemanns[q].GetFluxOnSmartBoundary(u_inner, u_given);
           flux *= -integrator.GetGlobalWeight(q);
-          Coeff prod = flux * holder.GlobalToBasisValues(coord);
+          Coeff prod = flux * basis_values;
           Polynomial::AddToResidual(prod, holder_data);
         }
       }
@@ -226,6 +431,7 @@ class WithSource : public General<P, R> {
   template <class... Args>
   WithSource(Source *source_ptr, Args&&... args)
       : Base(std::forward<Args>(args)...), source_ptr_(source_ptr) {
+    source_ptr_->BuildCellIndex(this->part().GetLocalCells());
   }
   WithSource(const WithSource &) = default;
   WithSource &operator=(const WithSource &) = default;
@@ -234,19 +440,20 @@ class WithSource : public General<P, R> {
   ~WithSource() noexcept = default;
 
  public:  // implement pure virtual methods declared in Temporal
-  Column GetResidualColumn() const override {
-    auto residual = this->Base::GetResidualColumn();
-    this->AddSourceIntegral(&residual);
-    return residual;
+  void WriteResidualTo(Column *residual) const override {
+    this->Base::WriteResidualTo(residual);
+    if (!this->IsViscousOnly()) {
+      this->AddSourceIntegral(residual);
+    }
   }
 
  protected:
   virtual void AddSourceIntegral(Column *residual) const {
-    // Integrate the source term, if there is any.
-    for (const Cell &cell : this->part().GetLocalCells()) {
-      Scalar *data = this->AddCellDataOffset(residual, cell.id());
-      source_ptr_->UpdateCoeff(cell, this->t_curr_, data);
-    }
+    // Integrate the source term on cells touched by it.
+    auto get_coeff_data = [this, residual](Cell const &cell) {
+      return this->AddCellDataOffset(residual, cell.id());
+    };
+    source_ptr_->UpdateCoeffs(this->t_curr_, get_coeff_data);
   }
 };
 
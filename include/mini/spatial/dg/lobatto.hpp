@@ -99,6 +99,18 @@ class Lobatto : public General<P, R> {
     return flux;
   }
 
+  /**
+   * @brief Get the local flux matrix weighted by the local quadrature weight.
+   * 
+   * For both `kLocal == true` and `kLocal == false`, \f$ \sum_{q} F_q\,\nabla\phi(x_q)\,w_q \f$ equals the sum of the returned matrices multiplied by the local gradients of the basis.
+   */
+  static FluxMatrix GetLocalWeightedFluxMatrix(const Cell &cell, int q) {
+    auto flux = Base::GetFluxMatrix(cell, q);
+    flux = cell.polynomial().GlobalFluxToLocalFlux(flux, q);
+    flux *= cell.integrator().GetLocalWeight(q);
+    return flux;
+  }
+
   static auto const &GetBasisGradients(Polynomial const &polynomial, int q)
       requires(kLocal) {
     return polynomial.GetBasisLocalGradients(q);
@@ -122,6 +134,12 @@ class Lobatto : public General<P, R> {
     MatchIntegratorianPoints(ghost_cells, face_to_sharer, &i_node_on_sharer_);
     auto boundary_cells = this->part().GetBoundaryFaces();
     MatchIntegratorianPoints(boundary_cells, face_to_holder, &i_node_on_holder_);
+    if constexpr (!mini::riemann::Diffusive<Riemann>) {
+      // Only values on nodes on faces are read from ghost cells.
+      this->ShareTracesOnly(
+          [this](Face const &face) { return i_node_on_holder_[face.id()]; },
+          [this](Face const &face) { return i_node_on_sharer_[face.id()]; });
+    }
   }
   Lobatto(const Lobatto &) = default;
   Lobatto &operator=(const Lobatto &) = default;
@@ -140,32 +158,42 @@ class Lobatto : public General<P, R> {
          - face.sharer().polynomial().GetValue(sharer_flux_point_ijk);
   }
 
-  Column GetResidualColumn() const override {
-    Column residual = this->Base::GetResidualColumn();
+  void WriteResidualTo(Column *residual) const override {
+    this->Base::WriteResidualTo(residual);
+    this->ApplyInverseMass(residual);
+  }
+
+ protected:  // override virtual methods defined in Base
+  void ApplyInverseMass(Column *column) const override {
     // divide mass matrix for each cell
-    for (const Cell &cell : this->part().GetLocalCells()) {
+    this->ForEachLocalCell([this, column](Cell const &cell) {
       auto i_cell = cell.id();
-      Scalar *data = this->AddCellDataOffset(&residual, i_cell);
+      Scalar *data = this->AddCellDataOffset(column, i_cell);
       const auto &integrator = cell.integrator();
       for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
         auto scale = 1.0 / GetWeight(integrator, q);
         data = cell.polynomial().ScaleValueAt(scale, data);
       }
-      assert(data == residual.data() + residual.size()
-          || data == this->AddCellDataOffset(&residual, i_cell + 1));
-    }
-    return residual;
+      assert(data == column->data() + column->size()
+          || data == this->AddCellDataOffset(column, i_cell + 1));
+    });
   }
-
- protected:  // override virtual methods defined in Base
   void AddFluxDivergence(Cell const &cell, Scalar *residual) const override {
     assert(residual);
     const auto &integrator = cell.integrator();
-    for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
-      auto flux = GetWeightedFluxMatrix(cell, q);
-      auto const &grad = GetBasisGradients(cell.polynomial(), q);
-      Coeff prod = flux * grad;
-      Polynomial::AddToResidual(prod, residual);
+    if constexpr (polynomial::TensorProduct<Polynomial>) {
+      std::array<FluxMatrix, Polynomial::N> local_fluxes;
+      for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
+        local_fluxes[q] = GetLocalWeightedFluxMatrix(cell, q);
+      }
+      Polynomial::AddFluxDotBasisGradients(local_fluxes, residual);
+    } else {
+      for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
+        auto flux = GetWeightedFluxMatrix(cell, q);
+        auto const &grad = GetBasisGradients(cell.polynomial(), q);
+        Coeff prod = flux * grad;
+        Polynomial::AddToResidual(prod, residual);
+      }
     }
   }
   void AddFluxToHolderAndSharer(Face const &face,
@@ -176,17 +204,36 @@ class Lobatto : public General<P, R> {
     const auto &sharer = face.sharer();
     auto &i_node_on_holder = i_node_on_holder_[face.id()];
     auto &i_node_on_sharer = i_node_on_sharer_[face.id()];
-    for (int f = 0, n = integrator.CountPoints(); f < n; ++f) {
-      auto c_holder = i_node_on_holder[f];
-      auto c_sharer = i_node_on_sharer[f];
-      Value u_holder = holder.polynomial().GetValue(c_holder);
-      Value u_sharer = sharer.polynomial().GetValue(c_sharer);
-      Value flux = riemanns[f].GetFluxUpwind(u_holder, u_sharer);
+    int n = integrator.CountPoints();
+    auto add_flux = [&](int f, Value flux) {
       flux *= integrator.GetGlobalWeight(f);
       assert(holder_data);
-      holder.polynomial().MinusValue(flux, holder_data, c_holder);
-      if (nullptr == sharer_data) { continue; }
-      sharer.polynomial().AddValueTo(flux, sharer_data, c_sharer);
+      holder.polynomial().MinusValue(flux, holder_data, i_node_on_holder[f]);
+      if (nullptr == sharer_data) { return; }
+      sharer.polynomial().AddValueTo(flux, sharer_data, i_node_on_sharer[f]);
+    };
+    if constexpr (mini::riemann::Batched<Riemann>) {
+      if (n <= Riemann::kMaxBatch) {
+        using Batch = typename Riemann::Batch;
+        Batch u_holder(n, Riemann::kComponents), flux;
+        Batch u_sharer(n, Riemann::kComponents);
+        for (int f = 0; f < n; ++f) {
+          u_holder.row(f) = holder.polynomial().GetValue(i_node_on_holder[f])
+              .transpose();
+          u_sharer.row(f) = sharer.polynomial().GetValue(i_node_on_sharer[f])
+              .transpose();
+        }
+        Riemann::GetFluxesUpwind(riemanns, u_holder, u_sharer, &flux);
+        for (int f = 0; f < n; ++f) {
+          add_flux(f, flux.row(f).transpose());
+        }
+        return;
+      }
+    }
+    for (int f = 0; f < n; ++f) {
+      Value u_holder = holder.polynomial().GetValue(i_node_on_holder[f]);
+      Value u_sharer = sharer.polynomial().GetValue(i_node_on_sharer[f]);
+      add_flux(f, riemanns[f].GetFluxUpwind(u_holder, u_sharer));
     }
   }
   void AddFluxOnInviscidWalls(Column *residual) const override {
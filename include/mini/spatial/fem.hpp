@@ -3,10 +3,16 @@
 #define MINI_SPATIAL_FEM_HPP_
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <ranges>
 #include <vector>
 #include <stdexcept>
 #include <string>
@@ -14,8 +20,14 @@
 #include <unordered_map>
 #include <utility>
 
+#include "mpi.h"
+
 #include "mini/riemann/concept.hpp"
 #include "mini/temporal/ode.hpp"
+#include "mini/temporal/implicit.hpp"
+#include "mini/temporal/multirate.hpp"
+#include "mini/temporal/rk.hpp"
+#include "mini/temporal/steady.hpp"
 #include "mini/constant/index.hpp"
 
 namespace mini {
@@ -45,7 +57,9 @@ static bool Near(auto const &x, auto const &y) {
 }
 
 template <typename P, typename R>
-class FiniteElement : public temporal::System<typename P::Scalar> {
+class FiniteElement : public temporal::MultirateSystem<typename P::Scalar>,
+    public temporal::ImplicitSystem<typename P::Scalar>,
+    public temporal::SteadySystem<typename P::Scalar> {
  public:
   using Part = P;
   using Riemann = R;
@@ -87,6 +101,51 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
   Part *part_ptr_;
   double t_curr_;
   size_t cell_data_size_;
+
+  // flattened local cells, which can be processed by OpenMP threads
+  std::vector<Cell const *> local_cells_;
+  // [i_group][i_face], no two faces in a group write to the same cell
+  std::vector<std::vector<Face const *>> local_face_groups_,
+      ghost_face_groups_;
+
+  /**
+   * @brief Greedily color the given faces, so that faces of the same color can be processed concurrently.
+   * 
+   * @param faces the faces to be colored
+   * @param n_cells the number of local cells
+   * @param with_sharer whether the sharer of each face is written
+   * @return the faces grouped by their colors
+   */
+  static std::vector<std::vector<Face const *>> BuildFaceGroups(
+      std::ranges::input_range auto faces, Index n_cells, bool with_sharer) {
+    std::vector<std::vector<Face const *>> groups;
+    // [i_cell] -> bitmask of the colors used by faces of this cell
+    auto used_colors = std::vector<uint64_t>(n_cells);
+    for (Face const &face : faces) {
+      auto i_holder = face.holder().id();
+      assert(0 <= i_holder && i_holder < n_cells);
+      uint64_t used = used_colors[i_holder];
+      if (with_sharer) {
+        auto i_sharer = face.sharer().id();
+        assert(0 <= i_sharer && i_sharer < n_cells);
+        used |= used_colors[i_sharer];
+      }
+      int i_color = std::countr_one(used);
+      if (i_color >= 64) {
+        throw std::runtime_error("Faces need more than 64 colors.");
+      }
+      uint64_t color = uint64_t(1) << i_color;
+      used_colors[i_holder] |= color;
+      if (with_sharer) {
+        used_colors[face.sharer().id()] |= color;
+      }
+      if (i_color == std::ssize(groups)) {
+        groups.emplace_back();
+      }
+      groups[i_color].emplace_back(&face);
+    }
+    return groups;
+  }
 #ifdef ENABLE_LOGGING
   std::unique_ptr<std::ofstream> log_;
 #endif
@@ -109,6 +168,15 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
     build_riemanns(part_ptr->GetLocalFaces());
     build_riemanns(part_ptr->GetGhostFaces());
     build_riemanns(part_ptr->GetBoundaryFaces());
+    for (Cell const &cell : part_ptr->GetLocalCells()) {
+      assert(cell.id() == local_cells_.size());
+      local_cells_.emplace_back(&cell);
+    }
+    auto n_cells = part_ptr->CountLocalCells();
+    local_face_groups_ = BuildFaceGroups(part_ptr->GetLocalFaces(),
+        n_cells, true);
+    ghost_face_groups_ = BuildFaceGroups(part_ptr->GetGhostFaces(),
+        n_cells, false);
 #ifdef ENABLE_LOGGING
     log_ = std::make_unique<std::ofstream>();
 #endif
@@ -144,6 +212,22 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
     return *part_ptr();
   }
 
+  /**
+   * @brief Apply the given callable to each local FiniteElement::Cell.
+   * 
+   * The cells are distributed over OpenMP threads, so the callable must not write data shared by different cells.
+   * 
+   * @param func the callable to be applied, which takes a `(Cell const &)`
+   */
+  template <class Callable>
+  void ForEachLocalCell(Callable &&func) const {
+    auto n_cells = static_cast<Index>(local_cells_.size());
+#pragma omp parallel for schedule(static)
+    for (Index i_cell = 0; i_cell < n_cells; ++i_cell) {
+      func(*local_cells_[i_cell]);
+    }
+  }
+
   template <class Callable>
   void Approximate(Callable &&func) {
     for (Cell *cell_ptr : part_ptr()->GetLocalCellPointers()) {
@@ -234,29 +318,370 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
           || data == AddCellDataOffset(column, i_cell + 1));
     }
   }
-  Column GetSolutionColumn() const override {
-    auto column = Column(cell_data_size_);
-    for (const Cell &cell : part().GetLocalCells()) {
+  void WriteSolutionTo(Column *column) const override {
+    column->resize(cell_data_size_);
+    ForEachLocalCell([this, column](Cell const &cell) {
       auto i_cell = cell.id();
-      Scalar *data = AddCellDataOffset(&column, i_cell);
+      Scalar *data = AddCellDataOffset(column, i_cell);
       data = cell.polynomial().WriteCoeffTo(data);
-      assert(data == column.data() + column.size()
+      assert(data == column->data() + column->size()
           || data == AddCellDataOffset(column, i_cell + 1));
+    });
+  }
+  int CountTimeLevels() const override {
+    return n_time_levels_;
+  }
+  void SetSubstep(int i_substep) override {
+    i_substep_ = i_substep;
+  }
+  void WriteTimeLevelsTo(std::vector<int8_t> *levels) const override {
+    levels->resize(cell_data_size_);
+    ForEachLocalCell([this, levels](Cell const &cell) {
+      auto i_cell = cell.id();
+      auto offset = part().GetCellDataOffset(i_cell);
+      std::fill_n(levels->begin() + offset, Cell::kFields, cell_levels(i_cell));
+    });
+  }
+  void WriteSplitResidualTo(Column *residual, Column *correction) const
+      override {
+    correction->resize(cell_data_size_);
+    correction->setZero();
+    correction_ = correction;
+    this->WriteResidualTo(residual);
+    correction_ = nullptr;
+    this->ApplyInverseMass(correction);
+    // Scale the whole residual (including sources) of each cell by its level.
+    ForEachLocalCell([this, residual](Cell const &cell) {
+      auto i_cell = cell.id();
+      Scalar scale = GetScale(cell_levels(i_cell));
+      if (scale != 1) {
+        Scalar *data = this->AddCellDataOffset(residual, i_cell);
+        for (int i = 0; i < Cell::kFields; ++i) {
+          data[i] *= scale;
+        }
+      }
+    });
+  }
+  void WriteResidualTo(Column *residual) const override {
+    residual->resize(cell_data_size_);
+    residual->setZero();
+    if (viscous_only_ && !this->HasViscousFluxOnFaces()) {
+      this->AddFluxDivergenceOnLocalCells(residual);
+      return;
     }
-    return column;
+    this->ShareGhostCellData();
+    this->AddFluxDivergenceOnLocalCells(residual);
+    this->AddFluxOnLocalFaces(residual);
+    this->AddFluxOnBoundaries(residual);
+    this->UpdateGhostCellData();
+    this->AddFluxOnGhostFaces(residual);
   }
-  Column GetResidualColumn() const override {
-    part_ptr()->ShareGhostCellCoeffs();
-    auto residual = Column(cell_data_size_);
-    residual.setZero();
-    this->AddFluxDivergenceOnLocalCells(&residual);
-    this->AddFluxOnLocalFaces(&residual);
-    this->AddFluxOnBoundaries(&residual);
-    part_ptr()->UpdateGhostCellCoeffs();
-    this->AddFluxOnGhostFaces(&residual);
-    return residual;
+
+ public:  // implement virtual methods declared in temporal::ImplicitSystem
+  Scalar GetInnerProduct(Column const &x, Column const &y) const override {
+    Scalar local = x.dot(y), global;
+    MPI_Allreduce(&local, &global, 1, kMpiRealType, MPI_SUM,
+        part().mpi_comm());
+    return global;
+  }
+
+  /**
+   * @brief Split the residual into the viscous (stiff) part and the convective (nonstiff) part.
+   *
+   * Sources (if any) are added to the convective part.
+   */
+  void WriteStiffAndNonstiffResidualsTo(Column *stiff, Column *nonstiff) const
+      override {
+    this->WriteNonstiffResidualTo(nonstiff);
+    this->WriteStiffResidualTo(stiff);
+  }
+
+  /**
+   * @brief Evaluate WriteResidualTo with convective fluxes and sources skipped, so no Riemann problem is solved.
+   *
+   * Schemes adding no viscous flux on faces (see HasViscousFluxOnFaces) skip faces and the halo exchange as well.
+   */
+  void WriteStiffResidualTo(Column *stiff) const override {
+    if constexpr (mini::riemann::Diffusive<Riemann>) {
+      auto guard = ViscousOnlyGuard();
+      this->WriteResidualTo(stiff);
+    } else {
+      stiff->setZero(cell_data_size_);
+    }
+  }
+
+  /**
+   * @brief Evaluate WriteResidualTo with viscous fluxes skipped.
+   */
+  void WriteNonstiffResidualTo(Column *nonstiff) const override {
+    auto guard = ConvectionOnlyGuard();
+    this->WriteResidualTo(nonstiff);
+  }
+
+  /**
+   * @brief Build the block-Jacobi preconditioner, whose blocks are the diagonal blocks of \f$ I - \gamma\,\Delta t\,\partial R_\mathrm{viscous} / \partial U \f$ on local cells.
+   *
+   * Each block is built column by column by finite differences of AddCellLocalResidual, in which the coeffs on neighbors are not read, so the current solution is perturbed on one cell at a time.
+   * Boundary conditions are not involved in AddCellLocalResidual, so the blocks on cells touching boundaries are approximate.
+   * Nothing is built if the Riemann solver is not diffusive, i.e. the preconditioner is the identity.
+   *
+   * @param gamma_dt the product of the diagonal coefficient and the time step
+   */
+  void UpdatePreconditioner(Scalar gamma_dt) override {
+    if constexpr (mini::riemann::Diffusive<Riemann>) {
+      constexpr int kFields = Cell::kFields;
+      using Block = algebra::DynamicMatrix<Scalar>;
+      Scalar sqrt_epsilon = std::sqrt(std::numeric_limits<Scalar>::epsilon());
+      Column inverse_mass = Column::Ones(cell_data_size_);
+      this->ApplyInverseMass(&inverse_mass);
+      preconditioner_blocks_.resize(local_cells_.size());
+      Block block(kFields, kFields);
+      std::array<Scalar, kFields> coeffs, viscous, viscous_perturbed;
+      for (Cell *cell_ptr : part_ptr()->GetLocalCellPointers()) {
+        auto i_cell = cell_ptr->id();
+        auto &polynomial = cell_ptr->polynomial();
+        polynomial.WriteCoeffTo(coeffs.data());
+        WriteViscousCellResidualTo(*cell_ptr, viscous.data());
+        for (int j = 0; j < kFields; ++j) {
+          Scalar coeff_j = coeffs[j];
+          Scalar eps = sqrt_epsilon * std::max(Scalar(1), std::abs(coeff_j));
+          coeffs[j] += eps;
+          polynomial.GetCoeffFrom(coeffs.data());
+          WriteViscousCellResidualTo(*cell_ptr, viscous_perturbed.data());
+          coeffs[j] = coeff_j;
+          for (int i = 0; i < kFields; ++i) {
+            block(i, j) = (viscous[i] - viscous_perturbed[i]) / eps;
+          }
+        }
+        polynomial.GetCoeffFrom(coeffs.data());
+        Scalar const *inverse_mass_data = AddCellDataOffset(inverse_mass,
+            i_cell);
+        for (int i = 0; i < kFields; ++i) {
+          block.row(i) *= gamma_dt * inverse_mass_data[i];
+          block(i, i) += 1;
+        }
+        preconditioner_blocks_[i_cell].compute(block);
+      }
+    }
+  }
+
+  void ApplyPreconditioner(Column *column) const override {
+    if (preconditioner_blocks_.empty()) {
+      return;
+    }
+    ForEachLocalCell([this, column](Cell const &cell) {
+      auto i_cell = cell.id();
+      auto block_column = Eigen::Map<algebra::DynamicVector<Scalar>>(
+          this->AddCellDataOffset(column, i_cell), Cell::kFields);
+      block_column = preconditioner_blocks_[i_cell].solve(block_column).eval();
+    });
+  }
+
+ public:  // implement virtual methods declared in temporal::SteadySystem
+  void WriteLocalTimeStepsTo(Column *local_dt, int rk_order) const override {
+    local_dt->resize(cell_data_size_);
+    ForEachLocalCell([this, local_dt, rk_order](Cell const &cell) {
+      std::fill_n(this->AddCellDataOffset(local_dt, cell.id()), Cell::kFields,
+          this->GetLocalTimeStep(cell, rk_order));
+    });
+  }
+  std::pair<Scalar, Scalar> GetNorms(Column const &column) const override {
+    Scalar squared_norm = column.squaredNorm(), max_norm = 0;
+    if (column.size()) {
+      max_norm = column.cwiseAbs().maxCoeff();
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &squared_norm, 1, kMpiRealType, MPI_SUM,
+        part().mpi_comm());
+    MPI_Allreduce(MPI_IN_PLACE, &max_norm, 1, kMpiRealType, MPI_MAX,
+        part().mpi_comm());
+    return { std::sqrt(squared_norm), max_norm };
+  }
+
+ protected:
+  /**
+   * @brief Whether viscous fluxes are skipped, which is true only during the lifetime of a ConvectionOnlyGuard.
+   *
+   */
+  static bool IsConvectionOnly() {
+    return convection_only_;
+  }
+  /**
+   * @brief Whether convective fluxes and sources are skipped, which is true only during the lifetime of a ViscousOnlyGuard.
+   *
+   */
+  static bool IsViscousOnly() {
+    return viscous_only_;
+  }
+  /**
+   * @brief Whether viscous fluxes are added on faces, which is false in schemes integrating viscous terms only inside cells.
+   *
+   */
+  virtual bool HasViscousFluxOnFaces() const {
+    return true;
   }
 
+ private:
+  static inline const MPI_Datatype kMpiRealType
+      = sizeof(Scalar) == 8 ? MPI_DOUBLE : MPI_FLOAT;
+  // read by static flux methods, so they are shared by all instances
+  static inline bool convection_only_ = false;
+  static inline bool viscous_only_ = false;
+
+  /**
+   * @brief Set a mode flag in the scope of this object, and restore its previous value on exit, even if an exception is thrown.
+   *
+   * It must be created outside parallel regions, since all threads read the same flag.
+   */
+  class ModeGuard {
+    bool *flag_;
+    bool previous_;
+
+   protected:
+    explicit ModeGuard(bool *flag)
+        : flag_(flag), previous_(*flag) {
+      *flag_ = true;
+    }
+
+   public:
+    ModeGuard(const ModeGuard &) = delete;
+    ModeGuard &operator=(const ModeGuard &) = delete;
+    ~ModeGuard() noexcept {
+      *flag_ = previous_;
+    }
+  };
+  // Skip viscous fluxes in its scope.
+  struct ConvectionOnlyGuard : public ModeGuard {
+    ConvectionOnlyGuard()
+        : ModeGuard(&convection_only_) {
+    }
+  };
+  // Skip convective fluxes and sources in its scope.
+  struct ViscousOnlyGuard : public ModeGuard {
+    ViscousOnlyGuard()
+        : ModeGuard(&viscous_only_) {
+    }
+  };
+
+  // [i_cell] -> the LU factorization of a block of the preconditioner
+  std::vector<Eigen::PartialPivLU<algebra::DynamicMatrix<Scalar>>>
+      preconditioner_blocks_;
+
+  void WriteViscousCellResidualTo(Cell const &cell, Scalar *viscous) const {
+    std::fill_n(viscous, Cell::kFields, 0);
+    auto guard = ViscousOnlyGuard();
+    AddCellLocalResidual(cell, viscous);
+  }
+
+ protected:  // halo exchange overlapped with computation in WriteResidualTo
+  /**
+   * @brief Start sending data on inter cells to, and receiving data on ghost cells from, neighboring `Part`s.
+   * 
+   * Only coeffs (or their traces, see ShareTracesOnly) are shared here. Subclasses needing more data on ghost cells should pack them into the same messages.
+   */
+  virtual void ShareGhostCellData() const {
+    if (share_traces_only_) {
+      ShareGhostFaceTraces();
+    } else {
+      part_ptr()->ShareGhostCellCoeffs();
+    }
+  }
+
+  /**
+   * @brief Wait for the sharing started by ShareGhostCellData, and unpack the received data.
+   * 
+   */
+  virtual void UpdateGhostCellData() const {
+    if (share_traces_only_) {
+      UpdateGhostFaceTraces();
+    } else {
+      part_ptr()->UpdateGhostCellCoeffs();
+    }
+  }
+
+  /**
+   * @brief Let WriteResidualTo share coeffs of ghost cells only on their nodes on ghost faces (i.e. traces), instead of on whole cells.
+   * 
+   * It suits nodal schemes without diffusion, in which the flux on a face only depends on the coeffs on its nodes.
+   * Coeffs on other nodes of ghost cells are left unchanged, so they are only valid after a full exchange (e.g. in Approximate).
+   * 
+   * @param face_to_holder_nodes `(Face const &) -> range of the holder's nodes on the face`
+   * @param face_to_sharer_nodes `(Face const &) -> range of the sharer's nodes on the face`
+   */
+  template <class FaceToHolderNodes, class FaceToSharerNodes>
+  void ShareTracesOnly(FaceToHolderNodes &&face_to_holder_nodes,
+      FaceToSharerNodes &&face_to_sharer_nodes)
+      requires(!mini::riemann::Diffusive<Riemann>) {
+    auto sorted = [](auto &&nodes) {
+      auto sorted_nodes = std::vector<int16_t>();
+      for (auto node : nodes) {
+        sorted_nodes.emplace_back(node);
+      }
+      // The sender and the receiver of a trace number nodes on the same cell,
+      // so they agree on their sorted order.
+      std::ranges::sort(sorted_nodes);
+      return sorted_nodes;
+    };
+    holder_trace_nodes_.clear();
+    sharer_trace_nodes_.clear();
+    int n_nodes = 0;
+    for (Face const &face : part().GetGhostFaces()) {
+      if (holder_trace_nodes_.empty()) {
+        i_head_ghost_face_ = face.id();
+      }
+      assert(face.id() == i_head_ghost_face_ + holder_trace_nodes_.size());
+      auto &holder_nodes = holder_trace_nodes_.emplace_back(
+          sorted(face_to_holder_nodes(face)));
+      auto &sharer_nodes = sharer_trace_nodes_.emplace_back(
+          sorted(face_to_sharer_nodes(face)));
+      n_nodes = holder_nodes.size();
+      assert(n_nodes == sharer_nodes.size());
+      assert(n_nodes == holder_trace_nodes_.front().size());
+    }
+    trace_halo_ = part().BuildFaceHalo(n_nodes * Cell::K);
+    share_traces_only_ = true;
+  }
+
+ private:
+  bool share_traces_only_ = false;
+  Index i_head_ghost_face_ = 0;
+  // [i_face - i_head_ghost_face_] -> sorted nodes on the face
+  std::vector<std::vector<int16_t>> holder_trace_nodes_, sharer_trace_nodes_;
+  // buffers and requests used by the const methods of WriteResidualTo
+  mutable typename Part::Halo trace_halo_;
+
+  void ShareGhostFaceTraces() const {
+    auto operation = [this](Face const *face_ptr, Scalar *data) -> Scalar * {
+      auto const &coeff = face_ptr->holder().polynomial().coeff();
+      auto i_ghost_face = face_ptr->id() - i_head_ghost_face_;
+      for (int node : holder_trace_nodes_[i_ghost_face]) {
+        for (int k = 0; k < Cell::K; ++k) {
+          *data++ = coeff(k, node);
+        }
+      }
+      return data;
+    };
+    part_ptr()->ShareGhostFaceData(&trace_halo_, operation);
+  }
+
+  void UpdateGhostFaceTraces() const {
+    auto operation = [this](Face *face_ptr, Scalar const *data)
+        -> Scalar const * {
+      auto &polynomial = face_ptr->sharer_ptr()->polynomial();
+      auto i_ghost_face = face_ptr->id() - i_head_ghost_face_;
+      for (int node : sharer_trace_nodes_[i_ghost_face]) {
+        Value value;
+        for (int k = 0; k < Cell::K; ++k) {
+          value[k] = *data++;
+        }
+        polynomial.SetCoeff(node, value);
+      }
+      return data;
+    };
+    part_ptr()->UpdateGhostFaceData(&trace_halo_, operation);
+  }
+
+ public:
+
   void AddFluxOnBoundaries(Column *residual) const {
 #ifdef ENABLE_LOGGING
     log() << "Enter " << fullname() << "::AddFluxOnBoundaries\n";
@@ -317,6 +742,16 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
    */
   virtual void AddFluxDivergence(Cell const &cell, Scalar *residual) const = 0;
 
+  /**
+   * @brief Multiply a FiniteElement::Column of integrals by the inverse of the mass matrix, which is done at the end of WriteResidualTo.
+   *
+   * It does nothing by default, since the mass matrix of an orthonormal basis is the identity.
+   *
+   * @param column the FiniteElement::Column to be scaled in place
+   */
+  virtual void ApplyInverseMass(Column *column) const {
+  }
+
   /**
    * @brief Add the flux divergence to the residual FiniteElement::Column of the given FiniteElement::Part.
    * 
@@ -328,10 +763,15 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
     if (Part::kDegrees == 0) {
       return;
     }
-    for (const Cell &cell : part().GetLocalCells()) {
-      auto *data = this->AddCellDataOffset(residual, cell.id());
-      this->AddFluxDivergence(cell, data);
-    }
+    ForEachLocalCell([this, residual](Cell const &cell) {
+      auto i_cell = cell.id();
+      // Cells next to active faces are evaluated even if they are inactive,
+      // since some schemes (e.g. FR) cache data for faces here.
+      if (!IsActive(touched_levels(i_cell))) {
+        return;
+      }
+      this->AddFluxDivergence(cell, this->AddCellDataOffset(residual, i_cell));
+    });
   }
 
   /**
@@ -344,23 +784,92 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
   virtual void AddFluxToHolderAndSharer(Face const &face,
       Scalar *holder_data, Scalar *sharer_data) const = 0;
 
-  virtual void AddFluxToHolder(Face const &face, Scalar *holder_data) const {
-  }
-  virtual void AddFluxToSharer(Face const &face, Scalar *sharer_data) const {
+  /**
+   * @brief Add the flux on the given FiniteElement::Face to the residual of one of its FiniteElement::Cell's, as if the coeffs on the other side were zero.
+   *
+   * Upwind fluxes of the convective part are not added, since they make no sense for a zero state, so only viscous fluxes (if any) on the FiniteElement::Face are involved.
+   * They are called by AddCellLocalResidual and must be implemented in a concrete class.
+   *
+   * @param face the FiniteElement::Face to be processed
+   * @param holder_data the residual column of the holder FiniteElement::Cell of the given FiniteElement::Face
+   */
+  virtual void AddFluxToHolder(Face const &face, Scalar *holder_data) const = 0;
+  virtual void AddFluxToSharer(Face const &face, Scalar *sharer_data) const = 0;
+
+  /**
+   * @brief Add the residual of the given FiniteElement::Cell, in which fluxes on its faces are given by AddFluxToHolder and AddFluxToSharer, to its residual column.
+   *
+   * Only the coeffs on the given FiniteElement::Cell are read, so the result can be built cell by cell (e.g. the damping matrices of the energy-based viscosity, or the blocks of the implicit preconditioner).
+   *
+   * @param cell the FiniteElement::Cell to be processed
+   * @param residual the residual column of the given FiniteElement::Cell
+   */
+  void AddCellLocalResidual(Cell const &cell, Scalar *residual) const {
+    this->AddFluxDivergence(cell, residual);
+    for (Face const *face : cell.adj_faces_) {
+      if (&face->holder() == &cell) {
+        this->AddFluxToHolder(*face, residual);
+      } else {
+        this->AddFluxToSharer(*face, residual);
+      }
+    }
+    assert(cell.adj_cells_.size() == cell.adj_faces_.size());
+    for (Face const *face : cell.boundary_faces_) {
+      assert(&face->holder() == &cell);
+      assert(nullptr == face->other(&cell));
+      assert(face->HolderToSharer().dot(face->center() - cell.center()) > 0);
+      this->AddFluxToHolder(*face, residual);
+    }
   }
 
   /**
    * @brief Add the fluxes on local (requiring no MPI communication) FiniteElement::Face's to the residual FiniteElement::Column of the given FiniteElement::Part.
    * 
    * It delegates the work to the pure virtual method FiniteElement::AddFluxToHolderAndSharer, which must be implemented in a concrete class.
+   * Faces in the same group are distributed over OpenMP threads, since they share no cell.
    * 
    * @param residual the residual FiniteElement::Column of the given FiniteElement::Part
    */
   void AddFluxOnLocalFaces(Column *residual) const {
-    for (const Face &face : this->part().GetLocalFaces()) {
-      this->AddFluxToHolderAndSharer(face,
-          this->AddCellDataOffset(residual, face.holder().id()),
-          this->AddCellDataOffset(residual, face.sharer().id()));
+    for (auto const &faces : local_face_groups_) {
+      auto n_faces = static_cast<Index>(faces.size());
+#pragma omp parallel for schedule(static)
+      for (Index i_face = 0; i_face < n_faces; ++i_face) {
+        Face const &face = *faces[i_face];
+        auto i_holder = face.holder().id(), i_sharer = face.sharer().id();
+        Scalar *holder_data = this->AddCellDataOffset(residual, i_holder);
+        Scalar *sharer_data = this->AddCellDataOffset(residual, i_sharer);
+        int holder_level = cell_levels(i_holder);
+        int sharer_level = cell_levels(i_sharer);
+        int level = std::min(holder_level, sharer_level);
+        if (!IsActive(level)) {
+          continue;
+        }
+        if (holder_level == sharer_level || correction_ == nullptr) {
+          this->AddFluxToHolderAndSharer(face, holder_data, sharer_data);
+          continue;
+        }
+        // The coarser side predicts the flux at its own rate, and the
+        // difference from the finer rate goes into the correction.
+        std::array<Scalar, Cell::kFields> holder_flux, sharer_flux;
+        holder_flux.fill(0);
+        sharer_flux.fill(0);
+        this->AddFluxToHolderAndSharer(face,
+            holder_flux.data(), sharer_flux.data());
+        Scalar scale = GetScale(level);
+        Scalar holder_scale = scale - GetScale(holder_level);
+        Scalar sharer_scale = scale - GetScale(sharer_level);
+        Scalar *holder_correction = this->AddCellDataOffset(correction_,
+            i_holder);
+        Scalar *sharer_correction = this->AddCellDataOffset(correction_,
+            i_sharer);
+        for (int i = 0; i < Cell::kFields; ++i) {
+          holder_data[i] += holder_flux[i];
+          sharer_data[i] += sharer_flux[i];
+          holder_correction[i] += holder_flux[i] * holder_scale;
+          sharer_correction[i] += sharer_flux[i] * sharer_scale;
+        }
+      }
     }
   }
 
@@ -372,10 +881,15 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
    * @param residual the residual FiniteElement::Column of the given FiniteElement::Part
    */
   void AddFluxOnGhostFaces(Column *residual) const {
-    for (const Face &face : this->part().GetGhostFaces()) {
-      this->AddFluxToHolderAndSharer(face,
-          this->AddCellDataOffset(residual, face.holder().id()),
-          nullptr);
+    for (auto const &faces : ghost_face_groups_) {
+      auto n_faces = static_cast<Index>(faces.size());
+#pragma omp parallel for schedule(static)
+      for (Index i_face = 0; i_face < n_faces; ++i_face) {
+        Face const &face = *faces[i_face];
+        this->AddFluxToHolderAndSharer(face,
+            this->AddCellDataOffset(residual, face.holder().id()),
+            nullptr);
+      }
     }
   }
 
@@ -397,9 +911,16 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
   static FluxMatrix _GetFluxMatrix(const Cell &cell, int q)
       requires(mini::riemann::ConvectiveDiffusive<Riemann>) {
     auto [value, gradient] = cell.polynomial().GetGlobalValueGradient(q);
-    FluxMatrix flux_matrix = Riemann::Convection::GetFluxMatrix(value);
-    const auto &property = Riemann::Diffusion::GetPropertyOnCell(cell.id(), q);
-    Riemann::MinusViscousFlux(&flux_matrix, property, value, gradient);
+    FluxMatrix flux_matrix;
+    if (viscous_only_) {
+      flux_matrix.setZero();
+    } else {
+      flux_matrix = Riemann::Convection::GetFluxMatrix(value);
+    }
+    if (!convection_only_) {
+      const auto &property = Riemann::Diffusion::GetPropertyOnCell(cell.id(), q);
+      Riemann::MinusViscousFlux(&flux_matrix, property, value, gradient);
+    }
     return flux_matrix;
   }
 
@@ -409,30 +930,134 @@ class FiniteElement : public temporal::System<typename P::Scalar> {
   }
 
  protected:
+  /**
+   * @brief Get the CFL number of a Runge--Kutta method on the current degree.
+   *
+   * @param rk_order the order of temporal::RungeKutta
+   * @return the CFL number
+   */
   static Scalar GetCflNumber(int rk_order) {
     return cfl_[rk_order][Part::kDegrees];
   }
 
  public:
   virtual Scalar GetTimeStep(Scalar dt_guess, int rk_order) const {
-    auto GetMaximumSpeed = [](Cell const &cell) -> Scalar {
-      Scalar speed, max_speed{ 1e-5/* avoid 0 in divisor */ };
-      auto const &polynomial = cell.polynomial();
-      for (int i = 0; i < Cell::N; ++i) {
-          speed = Riemann::Convection::GetMaximumSpeed(
-              polynomial.GetValue(i));
-          max_speed = std::max(max_speed, speed);
-      }
-      return max_speed;
-    };
     Scalar min_dt = 1.e+100;
-    for (Cell const &curr_cell : part().GetLocalCells()) {
-      min_dt = std::min(min_dt,
-          curr_cell.length() / GetMaximumSpeed(curr_cell));
+    auto n_cells = static_cast<Index>(local_cells_.size());
+#pragma omp parallel for schedule(static) reduction(min: min_dt)
+    for (Index i_cell = 0; i_cell < n_cells; ++i_cell) {
+      min_dt = std::min(min_dt, GetConvectiveTime(*local_cells_[i_cell]));
     }
     Scalar dt = GetCflNumber(rk_order) * min_dt;
     return std::min(dt, dt_guess);
   }
+  /**
+   * @brief Get the stable time step of a given Runge--Kutta method, whose CFL number is got through temporal::CflTraits.
+   *
+   * @tparam Solver the type of the Runge--Kutta method
+   * @param dt_guess the upper bound of the time step
+   * @return the stable time step
+   */
+  template <class Solver>
+  Scalar GetStableTimeStep(Scalar dt_guess) const {
+    using Traits = temporal::CflTraits<Solver>;
+    // min(ratio * dt, dt_guess) == ratio * min(dt, dt_guess / ratio)
+    return Traits::kRatio * GetTimeStep(dt_guess / Traits::kRatio,
+        Traits::kRkOrder);
+  }
+
+  /**
+   * @brief Get the stable time step on a given FiniteElement::Cell.
+   *
+   * @param cell the FiniteElement::Cell to be evaluated
+   * @param rk_order the order of the Runge--Kutta method
+   * @return the stable time step on the given FiniteElement::Cell
+   */
+  virtual Scalar GetLocalTimeStep(Cell const &cell, int rk_order) const {
+    return GetCflNumber(rk_order) * GetConvectiveTime(cell);
+  }
+
+  /**
+   * @brief Assign each local FiniteElement::Cell to the coarsest level of local time stepping that is stable on it.
+   *
+   * Level `l` is advanced by `2^l * dt_min`, so the caller should advance the whole FiniteElement by a macro step of `2^(n_levels - 1) * dt_min` with temporal::LocalTimeStepping.
+   * Cells next to other `Part`s are kept on the finest level, so that every `Part` runs the same schedule without communicating levels.
+   * Cells on boundaries may be on any level, since the fluxes on their boundary faces are scaled with their whole residuals.
+   * The levels of two cells sharing a face differ by at most 1, so that each flux correction only spans two adjacent rates.
+   *
+   * @param dt_min the step of the finest level, which should be the global minimum of GetTimeStep
+   * @param rk_order the order of the Runge--Kutta method
+   * @param n_levels the number of levels, which must be the same on all `Part`s
+   */
+  void UpdateTimeLevels(Scalar dt_min, int rk_order, int n_levels) {
+    assert(1 <= n_levels && n_levels <= 8 * sizeof(int) - 2);
+    n_time_levels_ = n_levels;
+    auto n_cells = static_cast<Index>(local_cells_.size());
+    cell_levels_.resize(n_cells);
+    touched_levels_.resize(n_cells);
+    ForEachLocalCell([this, dt_min, rk_order, n_levels](Cell const &cell) {
+      Scalar ratio = GetLocalTimeStep(cell, rk_order) / dt_min;
+      int level = std::floor(std::log2(std::max(ratio, Scalar(1))));
+      cell_levels_[cell.id()] = std::min(level, n_levels - 1);
+    });
+    for (Face const &face : part().GetGhostFaces()) {
+      cell_levels_[face.holder().id()] = 0;
+    }
+    // Limit the jump across each face by refining the coarser side.
+    for (bool changed = true; changed; ) {
+      changed = false;
+      for (Face const &face : part().GetLocalFaces()) {
+        auto &holder_level = cell_levels_[face.holder().id()];
+        auto &sharer_level = cell_levels_[face.sharer().id()];
+        if (holder_level > sharer_level + 1) {
+          holder_level = sharer_level + 1;
+          changed = true;
+        } else if (sharer_level > holder_level + 1) {
+          sharer_level = holder_level + 1;
+          changed = true;
+        }
+      }
+    }
+    touched_levels_ = cell_levels_;
+    for (Face const &face : part().GetLocalFaces()) {
+      auto i_holder = face.holder().id(), i_sharer = face.sharer().id();
+      auto level = std::min(cell_levels_[i_holder], cell_levels_[i_sharer]);
+      touched_levels_[i_holder] = std::min(touched_levels_[i_holder], level);
+      touched_levels_[i_sharer] = std::min(touched_levels_[i_sharer], level);
+    }
+  }
+
+ private:
+  // [i_cell] -> the level of local time stepping
+  std::vector<int8_t> cell_levels_;
+  // [i_cell] -> the finest level of the cell and its faces
+  std::vector<int8_t> touched_levels_;
+  int n_time_levels_ = 1;
+  int i_substep_ = -1;
+  // set by WriteSplitResidualTo only
+  mutable Column *correction_ = nullptr;
+
+  int cell_levels(Index i_cell) const {
+    return n_time_levels_ == 1 ? 0 : cell_levels_[i_cell];
+  }
+  int touched_levels(Index i_cell) const {
+    return n_time_levels_ == 1 ? 0 : touched_levels_[i_cell];
+  }
+  bool IsActive(int level) const {
+    return i_substep_ < 0 || i_substep_ % (1 << level) == 0;
+  }
+  Scalar GetScale(int level) const {
+    return i_substep_ < 0 ? 1 : (IsActive(level) ? (1 << level) : 0);
+  }
+  static Scalar GetConvectiveTime(Cell const &cell) {
+    Scalar speed, max_speed{ 1e-5/* avoid 0 in divisor */ };
+    auto const &polynomial = cell.polynomial();
+    for (int i = 0; i < Cell::N; ++i) {
+      speed = Riemann::Convection::GetMaximumSpeed(polynomial.GetValue(i));
+      max_speed = std::max(max_speed, speed);
+    }
+    return cell.length() / max_speed;
+  }
 };
 
 }  // namespace spatial
@@ -56,6 +56,16 @@ class General : public spatial::FiniteElement<P, R> {
   static constexpr int kFaceQ = kLineQ * kLineQ;
   static constexpr int kCellQ = kLineQ * kFaceQ;
 
+  static constexpr bool BatchedOnFaces() {
+    if constexpr (mini::riemann::Batched<Riemann>
+        && !mini::riemann::Diffusive<Riemann>) {
+      return kFaceQ <= Riemann::kMaxBatch;
+    } else {
+      return false;
+    }
+  }
+  static constexpr bool kBatchedOnFaces = BatchedOnFaces();
+
   struct SolutionPointCache {
     Scalar g_prime;
     int ijk;
@@ -228,6 +238,16 @@ class General : public spatial::FiniteElement<P, R> {
     auto boundary_faces = this->part().GetBoundaryFaces();
     CacheCorrectionGradients(boundary_faces, face_to_holder, &holder_cache_);
     flux_matrices_.resize(this->part().CountLocalCells());
+    if constexpr (!mini::riemann::Diffusive<Riemann>) {
+      // Only values on flux points are read from ghost cells.
+      auto to_ijk = std::views::transform(
+          [](LineCache const &line) { return line.second.ijk; });
+      this->ShareTracesOnly(
+          [this, to_ijk](Face const &face) {
+            return holder_cache_[face.id()] | to_ijk; },
+          [this, to_ijk](Face const &face) {
+            return sharer_cache_[face.id()] | to_ijk; });
+    }
   }
   General(const General &) = default;
   General &operator=(const General &) = default;
@@ -246,28 +266,29 @@ class General : public spatial::FiniteElement<P, R> {
          - face.sharer().polynomial().GetValue(sharer_flux_point.ijk);
   }
 
-  Column GetResidualColumn() const override {
-    Column residual = this->Base::GetResidualColumn();
+  void WriteResidualTo(Column *residual) const override {
+    this->Base::WriteResidualTo(residual);
+    this->ApplyInverseMass(residual);
+  }
+
+ protected:  // override virtual methods defined in Base
+  void ApplyInverseMass(Column *column) const override {
     if (Polynomial::kLocal) {
-      return residual;
+      return;
     }
-    // TODO(PVC): define a virtual method in Base
     // divide Jacobian determinant for each DoF
-    for (const Cell &cell : this->part().GetLocalCells()) {
+    this->ForEachLocalCell([this, column](Cell const &cell) {
       auto i_cell = cell.id();
-      Scalar *data = this->AddCellDataOffset(&residual, i_cell);
+      Scalar *data = this->AddCellDataOffset(column, i_cell);
       const auto &integrator = cell.integrator();
       for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
         auto scale = 1.0 / integrator.GetJacobianDeterminant(q);
         data = cell.polynomial().ScaleValueAt(scale, data);
       }
-      assert(data == residual.data() + residual.size()
-          || data == this->AddCellDataOffset(&residual, i_cell + 1));
-    }
-    return residual;
+      assert(data == column->data() + column->size()
+          || data == this->AddCellDataOffset(column, i_cell + 1));
+    });
   }
-
- protected:  // override virtual methods defined in Base
   void AddFluxDivergence(Cell const &cell, Scalar *residual) const override {
     assert(residual);
     const auto &integrator = cell.integrator();
@@ -277,13 +298,17 @@ class General : public spatial::FiniteElement<P, R> {
       FluxMatrix global_flux = Base::GetFluxMatrix(cell, q);
       flux[q] = polynomial.GlobalFluxToLocalFlux(global_flux, q);
     }
-    for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
-      auto const &grad = polynomial.GetBasisLocalGradients(q);
-      Value value = flux[0] * grad.col(0);
-      for (int k = 1; k < n; ++k) {
-        value += flux[k] * grad.col(k);
+    if constexpr (polynomial::TensorProduct<Polynomial>) {
+      Polynomial::MinusFluxDivergence(flux, residual);
+    } else {
+      for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
+        auto const &grad = polynomial.GetBasisLocalGradients(q);
+        Value value = flux[0] * grad.col(0);
+        for (int k = 1; k < n; ++k) {
+          value += flux[k] * grad.col(k);
+        }
+        Polynomial::MinusValue(value, residual, q);
       }
-      Polynomial::MinusValue(value, residual, q);
     }
   }
 
@@ -301,6 +326,18 @@ class General : public spatial::FiniteElement<P, R> {
     Value u_holder = holder.polynomial().GetValue(holder_cache.ijk);
     Value u_sharer = sharer.polynomial().GetValue(sharer_cache.ijk);
     Value f_upwind = riemann.GetFluxUpwind(u_holder, u_sharer);
+    return SplitUpwindFlux(f_upwind, u_sharer, holder, holder_cache,
+        sharer, sharer_cache, use_cached_flux_on_sharer);
+  }
+  /**
+   * @brief Get the flux corrections on both sides from a given upwind flux.
+   */
+  std::pair<Value, Value> SplitUpwindFlux(Value const &f_upwind,
+      Value const &u_sharer,
+      const Cell &holder, FluxPointCache const &holder_cache,
+      const Cell &sharer, FluxPointCache const &sharer_cache,
+      bool use_cached_flux_on_sharer) const
+      requires(!mini::riemann::Diffusive<Riemann>) {
     assert(Collinear(holder_cache.normal, sharer_cache.normal));
     Value f_holder = f_upwind * holder_cache.scale;
     MinusCachedFlux(&f_holder, holder.id(), holder_cache);
@@ -322,7 +359,10 @@ class General : public spatial::FiniteElement<P, R> {
         holder.polynomial().GetGlobalValueGradientHessian(holder_cache.ijk);
     auto [u_sharer, du_sharer, ddu_sharer] =
         sharer.polynomial().GetGlobalValueGradientHessian(sharer_cache.ijk);
-    Value f_upwind = riemann.GetFluxUpwind(u_holder, u_sharer);
+    Value f_upwind = Value::Zero();
+    if (!Base::IsViscousOnly()) {
+      f_upwind = riemann.GetFluxUpwind(u_holder, u_sharer);
+    }
     assert(Collinear(holder_cache.normal, sharer_cache.normal));
     const auto &normal = riemann.normal();
     auto du_common = riemann.GetCommonGradient(normal,
@@ -333,17 +373,28 @@ class General : public spatial::FiniteElement<P, R> {
     property += Riemann::Diffusion::GetPropertyOnCell(
         sharer.id(), sharer_cache.ijk);
     property *= 0.5;
-    Riemann::MinusViscousFlux(&f_upwind, property, u_common, du_common, normal);
+    if (!Base::IsConvectionOnly()) {
+      Riemann::MinusViscousFlux(&f_upwind, property, u_common, du_common,
+          normal);
+    }
     Value f_holder = f_upwind * holder_cache.scale;
     MinusCachedFlux(&f_holder, holder.id(), holder_cache);
     Value f_sharer = f_upwind * (-sharer_cache.scale);
     if (use_cached_flux_on_sharer) {
       MinusCachedFlux(&f_sharer, sharer.id(), sharer_cache);
     } else {
-      auto f_mat_sharer = Riemann::Convection::GetFluxMatrix(u_sharer);
+      FluxMatrix f_mat_sharer;
+      if (Base::IsViscousOnly()) {
+        f_mat_sharer.setZero();
+      } else {
+        f_mat_sharer = Riemann::Convection::GetFluxMatrix(u_sharer);
+      }
       const auto &property = Riemann::Diffusion::GetPropertyOnCell(
           sharer.id(), sharer_cache.ijk);
-      Riemann::MinusViscousFlux(&f_mat_sharer, property, u_sharer, du_sharer);
+      if (!Base::IsConvectionOnly()) {
+        Riemann::MinusViscousFlux(&f_mat_sharer, property, u_sharer,
+            du_sharer);
+      }
       f_sharer -= f_mat_sharer * sharer_cache.normal;
     }
     return { f_holder, f_sharer };
@@ -361,10 +412,11 @@ class General : public spatial::FiniteElement<P, R> {
     auto u_sharer = Value::Zero();
     auto du_sharer = Riemann::Gradient::Zero();
     auto ddu_sharer = Riemann::Hessian::Zero();
-#if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
-    Value f_upwind = riemann.GetFluxUpwind(u_holder, u_sharer);
-#else
     Value f_upwind = Value::Zero();
+#if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
+    if (!Base::IsViscousOnly()) {
+      f_upwind = riemann.GetFluxUpwind(u_holder, u_sharer);
+    }
 #endif
     const auto &normal = riemann.normal();
     auto du_common = riemann.GetCommonGradient(normal,
@@ -372,7 +424,10 @@ class General : public spatial::FiniteElement<P, R> {
     Value u_common = (u_holder + u_sharer) / 2;
     auto const &property = Riemann::Diffusion::GetPropertyOnCell(
         holder.id(), holder_cache.ijk);
-    Riemann::MinusViscousFlux(&f_upwind, property, u_common, du_common, normal);
+    if (!Base::IsConvectionOnly()) {
+      Riemann::MinusViscousFlux(&f_upwind, property, u_common, du_common,
+          normal);
+    }
     Value f_holder = f_upwind * holder_cache.scale;
     MinusCachedFlux(&f_holder, holder.id(), holder_cache);
     return f_holder;
@@ -390,10 +445,11 @@ class General : public spatial::FiniteElement<P, R> {
     auto ddu_holder = Riemann::Hessian::Zero();
     auto [u_sharer, du_sharer, ddu_sharer] =
         sharer.polynomial().GetGlobalValueGradientHessian(sharer_cache.ijk);
-#if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
-    Value f_upwind = riemann.GetFluxUpwind(u_holder, u_sharer);
-#else
     Value f_upwind = Value::Zero();
+#if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
+    if (!Base::IsViscousOnly()) {
+      f_upwind = riemann.GetFluxUpwind(u_holder, u_sharer);
+    }
 #endif
     const auto &normal = riemann.normal();
     auto du_common = riemann.GetCommonGradient(normal,
@@ -401,7 +457,10 @@ class General : public spatial::FiniteElement<P, R> {
     Value u_common = (u_holder + u_sharer) / 2;
     auto const &property = Riemann::Diffusion::GetPropertyOnCell(
         sharer.id(), sharer_cache.ijk);
-    Riemann::MinusViscousFlux(&f_upwind, property, u_common, du_common, normal);
+    if (!Base::IsConvectionOnly()) {
+      Riemann::MinusViscousFlux(&f_upwind, property, u_common, du_common,
+          normal);
+    }
     Value f_sharer = f_upwind * (-sharer_cache.scale);
     MinusCachedFlux(&f_sharer, sharer.id(), sharer_cache);
     return f_sharer;
@@ -414,6 +473,10 @@ class General : public spatial::FiniteElement<P, R> {
     auto const &holder_cache = holder_cache_[face.id()];
     auto const &sharer_cache = sharer_cache_[face.id()];
     assert(kFaceQ == face.integrator().CountPoints());
+    if constexpr (kBatchedOnFaces) {
+      AddBatchedFluxToHolderAndSharer(face, holder_data, sharer_data);
+      return;
+    }
     for (int f = 0; f < kFaceQ; ++f) {
       auto &[holder_solution_points, holder_flux_point] = holder_cache[f];
       auto &[sharer_solution_points, sharer_flux_point] = sharer_cache[f];
@@ -432,6 +495,76 @@ class General : public spatial::FiniteElement<P, R> {
       }
     }
   }
+  /**
+   * @brief Gather the values at all flux points on a face, solve the Riemann problems in one call, then scatter the corrections.
+   */
+  void AddBatchedFluxToHolderAndSharer(Face const &face,
+      Scalar *holder_data, Scalar *sharer_data) const
+      requires(kBatchedOnFaces) {
+    using Batch = typename Riemann::Batch;
+    const auto &holder = face.holder();
+    const auto &sharer = face.sharer();
+    auto const &holder_cache = holder_cache_[face.id()];
+    auto const &sharer_cache = sharer_cache_[face.id()];
+    Batch u_holder(kFaceQ, Riemann::kComponents), f_upwind;
+    Batch u_sharer(kFaceQ, Riemann::kComponents);
+    for (int f = 0; f < kFaceQ; ++f) {
+      u_holder.row(f) = holder.polynomial().GetValue(
+          holder_cache[f].second.ijk).transpose();
+      u_sharer.row(f) = sharer.polynomial().GetValue(
+          sharer_cache[f].second.ijk).transpose();
+    }
+    Riemann::GetFluxesUpwind(this->GetRiemannSolvers(face),
+        u_holder, u_sharer, &f_upwind);
+    for (int f = 0; f < kFaceQ; ++f) {
+      auto &[holder_solution_points, holder_flux_point] = holder_cache[f];
+      auto &[sharer_solution_points, sharer_flux_point] = sharer_cache[f];
+      auto [f_holder, f_sharer] = SplitUpwindFlux(
+          f_upwind.row(f).transpose(), u_sharer.row(f).transpose(),
+          holder, holder_flux_point,
+          sharer, sharer_flux_point, sharer_data);
+      assert(holder_data);
+      for (auto [g_prime, ijk] : holder_solution_points) {
+        Value f_correction = f_holder * g_prime;
+        Polynomial::MinusValue(f_correction, holder_data, ijk);
+      }
+      if (nullptr == sharer_data) { continue; }
+      for (auto [g_prime, ijk] : sharer_solution_points) {
+        Value f_correction = f_sharer * g_prime;
+        Polynomial::MinusValue(f_correction, sharer_data, ijk);
+      }
+    }
+  }
+  void AddFluxToHolder(Face const &face, Scalar *holder_data) const override {
+    const auto &riemanns = this->GetRiemannSolvers(face);
+    auto const &holder_cache = holder_cache_[face.id()];
+    assert(kFaceQ == face.integrator().CountPoints());
+    assert(holder_data);
+    for (int f = 0; f < kFaceQ; ++f) {
+      auto &[holder_solution_points, holder_flux_point] = holder_cache[f];
+      auto f_holder = GetFluxForHolder(riemanns[f],
+          face.holder(), holder_flux_point);
+      for (auto [g_prime, ijk] : holder_solution_points) {
+        Value f_correction = f_holder * g_prime;
+        Polynomial::MinusValue(f_correction, holder_data, ijk);
+      }
+    }
+  }
+  void AddFluxToSharer(Face const &face, Scalar *sharer_data) const override {
+    const auto &riemanns = this->GetRiemannSolvers(face);
+    auto const &sharer_cache = sharer_cache_[face.id()];
+    assert(kFaceQ == face.integrator().CountPoints());
+    assert(sharer_data);
+    for (int f = 0; f < kFaceQ; ++f) {
+      auto &[sharer_solution_points, sharer_flux_point] = sharer_cache[f];
+      auto f_sharer = GetFluxForSharer(riemanns[f],
+          face.sharer(), sharer_flux_point);
+      for (auto [g_prime, ijk] : sharer_solution_points) {
+        Value f_correction = f_sharer * g_prime;
+        Polynomial::MinusValue(f_correction, sharer_data, ijk);
+      }
+    }
+  }
   void AddFluxOnInviscidWalls(Column *residual) const override {
     for (const auto &name : this->inviscid_wall_) {
       for (const Face &face : this->part().GetBoundaryFaces(name)) {
@@ -462,14 +595,19 @@ class General : public spatial::FiniteElement<P, R> {
       requires(mini::riemann::ConvectiveDiffusive<Riemann>) {
     auto [u_holder, du_holder] =
         holder.polynomial().GetGlobalValueGradient(holder_cache.ijk);
-    Value f_upwind = riemann.GetFluxOnInviscidWall(u_holder);
+    Value f_upwind = Value::Zero();
+    if (!Base::IsViscousOnly()) {
+      f_upwind = riemann.GetFluxOnInviscidWall(u_holder);
+    }
     const auto &normal = riemann.normal();
     assert(Collinear(normal, holder_cache.normal));
     Scalar value_penalty = riemann.GetValuePenalty();
     auto const &property = Riemann::Diffusion::GetPropertyOnCell(
         holder.id(), holder_cache.ijk);
-    Riemann::MinusViscousFluxOnNoSlipWall(&f_upwind, property, wall_value,
-        u_holder, du_holder, normal, value_penalty);
+    if (!Base::IsConvectionOnly()) {
+      Riemann::MinusViscousFluxOnNoSlipWall(&f_upwind, property, wall_value,
+          u_holder, du_holder, normal, value_penalty);
+    }
     Value f_holder = f_upwind * holder_cache.scale;
     MinusCachedFlux(&f_holder, holder.id(), holder_cache);
     return f_holder;
@@ -487,10 +625,15 @@ class General : public spatial::FiniteElement<P, R> {
       Cell const &holder, FluxPointCache const &holder_cache) const
       requires(mini::riemann::ConvectiveDiffusive<Riemann>) {
     auto const &u_holder = holder.polynomial().GetValue(holder_cache.ijk);
-    auto f_upwind = riemann.GetFluxOnInviscidWall(u_holder);
+    Value f_upwind = Value::Zero();
+    if (!Base::IsViscousOnly()) {
+      f_upwind = riemann.GetFluxOnInviscidWall(u_holder);
+    }
     auto const &property = Riemann::Diffusion::GetPropertyOnCell(
         holder.id(), holder_cache.ijk);
-    riemann.MinusViscousFluxOnNeumannWall(&f_upwind, property, u_holder);
+    if (!Base::IsConvectionOnly()) {
+      riemann.MinusViscousFluxOnNeumannWall(&f_upwind, property, u_holder);
+    }
     Value f_holder = f_upwind * holder_cache.scale;
     MinusCachedFlux(&f_holder, holder.id(), holder_cache);
     return f_holder;
@@ -509,10 +652,15 @@ class General : public spatial::FiniteElement<P, R> {
       Cell const &holder, FluxPointCache const &holder_cache) const
       requires(mini::riemann::ConvectiveDiffusive<Riemann>) {
     auto const &u_holder = holder.polynomial().GetValue(holder_cache.ijk);
-    auto f_upwind = riemann.GetFluxOnSupersonicOutlet(u_holder);
+    Value f_upwind = Value::Zero();
+    if (!Base::IsViscousOnly()) {
+      f_upwind = riemann.GetFluxOnSupersonicOutlet(u_holder);
+    }
     auto const &property = Riemann::Diffusion::GetPropertyOnCell(
         holder.id(), holder_cache.ijk);
-    riemann.MinusViscousFluxOnNeumannWall(&f_upwind, property, u_holder);
+    if (!Base::IsConvectionOnly()) {
+      riemann.MinusViscousFluxOnNeumannWall(&f_upwind, property, u_holder);
+    }
     Value f_holder = f_upwind * holder_cache.scale;
     MinusCachedFlux(&f_holder, holder.id(), holder_cache);
     return f_holder;
@@ -552,7 +700,10 @@ class General : public spatial::FiniteElement<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSupersonicInlet(u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSupersonicInlet(u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           for (auto [g_prime, ijk] : holder_solution_points) {
@@ -577,7 +728,10 @@ class General : public spatial::FiniteElement<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSubsonicInlet(u_holder, u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSubsonicInlet(u_holder, u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           for (auto [g_prime, ijk] : holder_solution_points) {
@@ -602,7 +756,10 @@ class General : public spatial::FiniteElement<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSubsonicOutlet(u_holder, u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSubsonicOutlet(u_holder, u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           for (auto [g_prime, ijk] : holder_solution_points) {
@@ -627,7 +784,10 @@ class General : public spatial::FiniteElement<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSmartBoundary(u_holder, u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSmartBoundary(u_holder, u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           for (auto [g_prime, ijk] : holder_solution_points) {
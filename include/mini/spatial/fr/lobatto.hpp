@@ -220,6 +220,9 @@ class Lobatto : public General<P, R> {
   Scalar GetTimeStep(Scalar dt_guess, int rk_order) const override {
     return std::min(dt_guess, 2.0 * Base::GetTimeStep(dt_guess, rk_order));
   }
+  Scalar GetLocalTimeStep(Cell const &cell, int rk_order) const override {
+    return 2.0 * Base::GetLocalTimeStep(cell, rk_order);
+  }
 
   Value GetValueJump(Face const &face, int i_flux_point) const override {
     auto &holder_flux_point = holder_cache_[face.id()][i_flux_point];
@@ -235,6 +238,10 @@ class Lobatto : public General<P, R> {
     auto const &holder_cache = holder_cache_[face.id()];
     auto const &sharer_cache = sharer_cache_[face.id()];
     assert(kFaceQ == face.integrator().CountPoints());
+    if constexpr (Base::kBatchedOnFaces) {
+      AddBatchedFluxToHolderAndSharer(face, holder_data, sharer_data);
+      return;
+    }
     for (int f = 0; f < kFaceQ; ++f) {
       auto &holder_flux_point = holder_cache[f];
       auto &sharer_flux_point = sharer_cache[f];
@@ -249,6 +256,38 @@ class Lobatto : public General<P, R> {
       Polynomial::MinusValue(f_sharer, sharer_data, sharer_flux_point.ijk);
     }
   }
+  void AddBatchedFluxToHolderAndSharer(Face const &face,
+      Scalar *holder_data, Scalar *sharer_data) const
+      requires(Base::kBatchedOnFaces) {
+    using Batch = typename Riemann::Batch;
+    const auto &holder = face.holder();
+    const auto &sharer = face.sharer();
+    auto const &holder_cache = holder_cache_[face.id()];
+    auto const &sharer_cache = sharer_cache_[face.id()];
+    Batch u_holder(kFaceQ, Riemann::kComponents), f_upwind;
+    Batch u_sharer(kFaceQ, Riemann::kComponents);
+    for (int f = 0; f < kFaceQ; ++f) {
+      u_holder.row(f) = holder.polynomial().GetValue(holder_cache[f].ijk)
+          .transpose();
+      u_sharer.row(f) = sharer.polynomial().GetValue(sharer_cache[f].ijk)
+          .transpose();
+    }
+    Riemann::GetFluxesUpwind(this->GetRiemannSolvers(face),
+        u_holder, u_sharer, &f_upwind);
+    for (int f = 0; f < kFaceQ; ++f) {
+      auto &holder_flux_point = holder_cache[f];
+      auto &sharer_flux_point = sharer_cache[f];
+      auto [f_holder, f_sharer] = Base::SplitUpwindFlux(
+          f_upwind.row(f).transpose(), u_sharer.row(f).transpose(),
+          holder, holder_flux_point, sharer, sharer_flux_point, sharer_data);
+      f_holder *= holder_flux_point.g_prime;
+      assert(holder_data);
+      Polynomial::MinusValue(f_holder, holder_data, holder_flux_point.ijk);
+      if (nullptr == sharer_data) { continue; }
+      f_sharer *= sharer_flux_point.g_prime;
+      Polynomial::MinusValue(f_sharer, sharer_data, sharer_flux_point.ijk);
+    }
+  }
   void AddFluxToHolder(Face const &face, Scalar *holder_data) const override {
     const auto &riemanns = this->GetRiemannSolvers(face);
     auto const &holder_cache = holder_cache_[face.id()];
@@ -348,7 +387,10 @@ class Lobatto : public General<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSupersonicInlet(u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSupersonicInlet(u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           Base::MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           f_holder *= holder_flux_point.g_prime;
@@ -371,7 +413,10 @@ class Lobatto : public General<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSubsonicInlet(u_holder, u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSubsonicInlet(u_holder, u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           Base::MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           f_holder *= holder_flux_point.g_prime;
@@ -394,7 +439,10 @@ class Lobatto : public General<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSubsonicOutlet(u_holder, u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSubsonicOutlet(u_holder, u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           Base::MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           f_holder *= holder_flux_point.g_prime;
@@ -417,7 +465,10 @@ class Lobatto : public General<P, R> {
           Value u_holder = holder.polynomial().GetValue(
               holder_flux_point.ijk);
           Value u_given = func(integrator.GetGlobal(f), this->t_curr_);
-          Value f_upwind = riemanns[f].GetFluxOnSmartBoundary(u_holder, u_given);
+          Value f_upwind = Value::Zero();
+          if (!Base::IsViscousOnly()) {
+            f_upwind = riemanns[f].GetFluxOnSmartBoundary(u_holder, u_given);
+          }
           Value f_holder = f_upwind * holder_flux_point.scale;
           Base::MinusCachedFlux(&f_holder, holder.id(), holder_flux_point);
           f_holder *= holder_flux_point.g_prime;
@@ -0,0 +1,67 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_SPATIAL_MULTIGRID_HPP_
+#define MINI_SPATIAL_MULTIGRID_HPP_
+
+#include <cassert>
+#include <vector>
+
+#include "mini/polynomial/transfer.hpp"
+
+namespace mini {
+namespace spatial {
+
+/**
+ * @brief Transfer a Column of one FiniteElement to a Column of another FiniteElement on the same mesh, e.g. for p-multigrid.
+ *
+ * The two `Part`s must be read from the same partitioned mesh, so that their local `Cell`s share ids.
+ * Each `Cell` is handled by `polynomial::Transfer`, so restricting to a lower degree is an interpolation for nodal bases and an \f$ L_2 \f$ projection for modal ones, and prolonging back is exact.
+ * Since only coefficients are mapped, it applies to both solution and residual Columns.
+ *
+ * @tparam From the type of the source FiniteElement
+ * @tparam To the type of the target FiniteElement
+ * @param from the source FiniteElement
+ * @param from_column the Column of the source FiniteElement
+ * @param to the target FiniteElement
+ * @param to_column the Column of the target FiniteElement, which is resized and overwritten
+ */
+template <class From, class To>
+void Transfer(From const &from, typename From::Column const &from_column,
+    To const &to, typename To::Column *to_column) {
+  auto const &from_part = from.part();
+  auto const &to_part = to.part();
+  assert(from_part.CountLocalCells() == to_part.CountLocalCells());
+  auto from_cells = std::vector<typename From::Cell const *>(
+      from_part.CountLocalCells());
+  for (auto const &cell : from_part.GetLocalCells()) {
+    from_cells.at(cell.id()) = &cell;
+  }
+  to_column->resize(to_part.GetCellDataOffset(to_part.CountLocalCells()));
+  to.ForEachLocalCell([&](typename To::Cell const &to_cell) {
+    auto i_cell = to_cell.id();
+    auto const &from_cell = *from_cells[i_cell];
+    assert(from_cell.metis_id == to_cell.metis_id);
+    auto from_polynomial = from_cell.polynomial();
+    from_polynomial.GetCoeffFrom(from.AddCellDataOffset(from_column, i_cell));
+    auto to_polynomial = to_cell.polynomial();
+    polynomial::Transfer(from_polynomial, &to_polynomial);
+    to_polynomial.WriteCoeffTo(to.AddCellDataOffset(to_column, i_cell));
+  });
+}
+
+/**
+ * @brief Get a callable that transfers Columns from one FiniteElement to another, which can be passed to `temporal::FullApproximationScheme::AddLevel`.
+ *
+ * Both FiniteElements are captured by reference, so they must outlive the returned callable.
+ */
+template <class From, class To>
+auto GetTransfer(From const &from, To const &to) {
+  return [&from, &to](typename From::Column const &from_column,
+      typename To::Column *to_column) {
+    Transfer(from, from_column, to, to_column);
+  };
+}
+
+}  // namespace spatial
+}  // namespace mini
+
+#endif  // MINI_SPATIAL_MULTIGRID_HPP_
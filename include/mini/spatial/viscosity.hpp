@@ -5,12 +5,17 @@
 #include <concepts>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <span>
 #include <vector>
 #include <stdexcept>
 #include <string>
@@ -32,7 +37,14 @@
 namespace mini {
 namespace spatial {
 
-template <typename P, mini::riemann::Convective R>
+/**
+ * @brief The artificial viscosity determined by the energy dissipated by jumps across faces.
+ * 
+ * @tparam P the type of `Part`
+ * @tparam R the type of `Riemann` solver to be wrapped
+ * @tparam kPerNode whether to store a `Property` on each node, or only one `Property` on each cell
+ */
+template <typename P, mini::riemann::Convective R, bool kPerNode = false>
 class EnergyBasedViscosity : public R {
  public:
   using Base = R;
@@ -52,10 +64,10 @@ class EnergyBasedViscosity : public R {
   using Diffusion = EnergyBasedViscosity;
   using Gradient = mini::algebra::Matrix<Scalar, kDimensions, kComponents>;
   using Property = mini::algebra::Vector<Scalar, kComponents>;
-  static std::vector<std::vector<Property>> properties_;  // [i_cell][i_node]
 
   // members derived from Part
   using Part = P;
+  using Index = typename Part::Index;
   using Face = typename Part::Face;
   using Cell = typename Part::Cell;
   using Global = typename Cell::Global;
@@ -65,10 +77,30 @@ class EnergyBasedViscosity : public R {
   using Value = typename Polynomial::Value;
   static_assert(std::is_same_v<Value, Property>);
 
+  static constexpr int kPropertiesPerCell = kPerNode ? Cell::N : 1;
+
+ private:
+  // [i_cell * kPropertiesPerCell + i_node], or [i_cell] if `!kPerNode`
+  static std::vector<Property> properties_;
+
+  static std::span<Property, kPropertiesPerCell> GetPropertiesOnCell(
+      Index i_cell) {
+    assert(0 <= i_cell);
+    assert((i_cell + 1) * kPropertiesPerCell <= properties_.size());
+    return std::span<Property, kPropertiesPerCell>(
+        properties_.data() + i_cell * kPropertiesPerCell, kPropertiesPerCell);
+  }
+
+ public:
   // override methods in Base::Diffusion
   template <typename Int>
   static Property const &GetPropertyOnCell(Int i_cell, int i_node) {
-    return properties_.at(i_cell).at(i_node);
+    assert(0 <= i_node && i_node < Cell::N);
+    if constexpr (kPerNode) {
+      return GetPropertiesOnCell(i_cell)[i_node];
+    } else {
+      return GetPropertiesOnCell(i_cell)[0];
+    }
   }
 
  private:
@@ -154,42 +186,43 @@ class EnergyBasedViscosity : public R {
   using Spatial = FiniteElement<Part, EnergyBasedViscosity>;
 
  private:
-  static std::vector<std::vector<Scalar>> send_bufs_, recv_bufs_;
-  static std::vector<MPI_Request> requests_;
+  static typename Part::Halo halo_;
 
  public:
   /**
-   * @brief Initialize data structures for sharing viscosity properties across `Part`s.
+   * @brief Initialize data structures for sharing coeffs and viscosity properties across `Part`s.
    * 
    * It should be called once and only once before the main loop.
    */
   static void InitializeRequestsAndBuffers() {
-    part().InitializeRequestsAndBuffers(kComponents,
-        &requests_, &send_bufs_, &recv_bufs_);
+    halo_ = part().BuildCellHalo(Cell::kFields + kComponents);
   }
 
-  static void ShareGhostCellProperties() {
+  /**
+   * @brief Start sharing coeffs and properties on inter cells in one message per neighboring `Part`.
+   * 
+   */
+  static void ShareGhostCellCoeffsAndProperties() {
     auto operation = [](Cell const *cell_ptr, Scalar *buf) -> Scalar * {
-      std::vector<Property> const &properties = properties_.at(cell_ptr->id());
-      assert(Cell::N == properties.size());
+      buf = cell_ptr->polynomial().WriteCoeffTo(buf);
+      auto properties = GetPropertiesOnCell(cell_ptr->id());
       static_assert(Cell::K * sizeof(Scalar) == sizeof(Property));
       // Since properties[0] == ... == properties[N-1], only one has to be sent.
       std::memcpy(buf, properties.data(), sizeof(Property));
       return buf + Cell::K;
     };
-    part_ptr()->ShareGhostCellData(&requests_, &send_bufs_, &recv_bufs_,
-        operation);
+    part_ptr()->ShareGhostCellData(&halo_, operation);
   }
 
-  static void UpdateGhostCellProperties() {
+  static void UpdateGhostCellCoeffsAndProperties() {
     auto operation = [](Cell *cell_ptr, Scalar const *buf) -> Scalar const * {
-      std::vector<Property> &properties = properties_.at(cell_ptr->id());
-      assert(Cell::N == properties.size());
+      buf = cell_ptr->polynomial().GetCoeffFrom(buf);
+      auto properties = GetPropertiesOnCell(cell_ptr->id());
       static_assert(Cell::K * sizeof(Scalar) == sizeof(Property));
       std::ranges::fill(properties, *reinterpret_cast<Property const *>(buf));
       return buf + Cell::K;
     };
-    part_ptr()->UpdateGhostCellData(&requests_, &recv_bufs_, operation);
+    part_ptr()->UpdateGhostCellData(&halo_, operation);
   }
 
  private:
@@ -199,15 +232,14 @@ class EnergyBasedViscosity : public R {
  public:
   static void InstallSpatial(Spatial *spatial_ptr) {
     spatial_ptr_ = spatial_ptr;
-    properties_.resize(part().CountLocalCells() + part().CountGhostCells());
-    for (Cell *cell_ptr: part_ptr()->GetLocalCellPointers()) {
-      auto n_point = cell_ptr->integrator().CountPoints();
-      properties_.at(cell_ptr->id()).resize(n_point);
-    }
-    for (Cell const &cell: part().GetGhostCells()) {
-      auto n_point = cell.integrator().CountPoints();
-      properties_.at(cell.id()).resize(n_point);
+    auto n_cells = part().CountLocalCells() + part().CountGhostCells();
+    properties_.resize(n_cells * kPropertiesPerCell);
+    properties_.shrink_to_fit();
+#ifndef NDEBUG
+    for (Cell const &cell : part().GetLocalCells()) {
+      assert(cell.integrator().CountPoints() == Cell::N);
     }
+#endif
   }
 
   static Part *part_ptr() {
@@ -240,7 +272,7 @@ class EnergyBasedViscosity : public R {
    */
   static void SetViscousProperty(Cell *curr_cell, Property const &property_given) {
     auto SetProperty = [&property_given](Cell *cell_ptr) {
-      std::ranges::fill(properties_.at(cell_ptr->id()), property_given);
+      std::ranges::fill(GetPropertiesOnCell(cell_ptr->id()), property_given);
     };
     SetProperty(curr_cell);
     for (Cell *neighobor : curr_cell->adj_cells_) {
@@ -248,15 +280,9 @@ class EnergyBasedViscosity : public R {
     }
   }
   static void UpdateCellResidual(Cell *curr_cell, Scalar *residual_data) {
-    spatial_ptr_->AddFluxDivergence(*curr_cell, residual_data);
-    for (Face *face : curr_cell->adj_faces_) {
-      if (face->holder_ptr() == curr_cell) {
-        spatial_ptr_->AddFluxToHolder(*face, residual_data);
-      } else {
-        spatial_ptr_->AddFluxToSharer(*face, residual_data);
-      }
+    spatial_ptr_->AddCellLocalResidual(*curr_cell, residual_data);
 #if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
-{
+    for (Face *face : curr_cell->adj_faces_) {
       Coeff dummy;
       Cell const *other = face->other(curr_cell);
       assert(other->polynomial().coeff() == Coeff::Zero());
@@ -275,111 +301,413 @@ class EnergyBasedViscosity : public R {
         spatial_ptr_->AddFluxToHolderAndSharer(*face, dummy.data(), res2.data());
         assert(res1 == res2);
       }
-}
-#endif
-    }
-    assert(curr_cell->adj_cells_.size() == curr_cell->adj_faces_.size());
-    for (Face *face : curr_cell->boundary_faces_) {
-      assert(face->holder_ptr() == curr_cell);
-      assert(nullptr == face->other(curr_cell));
-      assert(face->HolderToSharer().dot(
-          face->center() - curr_cell->center()) > 0);
-      spatial_ptr_->AddFluxToHolder(*face, residual_data);
     }
+#endif
     assert(curr_cell->boundary_faces_.size() + curr_cell->adj_faces_.size() == 6);
   }
 
  public:  // methods for generating artificial viscosity
   using DampingMatrix = algebra::Matrix<Scalar, Cell::N, Cell::N>;
 
+  /**
+   * @brief The damping matrices of all local cells in a compact form.
+   * 
+   * Only the quadratic form \f$ u^{\mathsf{T}} D\,u \f$ of each matrix \f$ D \f$ is used, so only the upper triangle of its symmetric part is stored.
+   * Cells with the same matrix (e.g. translated copies of a cell in a structured region) share the storage.
+   */
+  class DampingMatrices {
+   public:
+    static constexpr int kPacked = Cell::N * (Cell::N + 1) / 2;
+    using Packed = std::array<Scalar, kPacked>;
+
+   private:
+    std::vector<Packed> unique_matrices_;
+    std::vector<Index> i_unique_;  // [i_cell] -> index in unique_matrices_
+    // quantized hash -> indices in unique_matrices_
+    std::unordered_multimap<std::size_t, Index> hash_to_unique_;
+
+    static Packed Pack(DampingMatrix const &matrix) {
+      Packed packed;
+      int i = 0;
+      for (int r = 0; r < Cell::N; ++r) {
+        packed[i++] = matrix(r, r);
+        for (int c = r + 1; c < Cell::N; ++c) {
+          packed[i++] = matrix(r, c) + matrix(c, r);
+        }
+      }
+      assert(i == kPacked);
+      return packed;
+    }
+    static Scalar GetScale(Packed const &packed) {
+      Scalar scale = 0;
+      for (Scalar x : packed) {
+        scale = std::max(scale, std::abs(x));
+      }
+      return scale;
+    }
+    static std::size_t Hash(Packed const &packed, Scalar scale) {
+      std::size_t hash = 0;
+      if (scale == 0) {
+        return hash;
+      }
+      for (Scalar x : packed) {
+        // entries within 2^-20 relative to `scale` are (mostly) hashed equally
+        auto key = std::llround(std::ldexp(x / scale, 20));
+        hash ^= std::hash<long long>()(key) + 0x9e3779b9
+            + (hash << 6) + (hash >> 2);
+      }
+      return hash;
+    }
+    static bool Near(Packed const &a, Packed const &b, Scalar scale) {
+      for (int i = 0; i < kPacked; ++i) {
+        if (std::abs(a[i] - b[i]) > 1e-10 * scale) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+   public:
+    explicit DampingMatrices(Index n_cells)
+        : i_unique_(n_cells, -1) {
+    }
+    DampingMatrices() = default;
+
+    /**
+     * @brief Store the damping matrix of a given cell, reusing an existing one if they are equal up to round-off errors.
+     * 
+     */
+    void Set(Index i_cell, DampingMatrix const &matrix) {
+      Packed packed = Pack(matrix);
+      Scalar scale = GetScale(packed);
+      auto hash = Hash(packed, scale);
+      auto [head, tail] = hash_to_unique_.equal_range(hash);
+      for (auto iter = head; iter != tail; ++iter) {
+        if (Near(unique_matrices_[iter->second], packed, scale)) {
+          i_unique_.at(i_cell) = iter->second;
+          return;
+        }
+      }
+      Index i_unique = unique_matrices_.size();
+      unique_matrices_.emplace_back(packed);
+      hash_to_unique_.emplace(hash, i_unique);
+      i_unique_.at(i_cell) = i_unique;
+    }
+
+    /**
+     * @brief Let a cell share the damping matrix of another cell, which has been set.
+     * 
+     */
+    void Share(Index i_cell, Index j_cell) {
+      assert(i_unique_.at(j_cell) >= 0);
+      i_unique_.at(i_cell) = i_unique_.at(j_cell);
+    }
+
+    /**
+     * @brief Release the memory only used in `Set`.
+     * 
+     */
+    void Compress() {
+      unique_matrices_.shrink_to_fit();
+      hash_to_unique_ = {};
+    }
+
+    Index CountCells() const {
+      return i_unique_.size();
+    }
+    Index CountUniqueMatrices() const {
+      return unique_matrices_.size();
+    }
+
+    /**
+     * @brief Get \f$ u^{\mathsf{T}} D\,u \f$ on a given cell.
+     * 
+     */
+    template <class Row>
+    Scalar GetQuadraticForm(Index i_cell, Row const &u) const {
+      Packed const &packed = unique_matrices_[i_unique_.at(i_cell)];
+      Scalar sum = 0;
+      int i = 0;
+      for (int r = 0; r < Cell::N; ++r) {
+        Scalar row_sum = packed[i++] * u[r];
+        for (int c = r + 1; c < Cell::N; ++c) {
+          row_sum += packed[i++] * u[c];
+        }
+        sum += row_sum * u[r];
+      }
+      return sum;
+    }
+
+    /**
+     * @brief Get the symmetric part of the damping matrix on a given cell.
+     * 
+     */
+    DampingMatrix GetMatrix(Index i_cell) const {
+      Packed const &packed = unique_matrices_[i_unique_.at(i_cell)];
+      DampingMatrix matrix;
+      int i = 0;
+      for (int r = 0; r < Cell::N; ++r) {
+        matrix(r, r) = packed[i++];
+        for (int c = r + 1; c < Cell::N; ++c) {
+          matrix(r, c) = matrix(c, r) = packed[i++] / 2;
+        }
+      }
+      return matrix;
+    }
+  };
+
  private:
-  static std::vector<DampingMatrix> damping_matrices_;
+  static DampingMatrices damping_matrices_;
+
+ private:  // methods used in BuildDampingMatrices()
+  /**
+   * @brief Build the damping matrix of a given cell column by column.
+   * 
+   * The coeffs of the given cell and its neighbors, as well as their viscous properties, are overwritten.
+   */
+  static void BuildDampingMatrix(Cell *curr_cell, DampingMatrix *matrix) {
+    // Nullify coeffs and properties on all its neighbors:
+    for (Cell *neighbor : curr_cell->adj_cells_) {
+      neighbor->polynomial().SetZero();
+    }
+    auto GetCellResidual = [](Cell *cell_ptr) -> Coeff {
+      Coeff residual; residual.setZero();
+      SetViscousProperty(cell_ptr, Value::Zero());
+      UpdateCellResidual(cell_ptr, residual.data());
+      residual = -residual;
+      SetViscousProperty(cell_ptr, Value::Ones());
+      UpdateCellResidual(cell_ptr, residual.data());
+      if (!Polynomial::kLocal) {
+        // TODO(PVC): Use the virtual method in Base
+        Scalar *data = residual.data();
+        const auto &integrator = cell_ptr->integrator();
+        for (int q = 0; q < Cell::N; ++q) {
+          auto scale = 1. / integrator.GetJacobianDeterminant(q);
+          data = cell_ptr->polynomial().ScaleValueAt(scale, data);
+        }
+        assert(data == residual.data() + Cell::kFields);
+      }
+      return residual;
+    };
+    auto &curr_polynomial = curr_cell->polynomial();
+    curr_polynomial.SetZero();
+    for (int c = 0; c < Cell::N; ++c) {
+      if (c > 0) {
+        curr_polynomial.SetCoeff(c - 1, Value::Zero());
+      }
+      curr_polynomial.SetCoeff(c, Value::Ones());
+      Coeff residual = GetCellResidual(curr_cell);
+      // Write the residual column into the matrix:
+      matrix->col(c) = residual.row(0);
+#ifndef NDEBUG
+      for (int r = 1; r < Cell::K; ++r) {
+        if ((residual.row(r) - residual.row(0)).squaredNorm() > 1e-10) {
+          std::cout << residual.row(r) << "\n\n";
+          std::cout << residual.row(0) << "\n\n";
+          assert(false);
+        }
+      }
+#endif
+    }
+#if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
+{
+    Coeff solution = Coeff::Random();
+    curr_cell->polynomial().SetCoeff(solution);
+    assert(solution == curr_cell->polynomial().coeff());
+    Coeff residual = GetCellResidual(curr_cell);
+    assert(solution == curr_cell->polynomial().coeff());
+    for (int k = 0; k < Cell::K; ++k) {
+      auto const &residual_col = residual.row(k).transpose();
+      auto const &solution_col = solution.row(k).transpose();
+      if ((residual_col - *matrix * solution_col).norm() > 1e-9) {
+        std::cout << (residual_col).transpose() << "\n\n";
+        std::cout << (*matrix * solution_col).transpose() << "\n\n";
+        std::cout << (residual_col - *matrix * solution_col).norm() << "\n\n";
+        assert(false);
+      }
+    }
+}
+#endif
+    // Scale the damping matrix by Gaussian weights:
+    for (int r = 0; r < Cell::N; ++r) {
+      Scalar scale = curr_cell->integrator().GetLocalWeight(r);
+      Scalar det = curr_cell->integrator().GetJacobianDeterminant(r);
+      if (Polynomial::kLocal) {
+        scale /= det;
+      } else {
+        scale *= det;
+        assert(scale == curr_cell->integrator().GetGlobalWeight(r));
+      }
+      assert(scale > 0);
+      matrix->row(r) *= scale;
+    }
+  }
+
+  /**
+   * @brief Collect the geometric data, which determine the damping matrix of a given inner cell, in a translation-invariant form.
+   * 
+   * Lengths are divided by `cell.length()`, which is not included.
+   */
+  static std::vector<Scalar> GetGeometricFeatures(Cell const &cell) {
+    std::vector<Scalar> features;
+    Global const &center = cell.center();
+    Scalar length = cell.length();
+    Scalar volume = length * length * length;
+    auto PushPoint = [&features, &center, length](Global const &point) {
+      for (int d = 0; d < Cell::D; ++d) {
+        features.emplace_back((point[d] - center[d]) / length);
+      }
+    };
+    auto PushVector = [&features](Global const &vector) {
+      features.insert(features.end(), vector.data(), vector.data() + Cell::D);
+    };
+    auto const &integrator = cell.integrator();
+    for (int q = 0, n = integrator.CountPoints(); q < n; ++q) {
+      PushPoint(integrator.GetGlobal(q));
+      features.emplace_back(integrator.GetGlobalWeight(q) / volume);
+    }
+    for (Face const *face : cell.adj_faces_) {
+      Cell const *other = face->other(&cell);
+      features.emplace_back(&face->holder() == &cell ? 1 : -1);
+      PushPoint(other->center());
+      features.emplace_back(other->volume() / volume);
+      auto const &face_integrator = face->integrator();
+      features.emplace_back(face_integrator.CountPoints());
+      for (int q = 0, n = face_integrator.CountPoints(); q < n; ++q) {
+        PushPoint(face_integrator.GetGlobal(q));
+        features.emplace_back(face_integrator.GetGlobalWeight(q) / volume);
+        PushVector(face_integrator.GetNormalFrame(q)[0]);
+      }
+    }
+    return features;
+  }
+  static std::size_t HashGeometricFeatures(std::vector<Scalar> const &features) {
+    std::size_t hash = features.size();
+    for (Scalar x : features) {
+      // features within 2^-20 are (mostly) hashed equally
+      auto key = std::llround(std::ldexp(x, 20));
+      hash ^= std::hash<long long>()(key) + 0x9e3779b9
+          + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+  static bool AreGeometricallyIdentical(Cell const &a,
+      std::vector<Scalar> const &a_features, Cell const &b) {
+    if (std::abs(a.length() - b.length()) > 1e-10 * a.length()) {
+      return false;
+    }
+    auto b_features = GetGeometricFeatures(b);
+    if (a_features.size() != b_features.size()) {
+      return false;
+    }
+    for (int i = 0, n = a_features.size(); i < n; ++i) {
+      if (std::abs(a_features[i] - b_features[i]) > 1e-10) {
+        return false;
+      }
+    }
+    return true;
+  }
 
  public:
-  static std::vector<DampingMatrix> BuildDampingMatrices() {
+  /**
+   * @brief Build the full damping matrix of each local cell one by one, which is slow but serves as a reference for `BuildDampingMatrices`.
+   *
+   */
+  static std::vector<DampingMatrix> BuildDenseDampingMatrices() {
 #if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
     std::srand(31415926);
 #endif
     auto matrices = std::vector<DampingMatrix>(part().CountLocalCells());
-    for (Cell *curr_cell: part_ptr()->GetLocalCellPointers()) {
-      // Nullify coeffs and properties on all its neighbors:
-      for (Cell *neighbor : curr_cell->adj_cells_) {
-        neighbor->polynomial().SetZero();
+    for (Cell *curr_cell : part_ptr()->GetLocalCellPointers()) {
+      BuildDampingMatrix(curr_cell, &matrices.at(curr_cell->id()));
+    }
+    return matrices;
+  }
+
+  /**
+   * @brief Build the damping matrices of all local cells.
+   * 
+   * Only one cell in each class of geometrically identical inner cells (i.e. translated copies, which are common in structured regions) is built.
+   * Cells without common neighbors are built concurrently.
+   */
+  static DampingMatrices BuildDampingMatrices() {
+#if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
+    std::srand(31415926);
+#endif
+    auto matrices = DampingMatrices(part().CountLocalCells());
+    // Pick out cells to be built, others are copies of them.
+    std::vector<Cell *> cells_to_build;
+    std::vector<std::pair<Index, Index>> copies;  // [(i_copy, i_origin)]
+    {
+      // quantized hash -> cells with that hash
+      std::unordered_multimap<std::size_t, Cell const *> hash_to_cells;
+      for (Cell *curr_cell : part_ptr()->GetLocalCellPointers()) {
+        if (curr_cell->boundary_faces_.size()) {
+          // Matrices on such cells also depend on boundary conditions.
+          cells_to_build.emplace_back(curr_cell);
+          continue;
+        }
+        auto features = GetGeometricFeatures(*curr_cell);
+        auto hash = HashGeometricFeatures(features);
+        auto [head, tail] = hash_to_cells.equal_range(hash);
+        auto iter = std::find_if(head, tail, [&](auto const &pair) {
+          return AreGeometricallyIdentical(*curr_cell, features, *pair.second);
+        });
+        if (iter == tail) {
+          cells_to_build.emplace_back(curr_cell);
+          hash_to_cells.emplace(hash, curr_cell);
+        } else {
+          copies.emplace_back(curr_cell->id(), iter->second->id());
+        }
       }
-      // Build the damping matrix column by column:
-      auto &matrix = matrices.at(curr_cell->id());
-      auto GetCellResidual = [](Cell *cell_ptr) -> Coeff {
-        Coeff residual; residual.setZero();
-        SetViscousProperty(cell_ptr, Value::Zero());
-        UpdateCellResidual(cell_ptr, residual.data());
-        residual = -residual;
-        SetViscousProperty(cell_ptr, Value::Ones());
-        UpdateCellResidual(cell_ptr, residual.data());
-        if (!Polynomial::kLocal) {
-          // TODO(PVC): Use the virtual method in Base
-          Scalar *data = residual.data();
-          const auto &integrator = cell_ptr->integrator();
-          for (int q = 0; q < Cell::N; ++q) {
-            auto scale = 1. / integrator.GetJacobianDeterminant(q);
-            data = cell_ptr->polynomial().ScaleValueAt(scale, data);
-          }
-          assert(data == residual.data() + Cell::kFields);
+    }
+    // Color cells_to_build, so that cells in the same group share no neighbor.
+    std::vector<std::vector<Cell *>> groups;
+    {
+      auto n_cells = part().CountLocalCells() + part().CountGhostCells();
+      // [i_cell] -> bitmask of the colors used by cells next to this cell
+      auto used_colors = std::vector<uint64_t>(n_cells);
+      for (Cell *curr_cell : cells_to_build) {
+        uint64_t used = used_colors[curr_cell->id()];
+        for (Cell const *neighbor : curr_cell->adj_cells_) {
+          used |= used_colors[neighbor->id()];
         }
-        return residual;
-      };
-      auto &curr_polynomial = curr_cell->polynomial();
-      curr_polynomial.SetZero();
-      for (int c = 0; c < Cell::N; ++c) {
-        if (c > 0) {
-          curr_polynomial.SetCoeff(c - 1, Value::Zero());
+        int i_color = std::countr_one(used);
+        if (i_color >= 64) {
+          throw std::runtime_error("Cells need more than 64 colors.");
         }
-        curr_polynomial.SetCoeff(c, Value::Ones());
-        Coeff residual = GetCellResidual(curr_cell);
-        // Write the residual column into the matrix:
-        matrix.col(c) = residual.row(0);
-#ifndef NDEBUG
-        for (int r = 1; r < Cell::K; ++r) {
-          if ((residual.row(r) - residual.row(0)).squaredNorm() > 1e-10) {
-            std::cout << residual.row(r) << "\n\n";
-            std::cout << residual.row(0) << "\n\n";
-            assert(false);
-          }
+        uint64_t color = uint64_t(1) << i_color;
+        used_colors[curr_cell->id()] |= color;
+        for (Cell const *neighbor : curr_cell->adj_cells_) {
+          used_colors[neighbor->id()] |= color;
         }
-#endif
-      }
-#if !defined(NDEBUG) && defined(ENABLE_SLOW_CONSISTENCY_CHECK)
-{
-      Coeff solution = Coeff::Random();
-      curr_cell->polynomial().SetCoeff(solution);
-      assert(solution == curr_cell->polynomial().coeff());
-      Coeff residual = GetCellResidual(curr_cell);
-      assert(solution == curr_cell->polynomial().coeff());
-      for (int k = 0; k < Cell::K; ++k) {
-        auto const &residual_col = residual.row(k).transpose();
-        auto const &solution_col = solution.row(k).transpose();
-        if ((residual_col - matrix * solution_col).norm() > 1e-9) {
-          std::cout << (residual_col).transpose() << "\n\n";
-          std::cout << (matrix * solution_col).transpose() << "\n\n";
-          std::cout << (residual_col - matrix * solution_col).norm() << "\n\n";
-          assert(false);
+        if (i_color == std::ssize(groups)) {
+          groups.emplace_back();
         }
+        groups[i_color].emplace_back(curr_cell);
       }
-}
+    }
+    // Build each group chunk by chunk, which bounds the memory of dense ones.
+    constexpr int kChunkSize = 256;
+    auto chunk = std::vector<DampingMatrix>(kChunkSize);
+    for (auto const &group : groups) {
+      for (int head = 0, n = group.size(); head < n; head += kChunkSize) {
+        int tail = std::min(head + kChunkSize, n);
+#ifndef ENABLE_SLOW_CONSISTENCY_CHECK  // which calls std::rand()
+#pragma omp parallel for schedule(dynamic)
 #endif
-      // Scale the damping matrix by Gaussian weights:
-      for (int r = 0; r < Cell::N; ++r) {
-        Scalar scale = curr_cell->integrator().GetLocalWeight(r);
-        Scalar det = curr_cell->integrator().GetJacobianDeterminant(r);
-        if (Polynomial::kLocal) {
-          scale /= det;
-        } else {
-          scale *= det;
-          assert(scale == curr_cell->integrator().GetGlobalWeight(r));
+        for (int i = head; i < tail; ++i) {
+          BuildDampingMatrix(group[i], &chunk[i - head]);
+        }
+        for (int i = head; i < tail; ++i) {
+          matrices.Set(group[i]->id(), chunk[i - head]);
         }
-        assert(scale > 0);
-        matrix.row(r) *= scale;
       }
     }
+    for (auto [i_copy, i_origin] : copies) {
+      matrices.Share(i_copy, i_origin);
+    }
+    matrices.Compress();
     return matrices;
   }
 
@@ -476,14 +804,14 @@ class EnergyBasedViscosity : public R {
 
   static std::vector<Value> GetViscosityValues(
       std::vector<Value> const &jump_integrals,
-      std::vector<DampingMatrix> const &damping_matrices) {
+      DampingMatrices const &damping_matrices) {
     min_dt_ = 1.e+100;
+    local_dt_.resize(part().CountLocalCells());
     std::vector<Value> viscosity_values;
     viscosity_values.reserve(part().CountLocalCells());
     for (Cell *curr_cell : part_ptr()->GetLocalCellPointers()) {
       auto &viscosity_on_curr_cell = viscosity_values.emplace_back();
       auto &jump_integral_on_curr_cell = jump_integrals.at(curr_cell->id());
-      auto &damping_matrix_on_curr_cell = damping_matrices.at(curr_cell->id());
       auto const &coeff = curr_cell->polynomial().coeff();
       assert(coeff.rows() == Cell::K);
       assert(coeff.cols() == Cell::N);
@@ -504,7 +832,8 @@ class EnergyBasedViscosity : public R {
       auto [max_speed, reference_value_square]
           = GetMaximumSpeedAndReferenceValueSquare(*curr_cell);
       Scalar cell_length = curr_cell->length();
-      min_dt_ = std::min(min_dt_, cell_length / max_speed);
+      Scalar &local_dt = local_dt_[curr_cell->id()];
+      local_dt = cell_length / max_speed;
       Scalar max_viscosity = max_speed * cell_length / Cell::P;
       assert(!std::isinf(max_viscosity) && !std::isnan(max_viscosity));
       Scalar time_base = cell_length / max_speed;
@@ -516,15 +845,14 @@ class EnergyBasedViscosity : public R {
           viscosity_on_curr_cell[k] = 0.;
           continue;
         }
-        auto const &u_row = coeff.row(k);
-        auto const &u_col = u_row.transpose();
-        Scalar damping_rate = -u_row.dot(damping_matrix_on_curr_cell * u_col);
+        Scalar damping_rate = -damping_matrices.GetQuadraticForm(
+            curr_cell->id(), coeff.row(k));
         assert(damping_rate >= 0);
         Scalar damping_time = time_base * GetTimeScale();
         viscosity_on_curr_cell[k] = std::min(max_viscosity, std::max(0.0,
             // to protect against damping_rate == -0.0, which would lead to -inf
             jump_integral_on_curr_cell[k] / (damping_rate * damping_time)));
-        min_dt_ = std::min(min_dt_, cell_length / (max_speed
+        local_dt = std::min(local_dt, cell_length / (max_speed
             + GetSpatialFactor() * viscosity_on_curr_cell[k] / cell_length));
 #ifndef NDEBUG
         if (std::isinf(viscosity_on_curr_cell[k])) {
@@ -534,9 +862,11 @@ class EnergyBasedViscosity : public R {
         }
 #endif
       }
+      min_dt_ = std::min(min_dt_, local_dt);
 #ifndef NDEBUG
       std::fstream log{ "damping" + std::to_string(curr_cell->metis_id) + ".txt", log.out };
-      log << std::scientific << std::setprecision(2) << damping_matrix_on_curr_cell << "\n";
+      log << std::scientific << std::setprecision(2)
+          << damping_matrices.GetMatrix(curr_cell->id()) << "\n";
 #endif
     }
     assert(viscosity_values.size() == part().CountLocalCells());
@@ -558,11 +888,12 @@ class EnergyBasedViscosity : public R {
     auto jump_integrals = IntegrateJumpOnFaces();
     auto viscosity_values = GetViscosityValues(
         jump_integrals, damping_matrices_);
-    assert(properties_.size()
-        == part().CountGhostCells() + part().CountLocalCells());
+    assert(properties_.size() == kPropertiesPerCell
+        * (part().CountGhostCells() + part().CountLocalCells()));
     assert(viscosity_values.size() == part().CountLocalCells());
-    for (ssize_t i_cell = 0; i_cell < part().CountLocalCells(); ++i_cell) {
-      std::ranges::fill(properties_.at(i_cell), viscosity_values.at(i_cell));
+    for (Index i_cell = 0; i_cell < part().CountLocalCells(); ++i_cell) {
+      std::ranges::fill(GetPropertiesOnCell(i_cell),
+          viscosity_values.at(i_cell));
     }
     /* TODO(PVC): replace by std::views::zip in C++23
     for (auto &[properties, viscosity_value]
@@ -573,11 +904,16 @@ class EnergyBasedViscosity : public R {
 
  protected:
   static Scalar min_dt_;
+  // [i_cell] -> the stable time step (without the CFL number) on a local cell
+  static std::vector<Scalar> local_dt_;
 
  public:
   static Scalar GetMinimumTimeStep() {
     return min_dt_;
   }
+  static Scalar GetLocalTimeStep(Index i_cell) {
+    return local_dt_[i_cell];
+  }
   static constexpr Scalar GetSpatialFactor() {
     static_assert(0 <= Cell::P && Cell::P < 7);
     switch (Cell::P) {
@@ -601,37 +937,33 @@ class EnergyBasedViscosity : public R {
   }
 };
 
-template <typename P, typename R>
-std::vector<typename EnergyBasedViscosity<P, R>::DampingMatrix>
-EnergyBasedViscosity<P, R>::damping_matrices_;
-
-template <typename P, typename R>
-std::vector<std::vector<typename EnergyBasedViscosity<P, R>::Property>>
-EnergyBasedViscosity<P, R>::properties_;
+template <typename P, mini::riemann::Convective R, bool kPerNode>
+typename EnergyBasedViscosity<P, R, kPerNode>::DampingMatrices
+EnergyBasedViscosity<P, R, kPerNode>::damping_matrices_;
 
-template <typename P, typename R>
-std::vector<std::vector<typename EnergyBasedViscosity<P, R>::Scalar>>
-EnergyBasedViscosity<P, R>::send_bufs_;
+template <typename P, mini::riemann::Convective R, bool kPerNode>
+std::vector<typename EnergyBasedViscosity<P, R, kPerNode>::Property>
+EnergyBasedViscosity<P, R, kPerNode>::properties_;
 
-template <typename P, typename R>
-std::vector<std::vector<typename EnergyBasedViscosity<P, R>::Scalar>>
-EnergyBasedViscosity<P, R>::recv_bufs_;
+template <typename P, mini::riemann::Convective R, bool kPerNode>
+typename P::Halo
+EnergyBasedViscosity<P, R, kPerNode>::halo_;
 
-template <typename P, typename R>
-std::vector<MPI_Request>
-EnergyBasedViscosity<P, R>::requests_;
+template <typename P, mini::riemann::Convective R, bool kPerNode>
+typename EnergyBasedViscosity<P, R, kPerNode>::Spatial *
+EnergyBasedViscosity<P, R, kPerNode>::spatial_ptr_;
 
-template <typename P, typename R>
-typename EnergyBasedViscosity<P, R>::Spatial *
-EnergyBasedViscosity<P, R>::spatial_ptr_;
+template <typename P, mini::riemann::Convective R, bool kPerNode>
+typename EnergyBasedViscosity<P, R, kPerNode>::Scalar
+EnergyBasedViscosity<P, R, kPerNode>::time_scale_;
 
-template <typename P, typename R>
-typename EnergyBasedViscosity<P, R>::Scalar
-EnergyBasedViscosity<P, R>::time_scale_;
+template <typename P, mini::riemann::Convective R, bool kPerNode>
+typename EnergyBasedViscosity<P, R, kPerNode>::Scalar
+EnergyBasedViscosity<P, R, kPerNode>::min_dt_;
 
-template <typename P, typename R>
-typename EnergyBasedViscosity<P, R>::Scalar
-EnergyBasedViscosity<P, R>::min_dt_;
+template <typename P, mini::riemann::Convective R, bool kPerNode>
+std::vector<typename EnergyBasedViscosity<P, R, kPerNode>::Scalar>
+EnergyBasedViscosity<P, R, kPerNode>::local_dt_;
 
 }  // namespace spatial
 }  // namespace mini
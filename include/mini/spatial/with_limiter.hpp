@@ -35,6 +35,7 @@ class WithLimiter : public ConcreteFiniteElement {
 
  protected:
   Limiter *limiter_ptr_;
+  typename Part::Index n_troubled_cells_ = 0;
 
  public:
   template <class... Args>
@@ -52,16 +53,27 @@ class WithLimiter : public ConcreteFiniteElement {
     return limiter_ptr_;
   }
 
+  /**
+   * @brief Get the number of local cells marked as troubled by the last reconstruction.
+   * 
+   * @return the number of troubled cells on this partition
+   */
+  typename Part::Index CountTroubledCells() const {
+    return n_troubled_cells_;
+  }
+
  public:  // implement pure virtual methods declared in Temporal
   void SetSolutionColumn(Column const &column) override {
     this->Base::SetSolutionColumn(column);
-    mini::limiter::Reconstruct(this->part_ptr(), limiter_ptr());
+    n_troubled_cells_ = mini::limiter::Reconstruct(
+        this->part_ptr(), limiter_ptr());
   }
 
   template <class Callable>
   void Approximate(Callable &&func) {
     Base::Approximate(std::forward<Callable>(func));
-    mini::limiter::Reconstruct(this->part_ptr(), limiter_ptr());
+    n_troubled_cells_ = mini::limiter::Reconstruct(
+        this->part_ptr(), limiter_ptr());
   }
 };
 
@@ -46,13 +46,6 @@ class WithViscosity : public ConcreteFiniteElement {
   ~WithViscosity() noexcept = default;
 
  public:  // override virtual methods declared in ConcreteFiniteElement
-  Column GetResidualColumn() const override {
-    // TODO(PVC): overlap communication with computation
-    Riemann::Viscosity::ShareGhostCellProperties();
-    Riemann::Viscosity::UpdateGhostCellProperties();
-    return this->Base::GetResidualColumn();
-  }
-
   void SetSolutionColumn(Column const &column) override {
     this->Base::SetSolutionColumn(column);
     Riemann::Viscosity::UpdateProperties();
@@ -69,6 +62,20 @@ class WithViscosity : public ConcreteFiniteElement {
         * Riemann::Viscosity::GetMinimumTimeStep();
     return std::min(dt, dt_guess);
   }
+
+ protected:  // override virtual methods declared in FiniteElement
+  Scalar GetLocalTimeStep(Cell const &cell, int rk_order) const override {
+    return Base::GetCflNumber(rk_order)
+        * Riemann::Viscosity::GetLocalTimeStep(cell.id());
+  }
+
+  void ShareGhostCellData() const override {
+    // Properties are sent along with coeffs, so only one exchange is posted.
+    Riemann::Viscosity::ShareGhostCellCoeffsAndProperties();
+  }
+  void UpdateGhostCellData() const override {
+    Riemann::Viscosity::UpdateGhostCellCoeffsAndProperties();
+  }
 };
 
 }  // namespace spatial
@@ -0,0 +1,354 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_TEMPORAL_IMPLICIT_HPP_
+#define MINI_TEMPORAL_IMPLICIT_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "mini/algebra/krylov.hpp"
+#include "mini/temporal/ode.hpp"
+
+namespace mini {
+namespace temporal {
+
+/**
+ * @brief The optional interface of ODE systems that are advanced by implicit solvers.
+ *
+ * It does not derive from System, so a concrete System can implement it along with other interfaces (e.g. MultirateSystem), and solvers access it by `dynamic_cast`.
+ * The residual is split into a stiff part and a nonstiff part, only the former of which is treated implicitly by ImexRungeKutta.
+ *
+ * @tparam Scalar the type of scalar variables.
+ */
+template <typename Scalar>
+class ImplicitSystem {
+ public:
+  using Column = typename System<Scalar>::Column;
+
+  /**
+   * @brief Get the inner product of two Columns, which should be reduced over all processes if the System is distributed.
+   *
+   */
+  virtual Scalar GetInnerProduct(Column const &x, Column const &y) const {
+    return x.dot(y);
+  }
+
+  /**
+   * @brief Write the stiff part and the nonstiff part of the residual into given Columns, whose sum is the residual.
+   *
+   * @param stiff the Column to be overwritten by the stiff part
+   * @param nonstiff the Column to be overwritten by the nonstiff part
+   */
+  virtual void WriteStiffAndNonstiffResidualsTo(Column *stiff,
+      Column *nonstiff) const = 0;
+
+  /**
+   * @brief Write only the stiff part of the residual into a given Column.
+   *
+   * It calls WriteStiffAndNonstiffResidualsTo by default, and should be overridden if the stiff part can be evaluated alone at a lower cost.
+   *
+   * @param stiff the Column to be overwritten by the stiff part
+   */
+  virtual void WriteStiffResidualTo(Column *stiff) const {
+    Column nonstiff;
+    WriteStiffAndNonstiffResidualsTo(stiff, &nonstiff);
+  }
+
+  /**
+   * @brief Write only the nonstiff part of the residual into a given Column.
+   *
+   * It calls WriteStiffAndNonstiffResidualsTo by default, and should be overridden if the nonstiff part can be evaluated alone at a lower cost.
+   *
+   * @param nonstiff the Column to be overwritten by the nonstiff part
+   */
+  virtual void WriteNonstiffResidualTo(Column *nonstiff) const {
+    Column stiff;
+    WriteStiffAndNonstiffResidualsTo(&stiff, nonstiff);
+  }
+
+  /**
+   * @brief Update the preconditioner of \f$ I - \gamma\,\Delta t\,\partial R_\mathrm{stiff} / \partial U \f$ at the current solution.
+   *
+   * It does nothing by default, i.e. the preconditioner is the identity.
+   *
+   * @param gamma_dt the product of the diagonal coefficient and the time step
+   */
+  virtual void UpdatePreconditioner(Scalar gamma_dt) {
+  }
+
+  /**
+   * @brief Multiply a Column by the inverse of the preconditioner in place.
+   *
+   * @param column the Column to be overwritten
+   */
+  virtual void ApplyPreconditioner(Column *column) const {
+  }
+};
+
+/**
+ * @brief The Jacobian-free Newton--Krylov solver of the stage equation \f$ U - \gamma\,\Delta t\,R(U) = B \f$ in diagonally implicit Runge--Kutta methods.
+ *
+ * Each Newton step is solved by algebra::krylov::Gmres, in which the product of the Jacobian and a Column is approximated by a finite difference of \f$ R \f$, so only residuals are evaluated.
+ *
+ * @tparam Scalar the type of scalar variables
+ */
+template <typename Scalar>
+class NewtonKrylov {
+ public:
+  using Column = typename System<Scalar>::Column;
+
+ private:
+  // the current iterate, its residual, the Newton residual, and the update
+  Column u_, residual_, newton_residual_, update_;
+  // buffers for finite differences
+  Column u_perturbed_, residual_perturbed_;
+  Scalar newton_tolerance_, krylov_tolerance_;
+  int max_newton_iterations_, max_krylov_iterations_, krylov_restart_;
+  int n_newton_iterations_ = 0, n_krylov_iterations_ = 0;
+  int n_krylov_failures_ = 0;
+  bool converged_ = false;
+
+ public:
+  /**
+   * @brief Construct a new NewtonKrylov object.
+   *
+   * @param newton_tolerance the Newton iteration stops once the norm of \f$ U - \gamma\,\Delta t\,R(U) - B \f$ is below this factor of \f$ \|B\| \f$
+   * @param max_newton_iterations the maximum number of Newton steps in each stage
+   * @param krylov_tolerance the relative tolerance of each linear solve
+   * @param max_krylov_iterations the maximum number of iterations in each linear solve
+   * @param krylov_restart the dimension of Krylov subspaces
+   */
+  explicit NewtonKrylov(Scalar newton_tolerance = 1e-8,
+      int max_newton_iterations = 10, Scalar krylov_tolerance = 1e-2,
+      int max_krylov_iterations = 100, int krylov_restart = 30)
+      : newton_tolerance_(newton_tolerance),
+        krylov_tolerance_(krylov_tolerance),
+        max_newton_iterations_(max_newton_iterations),
+        max_krylov_iterations_(max_krylov_iterations),
+        krylov_restart_(krylov_restart) {
+  }
+
+  /**
+   * @brief Get the numbers of Newton and Krylov iterations in the last call of Solve.
+   *
+   */
+  int CountNewtonIterations() const {
+    return n_newton_iterations_;
+  }
+  int CountKrylovIterations() const {
+    return n_krylov_iterations_;
+  }
+  /**
+   * @brief Get the number of linear solves stopped by `max_krylov_iterations` before reaching `krylov_tolerance` in the last call of Solve.
+   *
+   * Such an inexact Newton step is still applied, so it only slows down the Newton iteration.
+   */
+  int CountKrylovFailures() const {
+    return n_krylov_failures_;
+  }
+  /**
+   * @brief Whether the last call of Solve reached `newton_tolerance`.
+   *
+   */
+  bool IsConverged() const {
+    return converged_;
+  }
+
+  /**
+   * @brief Solve the stage equation, starting from the current solution of the given System, and leave the root in it.
+   *
+   * @throws std::runtime_error if `newton_tolerance` is not reached in `max_newton_iterations` steps, in which case the last iterate is left in the System.
+   *
+   * @tparam WriteResidual the type of `(Column *) -> void`
+   * @param system the System to be solved
+   * @param implicit the same System as an ImplicitSystem, or `nullptr` for the default inner product and preconditioner
+   * @param rhs the right-hand side \f$ B \f$
+   * @param gamma_dt the product of the diagonal coefficient and the time step
+   * @param write_residual write \f$ R \f$ of the current solution of the given System into a given Column
+   */
+  template <class WriteResidual>
+  void Solve(System<Scalar> *system, ImplicitSystem<Scalar> const *implicit,
+      Column const &rhs, Scalar gamma_dt, WriteResidual &&write_residual) {
+    auto dot = [implicit](Column const &x, Column const &y) -> Scalar {
+      return implicit ? implicit->GetInnerProduct(x, y) : x.dot(y);
+    };
+    auto norm = [&dot](Column const &x) {
+      return std::sqrt(dot(x, x));
+    };
+    auto precondition = [implicit](Column *column) {
+      if (implicit) {
+        implicit->ApplyPreconditioner(column);
+      }
+    };
+    Scalar target = newton_tolerance_ * std::max(norm(rhs), Scalar(1));
+    Scalar sqrt_epsilon = std::sqrt(std::numeric_limits<Scalar>::epsilon());
+    n_newton_iterations_ = n_krylov_iterations_ = n_krylov_failures_ = 0;
+    system->WriteSolutionTo(&u_);
+    write_residual(&residual_);
+    newton_residual_ = u_ - gamma_dt * residual_ - rhs;
+    Scalar u_norm = norm(u_);
+    // J v = v - gamma_dt * (R(U + eps * v) - R(U)) / eps
+    auto multiply = [&](Column const &v, Column *j_v) {
+      Scalar v_norm = norm(v);
+      if (v_norm == 0) {
+        j_v->setZero(v.size());
+        return;
+      }
+      Scalar eps = sqrt_epsilon * (1 + u_norm) / v_norm;
+      u_perturbed_ = u_ + eps * v;
+      system->SetSolutionColumn(u_perturbed_);
+      write_residual(&residual_perturbed_);
+      *j_v = v - (gamma_dt / eps) * (residual_perturbed_ - residual_);
+    };
+    Scalar newton_residual_norm = norm(newton_residual_);
+    while (n_newton_iterations_ < max_newton_iterations_
+        && newton_residual_norm > target) {
+      update_.setZero(u_.size());
+      bool krylov_converged;
+      n_krylov_iterations_ += algebra::krylov::Gmres(multiply, precondition,
+          dot, Column(-newton_residual_), &update_, krylov_tolerance_,
+          max_krylov_iterations_, krylov_restart_, &krylov_converged);
+      n_krylov_failures_ += !krylov_converged;
+      u_ += update_;
+      system->SetSolutionColumn(u_);
+      system->WriteSolutionTo(&u_);
+      u_norm = norm(u_);
+      write_residual(&residual_);
+      newton_residual_ = u_ - gamma_dt * residual_ - rhs;
+      newton_residual_norm = norm(newton_residual_);
+      ++n_newton_iterations_;
+    }
+    converged_ = newton_residual_norm <= target;
+    if (!converged_) {
+      throw std::runtime_error("NewtonKrylov did not converge in "
+          + std::to_string(n_newton_iterations_) + " steps, in which "
+          + std::to_string(n_krylov_failures_) + " linear solves failed.");
+    }
+  }
+};
+
+/**
+ * @brief The 2nd-order, L-stable, stiffly accurate, singly diagonally implicit Runge--Kutta method, whose stages are solved by NewtonKrylov.
+ *
+ * Its tableau is the implicit half of ImexRungeKutta, i.e. \f$ \gamma = 1 - 1/\sqrt{2} \f$, \f$ c = (\gamma, 1) \f$, \f$ A = ((\gamma, 0), (1 - \gamma, \gamma)) \f$, and \f$ b \f$ is the last row of \f$ A \f$.
+ * Both stages share the same \f$ \gamma\,\Delta t \f$, so the preconditioner of an ImplicitSystem is updated only once per step.
+ *
+ * @tparam Scalar the type of scalar variables
+ */
+template <typename Scalar>
+class ImplicitRungeKutta : public Solver<Scalar> {
+ private:
+  using Base = Solver<Scalar>;
+
+ public:
+  using Column = typename Base::Column;
+  static constexpr Scalar kGamma = 0.29289321881345247560;  // 1 - 1 / sqrt(2)
+
+ private:
+  NewtonKrylov<Scalar> newton_krylov_;
+  Column u_old_, u_stage_, rhs_;
+
+ public:
+  template <class... Args>
+  explicit ImplicitRungeKutta(Args &&...args)
+      : newton_krylov_(std::forward<Args>(args)...) {
+  }
+
+  NewtonKrylov<Scalar> const &newton_krylov() const {
+    return newton_krylov_;
+  }
+
+  void Update(System<Scalar> *system, double t_curr, double dt) final {
+    auto *implicit = dynamic_cast<ImplicitSystem<Scalar> *>(system);
+    auto write_residual = [system](Column *residual) {
+      system->WriteResidualTo(residual);
+    };
+    Scalar gamma_dt = kGamma * dt;
+    system->SetTime(t_curr);
+    if (implicit) {
+      implicit->UpdatePreconditioner(gamma_dt);
+    }
+    system->WriteSolutionTo(&u_old_);
+    // U_1 - gamma_dt * R(U_1) = U_old
+    system->SetTime(t_curr + kGamma * dt);
+    newton_krylov_.Solve(system, implicit, u_old_, gamma_dt, write_residual);
+    // R(U_1) = (U_1 - U_old) / gamma_dt avoids amplifying the Newton error.
+    system->WriteSolutionTo(&u_stage_);
+    rhs_ = u_old_ + ((1 - kGamma) / kGamma) * (u_stage_ - u_old_);
+    // U_new - gamma_dt * R(U_new) = U_old + (1 - gamma) * dt * R(U_1)
+    system->SetTime(t_curr + dt);
+    newton_krylov_.Solve(system, implicit, rhs_, gamma_dt, write_residual);
+  }
+};
+
+/**
+ * @brief The 2nd-order implicit-explicit Runge--Kutta method ARS(2,2,2), which treats only the stiff part of the residual of an ImplicitSystem implicitly.
+ *
+ * Its implicit tableau is that of ImplicitRungeKutta, and its explicit tableau is \f$ c = (0, \gamma, 1) \f$, \f$ A = ((0, 0, 0), (\gamma, 0, 0), (\delta, 1 - \delta, 0)) \f$, \f$ b = (\delta, 1 - \delta, 0) \f$, in which \f$ \delta = 1 - 1 / (2 \gamma) \f$.
+ * Both methods are stiffly accurate, so the solution of the last stage is the new solution.
+ * Each Krylov iteration evaluates only the stiff part by ImplicitSystem::WriteStiffResidualTo, which solves no Riemann problem in spatial::FiniteElement.
+ *
+ * @tparam Scalar the type of scalar variables
+ */
+template <typename Scalar>
+class ImexRungeKutta : public Solver<Scalar> {
+ private:
+  using Base = Solver<Scalar>;
+
+ public:
+  using Column = typename Base::Column;
+  static constexpr Scalar kGamma = ImplicitRungeKutta<Scalar>::kGamma;
+  static constexpr Scalar kDelta = -0.70710678118654752440;  // 1 - 1 / (2 gamma)
+
+ private:
+  NewtonKrylov<Scalar> newton_krylov_;
+  Column u_old_, u_stage_, rhs_, stiff_, nonstiff_1_, nonstiff_2_;
+
+ public:
+  template <class... Args>
+  explicit ImexRungeKutta(Args &&...args)
+      : newton_krylov_(std::forward<Args>(args)...) {
+  }
+
+  NewtonKrylov<Scalar> const &newton_krylov() const {
+    return newton_krylov_;
+  }
+
+  void Update(System<Scalar> *system, double t_curr, double dt) final {
+    auto *implicit = dynamic_cast<ImplicitSystem<Scalar> *>(system);
+    if (implicit == nullptr) {
+      throw std::invalid_argument("ImexRungeKutta requires an ImplicitSystem.");
+    }
+    auto write_stiff = [implicit](Column *stiff) {
+      implicit->WriteStiffResidualTo(stiff);
+    };
+    Scalar gamma_dt = kGamma * dt;
+    system->SetTime(t_curr);
+    system->WriteSolutionTo(&u_old_);
+    implicit->WriteNonstiffResidualTo(&nonstiff_1_);
+    implicit->UpdatePreconditioner(gamma_dt);
+    // U_1 - gamma_dt * S(U_1) = U_old + gamma_dt * N(U_old)
+    rhs_ = u_old_ + gamma_dt * nonstiff_1_;
+    system->SetTime(t_curr + kGamma * dt);
+    newton_krylov_.Solve(system, implicit, rhs_, gamma_dt, write_stiff);
+    system->WriteSolutionTo(&u_stage_);
+    implicit->WriteNonstiffResidualTo(&nonstiff_2_);
+    // S(U_1) = (U_1 - rhs) / gamma_dt avoids amplifying the Newton error.
+    stiff_ = (u_stage_ - rhs_) / gamma_dt;
+    // U_new - gamma_dt * S(U_new) = U_old
+    //     + dt * (delta * N(U_old) + (1 - delta) * N(U_1) + (1 - gamma) * S(U_1))
+    rhs_ = u_old_ + dt * (kDelta * nonstiff_1_ + (1 - kDelta) * nonstiff_2_
+        + (1 - kGamma) * stiff_);
+    system->SetTime(t_curr + dt);
+    newton_krylov_.Solve(system, implicit, rhs_, gamma_dt, write_stiff);
+  }
+};
+
+}  // namespace temporal
+}  // namespace mini
+
+#endif  // MINI_TEMPORAL_IMPLICIT_HPP_
@@ -0,0 +1,199 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_TEMPORAL_MULTIGRID_HPP_
+#define MINI_TEMPORAL_MULTIGRID_HPP_
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "mini/temporal/ode.hpp"
+#include "mini/temporal/steady.hpp"
+
+namespace mini {
+namespace temporal {
+
+/**
+ * @brief Accelerate the convergence of a steady System by the Full Approximation Scheme (FAS) on a hierarchy of coarser Systems.
+ *
+ * Each level is a System discretizing the same problem, e.g. FiniteElement's of degrees \f$ P, P-1, \dots, 0 \f$ on the same mesh, and is smoothed by its own Solver, e.g. a RungeKutta or a PseudoTimeStepping.
+ * Each V-cycle on level \f$ l \f$ with forcing \f$ f_l \f$ (zero on the finest level) does the following:
+ *
+ * 1. smooth \f$ R_l(u_l) + f_l = 0 \f$,
+ * 2. restrict \f$ u_{l+1} = I\,u_l \f$ and set \f$ f_{l+1} = I\,(R_l(u_l) + f_l) - R_{l+1}(I\,u_l) \f$,
+ * 3. recurse on level \f$ l+1 \f$ (or only smooth it if it is the coarsest),
+ * 4. correct \f$ u_l \mathrel{+}= P\,(u_{l+1} - I\,u_l) \f$,
+ * 5. smooth \f$ R_l(u_l) + f_l = 0 \f$ again.
+ *
+ * The smoothers only see a forced System that adds \f$ f_l \f$ to the residual and forwards everything else, including SteadySystem, to the level.
+ *
+ * @tparam Scalar the type of scalar variables
+ */
+template <typename Scalar>
+class FullApproximationScheme : public Solver<Scalar> {
+ private:
+  using Base = Solver<Scalar>;
+
+ public:
+  using Column = typename Base::Column;
+  /**
+   * @brief The type of `(Column const &from, Column *to) -> void`, which transfers a Column from one level to an adjacent one.
+   *
+   */
+  using Transfer = std::function<void(Column const &, Column *)>;
+
+ private:
+  /**
+   * @brief A System whose residual is augmented by a given forcing term.
+   *
+   */
+  class Forced : public System<Scalar>, public SteadySystem<Scalar> {
+    System<Scalar> *system_ = nullptr;
+    SteadySystem<Scalar> const *steady_ = nullptr;
+    Column const *forcing_ = nullptr;
+
+   public:
+    void Reset(System<Scalar> *system, Column const *forcing) {
+      system_ = system;
+      steady_ = dynamic_cast<SteadySystem<Scalar> const *>(system);
+      forcing_ = forcing;
+    }
+
+    void SetTime(double t_curr) final {
+      system_->SetTime(t_curr);
+    }
+    void SetSolutionColumn(Column const &column) final {
+      system_->SetSolutionColumn(column);
+    }
+    void WriteSolutionTo(Column *column) const final {
+      system_->WriteSolutionTo(column);
+    }
+    void WriteResidualTo(Column *residual) const final {
+      system_->WriteResidualTo(residual);
+      if (forcing_) {
+        *residual += *forcing_;
+      }
+    }
+    void WriteLocalTimeStepsTo(Column *local_dt, int rk_order) const final {
+      if (steady_ == nullptr) {
+        throw std::invalid_argument(
+            "Local time steps require a SteadySystem on each level.");
+      }
+      steady_->WriteLocalTimeStepsTo(local_dt, rk_order);
+    }
+    std::pair<Scalar, Scalar> GetNorms(Column const &column) const final {
+      return steady_ ? steady_->GetNorms(column)
+          : SteadySystem<Scalar>::GetNorms(column);
+    }
+  };
+
+  struct Level {
+    System<Scalar> *system;
+    Solver<Scalar> *smoother;
+    double dt;
+    Transfer restriction;  // from the finer level to this level
+    Transfer prolongation;  // from this level to the finer level
+    Column forcing;
+    Forced forced;
+  };
+
+  std::vector<Level> levels_;
+  int n_pre_smoothing_, n_post_smoothing_, n_coarsest_smoothing_;
+
+  void Smooth(Level *level, double t_curr, double dt, int n_steps) {
+    for (int i_step = 0; i_step < n_steps; ++i_step) {
+      level->smoother->Update(&level->forced, t_curr, dt);
+    }
+  }
+
+  void Cycle(int i_level, double t_curr, double dt) {
+    Level &fine = levels_[i_level];
+    double fine_dt = std::min(dt, fine.dt);
+    if (i_level + 1 == std::ssize(levels_)) {
+      Smooth(&fine, t_curr, fine_dt, n_coarsest_smoothing_);
+      return;
+    }
+    Smooth(&fine, t_curr, fine_dt, n_pre_smoothing_);
+    // restrict the solution and the residual, then build the coarse forcing
+    Level &coarse = levels_[i_level + 1];
+    Column fine_solution, fine_residual, coarse_solution, coarse_residual;
+    fine.forced.WriteSolutionTo(&fine_solution);
+    fine.forced.WriteResidualTo(&fine_residual);
+    coarse.restriction(fine_solution, &coarse_solution);
+    coarse.restriction(fine_residual, &coarse.forcing);
+    coarse.system->SetTime(t_curr);
+    coarse.system->SetSolutionColumn(coarse_solution);
+    coarse.system->WriteResidualTo(&coarse_residual);
+    coarse.forcing -= coarse_residual;
+    coarse.forced.Reset(coarse.system, &coarse.forcing);
+    Cycle(i_level + 1, t_curr, dt);
+    // prolong the coarse correction
+    Column coarse_correction, fine_correction;
+    coarse.system->WriteSolutionTo(&coarse_correction);
+    coarse_correction -= coarse_solution;
+    coarse.prolongation(coarse_correction, &fine_correction);
+    fine.system->SetSolutionColumn(fine_solution + fine_correction);
+    Smooth(&fine, t_curr, fine_dt, n_post_smoothing_);
+  }
+
+ public:
+  /**
+   * @brief Construct a new FullApproximationScheme object.
+   *
+   * @param n_pre_smoothing the number of smoothing steps on each non-coarsest level before visiting the coarser one
+   * @param n_post_smoothing the number of smoothing steps on each non-coarsest level after visiting the coarser one
+   * @param n_coarsest_smoothing the number of smoothing steps on the coarsest level
+   */
+  explicit FullApproximationScheme(int n_pre_smoothing = 1,
+      int n_post_smoothing = 1, int n_coarsest_smoothing = 4)
+      : n_pre_smoothing_(n_pre_smoothing), n_post_smoothing_(n_post_smoothing),
+        n_coarsest_smoothing_(n_coarsest_smoothing) {
+  }
+
+  /**
+   * @brief Append a level, which is coarser than all existing ones.
+   *
+   * @param system the System on this level, which is not owned by this object
+   * @param smoother the Solver for smoothing this level, which is not owned by this object
+   * @param dt the upper bound of the step passed to the smoother on this level
+   * @param restriction the Transfer from the previous level to this one, which is ignored for the first (finest) level
+   * @param prolongation the Transfer from this level to the previous one, which is ignored for the first (finest) level
+   */
+  void AddLevel(System<Scalar> *system, Solver<Scalar> *smoother,
+      double dt = std::numeric_limits<double>::infinity(),
+      Transfer restriction = {}, Transfer prolongation = {}) {
+    if (levels_.size() && !(restriction && prolongation)) {
+      throw std::invalid_argument(
+          "A coarse level requires both restriction and prolongation.");
+    }
+    levels_.emplace_back(Level{ system, smoother, dt, std::move(restriction),
+        std::move(prolongation), Column(), Forced() });
+  }
+
+  int CountLevels() const {
+    return levels_.size();
+  }
+
+  /**
+   * @brief Run one V-cycle on the given System.
+   *
+   * @param system the System to be updated, which must be the first (finest) level
+   * @param t_curr the physical time, which is passed to the smoothers unchanged
+   * @param dt the upper bound of the steps passed to the smoothers on all levels
+   */
+  void Update(System<Scalar> *system, double t_curr, double dt) final {
+    if (levels_.empty() || system != levels_.front().system) {
+      throw std::invalid_argument(
+          "FullApproximationScheme must be updated on its finest level.");
+    }
+    levels_.front().forced.Reset(system, nullptr);
+    Cycle(0, t_curr, dt);
+  }
+};
+
+}  // namespace temporal
+}  // namespace mini
+
+#endif  // MINI_TEMPORAL_MULTIGRID_HPP_
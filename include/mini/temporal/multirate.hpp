@@ -0,0 +1,175 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_TEMPORAL_MULTIRATE_HPP_
+#define MINI_TEMPORAL_MULTIRATE_HPP_
+
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include "mini/temporal/ode.hpp"
+#include "mini/temporal/rk.hpp"
+
+namespace mini {
+namespace temporal {
+
+/**
+ * @brief The abstract base of ODE systems whose unknowns are grouped into levels of local time stepping.
+ *
+ * The unknowns on level `l` are advanced by `2^l * dt_min`, in which `dt_min` is the step of the finest level.
+ * A macro step of `2^(n_levels - 1) * dt_min` is split into `2^(n_levels - 1)` substeps of `dt_min`, and in the i-th substep only levels that satisfy `i % 2^l == 0` are active.
+ * During a substep, the residual of an active level `l` is scaled by `2^l`, so that a step of `dt_min` on it advances level `l` by `2^l * dt_min`, and the residual of an inactive level is zero.
+ * On a face between two levels, the coarser side predicts the flux at its own rate, and the difference between the flux at the finer rate and the predicted one is written into a separate correction, so that the macro step is conservative.
+ *
+ * @tparam Scalar the type of scalar variables.
+ */
+template <typename Scalar>
+class MultirateSystem : public System<Scalar> {
+ public:
+  using Column = typename System<Scalar>::Column;
+
+  /**
+   * @brief Get the number of levels, which is 1 if local time stepping is disabled.
+   *
+   */
+  virtual int CountTimeLevels() const = 0;
+
+  /**
+   * @brief Write the level of each unknown into a given vector, which has the same size as the solution Column.
+   *
+   * @param levels the vector to be overwritten
+   */
+  virtual void WriteTimeLevelsTo(std::vector<int8_t> *levels) const = 0;
+
+  /**
+   * @brief Select the active levels of the given substep.
+   *
+   * @param i_substep the index of the substep in a macro step, or `-1` to activate all levels with unit scales
+   */
+  virtual void SetSubstep(int i_substep) = 0;
+
+  /**
+   * @brief Write the masked residual and the correction of the current substep into given Columns.
+   *
+   * The residual drives the stages of a substep, while the correction is only integrated by the same weights, so that it does not change the predicted fluxes.
+   *
+   * @param residual the Column to be overwritten by the masked residual
+   * @param correction the Column to be overwritten by the correction on the coarser sides of faces between levels
+   */
+  virtual void WriteSplitResidualTo(Column *residual, Column *correction) const = 0;
+};
+
+/**
+ * @brief The multirate version of RungeKutta, which advances each level of a MultirateSystem by its own step.
+ *
+ * Each substep is a full RungeKutta step of `dt_min` on the masked residual, in which the correction is carried as extra unknowns.
+ * The change of an unknown on level `l` (including its integrated correction) is accumulated in a register and applied only at the end of its own step, so its neighbors on finer levels see the value at the beginning of that step.
+ * Ordinary `System`s (or `MultirateSystem`s with only one level) are advanced by RungeKutta directly.
+ *
+ * @tparam kOrders the number of stages in each substep
+ * @tparam Scalar the type of scalar variables
+ */
+template <int kOrders, typename Scalar>
+class LocalTimeStepping : public Solver<Scalar> {
+ private:
+  using Base = Solver<Scalar>;
+
+ public:
+  using Column = typename Base::Column;
+
+ private:
+  /**
+   * @brief A MultirateSystem whose solution is followed by the integral of its correction.
+   *
+   */
+  class Augmented : public System<Scalar> {
+    MultirateSystem<Scalar> *system_ = nullptr;
+    Column u_, integral_;
+    mutable Column residual_, correction_;
+
+   public:
+    void Reset(MultirateSystem<Scalar> *system) {
+      system_ = system;
+      system_->WriteSolutionTo(&u_);
+      integral_.setZero(u_.size());
+    }
+    Column const &integral() const {
+      return integral_;
+    }
+
+    void SetTime(double t_curr) final {
+      system_->SetTime(t_curr);
+    }
+    void SetSolutionColumn(Column const &column) final {
+      auto n = column.size() / 2;
+      u_ = column.head(n);
+      integral_ = column.tail(n);
+      system_->SetSolutionColumn(u_);
+    }
+    void WriteSolutionTo(Column *column) const final {
+      system_->WriteSolutionTo(column);
+      auto n = column->size();
+      assert(n == integral_.size());
+      column->conservativeResize(2 * n);
+      column->tail(n) = integral_;
+    }
+    void WriteResidualTo(Column *column) const final {
+      system_->WriteSplitResidualTo(&residual_, &correction_);
+      auto n = residual_.size();
+      assert(n == correction_.size());
+      column->resize(2 * n);
+      column->head(n) = residual_;
+      column->tail(n) = correction_;
+    }
+  };
+
+  RungeKutta<kOrders, Scalar> runge_kutta_;
+  Augmented augmented_;
+  // the solution before each substep, the one after it, and the register
+  Column u_old_, u_new_, u_register_;
+  std::vector<int8_t> levels_;
+
+ public:
+  /**
+   * @brief Update the given System from `t_curr` to `(t_curr + dt)`, in which `dt` is the macro step.
+   *
+   * @param system the System to be updated
+   * @param t_curr the time value of the current solution
+   * @param dt the macro step, i.e. `2^(n_levels - 1) * dt_min`
+   */
+  void Update(System<Scalar> *system, double t_curr, double dt) final {
+    auto *multirate = dynamic_cast<MultirateSystem<Scalar> *>(system);
+    if (multirate == nullptr || multirate->CountTimeLevels() == 1) {
+      runge_kutta_.Update(system, t_curr, dt);
+      return;
+    }
+    int n_substeps = 1 << (multirate->CountTimeLevels() - 1);
+    double dt_min = dt / n_substeps;
+    multirate->WriteTimeLevelsTo(&levels_);
+    system->WriteSolutionTo(&u_old_);
+    assert(std::ssize(levels_) == u_old_.size());
+    u_register_.setZero(u_old_.size());
+    for (int i_substep = 0; i_substep < n_substeps; ++i_substep) {
+      multirate->SetSubstep(i_substep);
+      augmented_.Reset(multirate);
+      runge_kutta_.Update(&augmented_, t_curr + i_substep * dt_min, dt_min);
+      system->WriteSolutionTo(&u_new_);
+      u_register_ += u_new_ - u_old_ + augmented_.integral();
+      // Apply the registers of levels whose steps end after this substep.
+      int n_ended = i_substep + 1;
+      for (int i = 0, n = u_old_.size(); i < n; ++i) {
+        if (n_ended % (1 << levels_[i]) == 0) {
+          u_old_[i] += u_register_[i];
+          u_register_[i] = 0;
+        }
+      }
+      system->SetSolutionColumn(u_old_);
+    }
+    multirate->SetSubstep(-1);
+  }
+};
+
+}  // namespace temporal
+}  // namespace mini
+
+#endif  // MINI_TEMPORAL_MULTIRATE_HPP_
@@ -32,19 +32,43 @@ class System {
    */
   virtual void SetSolutionColumn(Column const &) = 0;
 
+  /**
+   * @brief Write the solution into a given Column, which is resized only if its size does not match.
+   * 
+   * @param column the Column to be overwritten
+   */
+  virtual void WriteSolutionTo(Column *column) const = 0;
+
+  /**
+   * @brief Write the residual into a given Column, which is resized only if its size does not match.
+   * 
+   * Solvers reuse the same Column in every step, so no memory is allocated after the first call.
+   * 
+   * @param residual the Column to be overwritten
+   */
+  virtual void WriteResidualTo(Column *residual) const = 0;
+
   /**
    * @brief Get a copy of the solution as a Column.
    * 
    * @return Column 
    */
-  virtual Column GetSolutionColumn() const = 0;
+  Column GetSolutionColumn() const {
+    Column column;
+    WriteSolutionTo(&column);
+    return column;
+  }
 
   /**
    * @brief Get a copy of the residual as a Column.
    * 
    * @return Column 
    */
-  virtual Column GetResidualColumn() const = 0;
+  Column GetResidualColumn() const {
+    Column residual;
+    WriteResidualTo(&residual);
+    return residual;
+  }
 };
 
 /**
@@ -75,12 +99,12 @@ class Constant : public System<Scalar> {
     u_ = u;
   }
 
-  Column GetSolutionColumn() const final {
-    return u_;
+  void WriteSolutionTo(Column *u) const final {
+    *u = u_;
   }
 
-  Column GetResidualColumn() const final {
-    return a_ * u_;
+  void WriteResidualTo(Column *residual) const final {
+    residual->noalias() = a_ * u_;
   }
 };
 
@@ -118,18 +142,30 @@ class Euler : public Solver<Scalar> {
   using Base::Base;
   using Column = typename Base::Column;
 
-  static Column NextSolution(System<Scalar> *system, double t_curr, double dt) {
+ private:
+  Column u_next_, residual_;
+
+ public:
+  /**
+   * @brief Write \f$ U + R(U) * \Delta t \f$ into `u_next`, where \f$ U \f$ is the current solution of the given System.
+   * 
+   * @param system the System to be evaluated
+   * @param t_curr the time value of the current solution
+   * @param dt the time step
+   * @param u_next the Column to hold the result
+   * @param residual the Column to hold the residual, which is reused as a buffer
+   */
+  static void NextSolution(System<Scalar> *system, double t_curr, double dt,
+      Column *u_next, Column *residual) {
     system->SetTime(t_curr);
-    auto u_next = system->GetSolutionColumn();
-    auto residual = system->GetResidualColumn();
-    residual *= dt;
-    u_next += residual;
-    return u_next;
+    system->WriteSolutionTo(u_next);
+    system->WriteResidualTo(residual);
+    *u_next += *residual * dt;
   }
 
   void Update(System<Scalar> *system, double t_curr, double dt) final {
-    auto u_next = NextSolution(system, t_curr, dt);
-    system->SetSolutionColumn(u_next);
+    NextSolution(system, t_curr, dt, &u_next_, &residual_);
+    system->SetSolutionColumn(u_next_);
   }
 };
 
@@ -2,60 +2,242 @@
 #ifndef MINI_TEMPORAL_RK_HPP_
 #define MINI_TEMPORAL_RK_HPP_
 
+#include <array>
+
 #include "mini/temporal/ode.hpp"
 
 namespace mini {
 namespace temporal {
 
+/**
+ * @brief The strong-stability-preserving Runge--Kutta methods.
+ *
+ * The stage registers are kept between steps, so no memory is allocated after the first step.
+ * Each stage reads the solution back from the System, since `System::SetSolutionColumn` might modify it (e.g. by a limiter).
+ *
+ * @tparam kOrders the number of stages, which is also the order of accuracy
+ * @tparam Scalar the type of scalar variables
+ */
 template <int kOrders, typename Scalar>
 struct RungeKutta : public Solver<Scalar> {
  private:
   using Base = Solver<Scalar>;
+
+ public:
+  using Column = typename Base::Column;
+
+ private:
   Euler<Scalar> euler_;
+  // U_old, the solution of the current stage, and its residual
+  Column u_curr_, u_stage_, residual_;
 
   void _Update(System<Scalar> *system, double t_curr, double dt)
       requires(kOrders == 1) {
     euler_.Update(system, t_curr, dt);
   }
 
+  // U_1st = U_old + R_old * dt, which also saves U_old in u_curr_
+  void FirstStage(System<Scalar> *system, double t_curr, double dt) {
+    system->SetTime(t_curr);
+    system->WriteSolutionTo(&u_curr_);
+    system->WriteResidualTo(&residual_);
+    u_stage_ = u_curr_ + residual_ * dt;
+    system->SetSolutionColumn(u_stage_);
+  }
+
   void _Update(System<Scalar> *system, double t_curr, double dt)
       requires(kOrders == 2) {
-    auto u_curr = system->GetSolutionColumn();
-    euler_.Update(system, t_curr, dt);
-    auto u_next = euler_.NextSolution(system, t_curr + dt, dt);
-    u_next += u_curr;
-    u_next *= 0.5;
-    system->SetSolutionColumn(u_next);
+    FirstStage(system, t_curr, dt);
+    Euler<Scalar>::NextSolution(system, t_curr + dt, dt, &u_stage_,
+        &residual_);
+    u_stage_ = (u_stage_ + u_curr_) / 2;
+    // Now, u_stage_ == U_2nd == ((U_1st + R_1st * dt) + U_old) / 2
+    system->SetSolutionColumn(u_stage_);
   }
 
   void _Update(System<Scalar> *system, double t_curr, double dt)
       requires(kOrders == 3) {
-    auto u_curr = system->GetSolutionColumn();
-    euler_.Update(system, t_curr, dt);
-    // Now, system->GetSolutionColumn() == U_1st == U_old + R_old * dt
-    auto u_next = u_curr;
-    u_next *= 3;
-    u_next += euler_.NextSolution(system, t_curr + dt, dt);
-    u_next /= 4;
-    // Now, u_next == U_2nd == ((U_1st + R_1st * dt) + U_old * 3) / 4
-    system->SetSolutionColumn(u_next);
-    u_next = euler_.NextSolution(system, t_curr + dt / 2, dt);
-    // Now, u_next == U_2nd + R_2nd * dt
-    u_next *= 2;
-    u_next += u_curr;
-    u_next /= 3;
-    // Now, u_next == U_3rd == ((U_2nd + R_2nd * dt) * 2 + U_old) / 3
-    system->SetSolutionColumn(u_next);
+    FirstStage(system, t_curr, dt);
+    Euler<Scalar>::NextSolution(system, t_curr + dt, dt, &u_stage_,
+        &residual_);
+    u_stage_ = (u_stage_ + u_curr_ * 3) / 4;
+    // Now, u_stage_ == U_2nd == ((U_1st + R_1st * dt) + U_old * 3) / 4
+    system->SetSolutionColumn(u_stage_);
+    Euler<Scalar>::NextSolution(system, t_curr + dt / 2, dt, &u_stage_,
+        &residual_);
+    u_stage_ = (u_stage_ * 2 + u_curr_) / 3;
+    // Now, u_stage_ == U_3rd == ((U_2nd + R_2nd * dt) * 2 + U_old) / 3
+    system->SetSolutionColumn(u_stage_);
+  }
+
+ public:
+  void Update(System<Scalar> *system, double t_curr, double dt) final {
+    _Update(system, t_curr, dt);
+  }
+};
+
+/**
+ * @brief The low-storage explicit Runge--Kutta methods in Williamson's 2N form.
+ *
+ * The i-th stage updates \f$ \Delta U \leftarrow A_i\,\Delta U + R(U)\,\Delta t \f$ and then \f$ U \leftarrow U + B_i\,\Delta U \f$.
+ * The residual is consumed by \f$ \Delta U \f$ before the solution is read back, so they share one buffer, and only two Columns are kept no matter how many stages there are.
+ * The available methods are
+ *   - `<3, 3>`: Williamson's method, whose stability polynomial (and hence CFL number) is the same as RungeKutta<3>'s,
+ *   - `<5, 4>`: Carpenter and Kennedy's method, whose stable step is about 1.6 times of RungeKutta<3>'s on DG spectra.
+ *
+ * Neither of them is strong-stability-preserving, since some of \f$ A_i \f$ and \f$ B_i \f$ are negative.
+ * In particular, `<5, 4>` is linearly stable but not SSP, so it might produce oscillations that a limiter applied in `System::SetSolutionColumn` cannot remove, and it is unsafe for flows with shocks.
+ * Use RungeKutta or SspRungeKutta with limiters.
+ *
+ * @tparam kStages the number of stages
+ * @tparam kOrders the order of accuracy
+ * @tparam Scalar the type of scalar variables
+ */
+template <int kStages, int kOrders, typename Scalar>
+class LowStorageRungeKutta : public Solver<Scalar> {
+ private:
+  using Base = Solver<Scalar>;
+
+ public:
+  using Column = typename Base::Column;
+
+ private:
+  struct Coefficients {
+    std::array<double, kStages> a, b, c;
+  };
+
+  static constexpr Coefficients GetCoefficients()
+      requires(kStages == 3 && kOrders == 3) {
+    return {
+      { 0.0, -5.0 / 9, -153.0 / 128 },
+      { 1.0 / 3, 15.0 / 16, 8.0 / 15 },
+      { 0.0, 1.0 / 3, 3.0 / 4 },
+    };
   }
 
+  static constexpr Coefficients GetCoefficients()
+      requires(kStages == 5 && kOrders == 4) {
+    return {
+      {
+        0.0,
+        -567301805773.0 / 1357537059087,
+        -2404267990393.0 / 2016746695238,
+        -3550918686646.0 / 2091501179385,
+        -1275806237668.0 / 842570457699,
+      }, {
+        1432997174477.0 / 9575080441755,
+        5161836677717.0 / 13612068292357,
+        1720146321549.0 / 2090206949498,
+        3134564353537.0 / 4481467310338,
+        2277821191437.0 / 14882151754819,
+      }, {
+        0.0,
+        1432997174477.0 / 9575080441755,
+        2526269341429.0 / 6820363962896,
+        2006345519317.0 / 3224310063776,
+        2802321613138.0 / 2924317926251,
+      },
+    };
+  }
+
+  // Delta U, and the buffer for the residual or the solution
+  Column du_, buffer_;
+
+ public:
+  void Update(System<Scalar> *system, double t_curr, double dt) final {
+    constexpr Coefficients kCoefficients = GetCoefficients();
+    for (int i = 0; i < kStages; ++i) {
+      system->SetTime(t_curr + kCoefficients.c[i] * dt);
+      system->WriteResidualTo(&buffer_);
+      if (i == 0) {
+        du_ = buffer_ * dt;
+      } else {
+        du_ *= kCoefficients.a[i];
+        du_ += buffer_ * dt;
+      }
+      system->WriteSolutionTo(&buffer_);
+      buffer_ += du_ * kCoefficients.b[i];
+      system->SetSolutionColumn(buffer_);
+    }
+  }
+};
+
+/**
+ * @brief The optimal strong-stability-preserving Runge--Kutta methods of second order with `kStages` stages, i.e. SSPRK(m,2).
+ *
+ * The first `kStages - 1` stages are forward Euler steps of size \f$ \Delta t / (m - 1) \f$, and the last one averages the result with \f$ U_\mathrm{old} \f$, so the same three Columns as RungeKutta<3>'s are kept no matter how many stages there are.
+ * The SSP coefficient is \f$ m - 1 \f$, i.e. the stable step is \f$ m - 1 \f$ times of RungeKutta<2>'s at the cost of \f$ m \f$ residual evaluations.
+ *
+ * @tparam kStages the number of stages, which must be at least 2
+ * @tparam Scalar the type of scalar variables
+ */
+template <int kStages, typename Scalar>
+class SspRungeKutta : public Solver<Scalar> {
+  static_assert(kStages >= 2);
+
+ private:
+  using Base = Solver<Scalar>;
+
  public:
   using Column = typename Base::Column;
 
+ private:
+  // U_old, the solution of the current stage, and its residual
+  Column u_curr_, u_stage_, residual_;
+
+ public:
   void Update(System<Scalar> *system, double t_curr, double dt) final {
-    _Update(system, t_curr, dt);
+    constexpr int m = kStages;
+    double dt_stage = dt / (m - 1);
+    system->WriteSolutionTo(&u_curr_);
+    for (int i = 0; i < m - 1; ++i) {
+      Euler<Scalar>::NextSolution(system, t_curr + i * dt_stage, dt_stage,
+          &u_stage_, &residual_);
+      system->SetSolutionColumn(u_stage_);
+    }
+    Euler<Scalar>::NextSolution(system, t_curr + dt, dt_stage,
+        &u_stage_, &residual_);
+    u_stage_ = (u_stage_ * (m - 1) + u_curr_) / m;
+    // Now, u_stage_ == ((U_{m-1} + R_{m-1} * dt_stage) * (m - 1) + U_old) / m
+    system->SetSolutionColumn(u_stage_);
   }
 };
 
+/**
+ * @brief The CFL number of a Runge--Kutta method, given as a ratio to that of `RungeKutta<kRkOrder>`, which is tabulated in `spatial::FiniteElement`.
+ *
+ * @tparam Solver the type of the Runge--Kutta method
+ */
+template <class Solver>
+struct CflTraits;
+
+template <int kOrders, typename Scalar>
+struct CflTraits<RungeKutta<kOrders, Scalar>> {
+  static constexpr int kRkOrder = kOrders;
+  static constexpr double kRatio = 1.0;
+};
+
+template <typename Scalar>
+struct CflTraits<LowStorageRungeKutta<3, 3, Scalar>> {
+  // the same stability polynomial as RungeKutta<3>'s
+  static constexpr int kRkOrder = 3;
+  static constexpr double kRatio = 1.0;
+};
+
+template <typename Scalar>
+struct CflTraits<LowStorageRungeKutta<5, 4, Scalar>> {
+  // the smallest ratio on DG spectra of degrees from 0 to 8
+  static constexpr int kRkOrder = 3;
+  static constexpr double kRatio = 1.65;
+};
+
+template <int kStages, typename Scalar>
+struct CflTraits<SspRungeKutta<kStages, Scalar>> {
+  // the ratio of SSP coefficients
+  static constexpr int kRkOrder = 2;
+  static constexpr double kRatio = kStages - 1;
+};
+
 }  // namespace temporal
 }  // namespace mini
 
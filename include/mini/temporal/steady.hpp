@@ -0,0 +1,195 @@
+// Copyright 2024 PEI Weicheng
+#ifndef MINI_TEMPORAL_STEADY_HPP_
+#define MINI_TEMPORAL_STEADY_HPP_
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "mini/temporal/ode.hpp"
+#include "mini/temporal/rk.hpp"
+
+namespace mini {
+namespace temporal {
+
+/**
+ * @brief The optional interface of ODE systems that are marched to steady states by local pseudo time steps.
+ *
+ * Like ImplicitSystem, it does not derive from System, and solvers access it by `dynamic_cast`.
+ *
+ * @tparam Scalar the type of scalar variables.
+ */
+template <typename Scalar>
+class SteadySystem {
+ public:
+  using Column = typename System<Scalar>::Column;
+
+  /**
+   * @brief Write the stable time step of each unknown into a given Column, which has the same size as the solution Column.
+   *
+   * @param local_dt the Column to be overwritten
+   * @param rk_order the order of the Runge--Kutta method
+   */
+  virtual void WriteLocalTimeStepsTo(Column *local_dt, int rk_order) const = 0;
+
+  /**
+   * @brief Get the L2 norm and the Linf norm of a Column, which should be reduced over all processes if the System is distributed.
+   *
+   * Both norms of an empty Column are zero.
+   */
+  virtual std::pair<Scalar, Scalar> GetNorms(Column const &column) const {
+    if (column.size() == 0) {
+      return { 0, 0 };
+    }
+    return { column.norm(), column.cwiseAbs().maxCoeff() };
+  }
+};
+
+/**
+ * @brief March a SteadySystem in pseudo time, in which each unknown is advanced by its own stable step, and monitor the residual.
+ *
+ * Each step is a RungeKutta step of unit size on the residual multiplied by the local steps, which are updated at the beginning of the step.
+ * The physical time is frozen during the march.
+ * The norms of the unscaled residual are taken from the first stage of each step, so they belong to the solution before that step and no extra residual is evaluated.
+ *
+ * @tparam kOrders the number of stages in each step
+ * @tparam Scalar the type of scalar variables
+ */
+template <int kOrders, typename Scalar>
+class PseudoTimeStepping : public Solver<Scalar> {
+ private:
+  using Base = Solver<Scalar>;
+
+ public:
+  using Column = typename Base::Column;
+
+ private:
+  /**
+   * @brief A SteadySystem whose residual is multiplied by the local steps.
+   *
+   */
+  class Scaled : public System<Scalar> {
+    System<Scalar> *system_ = nullptr;
+    SteadySystem<Scalar> const *steady_ = nullptr;
+    Column const *local_dt_ = nullptr;
+    double t_curr_ = 0;
+    mutable std::pair<Scalar, Scalar> norms_;
+    mutable bool monitored_ = false;
+
+   public:
+    void Reset(System<Scalar> *system, SteadySystem<Scalar> const *steady,
+        Column const *local_dt, double t_curr) {
+      system_ = system;
+      steady_ = steady;
+      local_dt_ = local_dt;
+      t_curr_ = t_curr;
+      monitored_ = false;
+    }
+    std::pair<Scalar, Scalar> const &norms() const {
+      return norms_;
+    }
+
+    // The pseudo time is ignored, since the physical time is frozen.
+    void SetTime(double) final {
+      system_->SetTime(t_curr_);
+    }
+    void SetSolutionColumn(Column const &column) final {
+      system_->SetSolutionColumn(column);
+    }
+    void WriteSolutionTo(Column *column) const final {
+      system_->WriteSolutionTo(column);
+    }
+    void WriteResidualTo(Column *residual) const final {
+      system_->WriteResidualTo(residual);
+      if (!monitored_) {
+        norms_ = steady_->GetNorms(*residual);
+        monitored_ = true;
+      }
+      *residual = residual->cwiseProduct(*local_dt_);
+    }
+  };
+
+  RungeKutta<kOrders, Scalar> runge_kutta_;
+  Scaled scaled_;
+  Column local_dt_;
+  std::pair<Scalar, Scalar> initial_norms_, norms_;
+  Scalar orders_of_drop_;
+  int n_steps_ = 0;
+
+ public:
+  /**
+   * @brief Construct a new PseudoTimeStepping object.
+   *
+   * @param orders_of_drop the march is converged once the L2 norm of the residual has dropped by this number of orders of magnitude
+   */
+  explicit PseudoTimeStepping(Scalar orders_of_drop = 6)
+      : orders_of_drop_(orders_of_drop) {
+  }
+
+  /**
+   * @brief Advance the given SteadySystem by one pseudo step.
+   *
+   * @param system the System to be updated, which must be a SteadySystem
+   * @param t_curr the physical time, which is passed to the System unchanged
+   * @param dt the upper bound of local steps
+   */
+  void Update(System<Scalar> *system, double t_curr, double dt) final {
+    auto *steady = dynamic_cast<SteadySystem<Scalar> *>(system);
+    if (steady == nullptr) {
+      throw std::invalid_argument(
+          "PseudoTimeStepping requires a SteadySystem.");
+    }
+    steady->WriteLocalTimeStepsTo(&local_dt_, kOrders);
+    local_dt_ = local_dt_.cwiseMin(Scalar(dt));
+    scaled_.Reset(system, steady, &local_dt_, t_curr);
+    runge_kutta_.Update(&scaled_, 0.0, 1.0);
+    norms_ = scaled_.norms();
+    if (n_steps_++ == 0) {
+      initial_norms_ = norms_;
+    }
+  }
+
+  /**
+   * @brief Restart the monitor, so that the next step gives the initial norms.
+   *
+   */
+  void Reset() {
+    n_steps_ = 0;
+  }
+
+  int CountSteps() const {
+    return n_steps_;
+  }
+
+  /**
+   * @brief Get the L2 norm and the Linf norm of the residual before the last step.
+   *
+   */
+  std::pair<Scalar, Scalar> const &GetResidualNorms() const {
+    return norms_;
+  }
+
+  /**
+   * @brief Get the number of orders of magnitude by which the L2 norm of the residual has dropped.
+   *
+   */
+  Scalar GetOrdersOfDrop() const {
+    if (n_steps_ == 0) {
+      return 0;
+    }
+    if (norms_.first == 0) {
+      return std::numeric_limits<Scalar>::infinity();
+    }
+    return std::log10(initial_norms_.first / norms_.first);
+  }
+
+  bool IsConverged() const {
+    return n_steps_ > 0 && GetOrdersOfDrop() >= orders_of_drop_;
+  }
+};
+
+}  // namespace temporal
+}  // namespace mini
+
+#endif  // MINI_TEMPORAL_STEADY_HPP_
@@ -0,0 +1,180 @@
+// Copyright 2024 PEI Weicheng
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "mini/aircraft/airfoil.hpp"
+#include "mini/aircraft/rotor.hpp"
+#include "mini/aircraft/source.hpp"
+#include "mini/algebra/eigen.hpp"
+#include "mini/coordinate/tetrahedron.hpp"
+#include "mini/coordinate/triangle.hpp"
+#include "mini/geometry/frame.hpp"
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief A minimal `Part` of tetrahedral `Cell`s, which provides only what `Rotorcraft` needs.
+ *
+ */
+struct TetraPart {
+  using Scalar = double;
+  using Global = mini::algebra::Vector<Scalar, 3>;
+  using Value = mini::algebra::Vector<Scalar, 5>;
+
+  struct Face {
+    struct Integrator {
+      mini::coordinate::Triangle3<Scalar, 3> coordinate_;
+      auto const &coordinate() const {
+        return coordinate_;
+      }
+    } integrator_;
+    auto const &integrator() const {
+      return integrator_;
+    }
+  };
+
+  struct Cell {
+    using Scalar = TetraPart::Scalar;
+    using Global = TetraPart::Global;
+    using Face = TetraPart::Face;
+    static constexpr int N = 4;  // the linear basis {1, x, y, z}
+    struct Polynomial {
+      using Coeff = mini::algebra::Matrix<Scalar, 5, N>;
+    };
+
+    mini::coordinate::Tetrahedron4<Scalar> coordinate_;
+    std::array<Face, 4> faces_;
+    std::vector<Face const *> adj_faces_;
+    Scalar length_;
+
+    auto const &coordinate() const {
+      return coordinate_;
+    }
+    Scalar length() const {
+      return length_;
+    }
+    static Value GlobalToValue(Global const &xyz) {
+      Scalar rho = 1 + 0.1 * xyz[0];
+      Global uvw{10 + xyz[1], 2 - xyz[2], 1 + xyz[0]};
+      Value value;
+      value[0] = rho;
+      value.segment<3>(1) = rho * uvw;
+      value[4] = 2.5 + 0.5 * rho * uvw.squaredNorm();
+      return value;
+    }
+    static mini::algebra::Matrix<Scalar, 1, N> GlobalToBasisValues(
+        Global const &xyz) {
+      return { 1.0, xyz[0], xyz[1], xyz[2] };
+    }
+  };
+
+  std::vector<Cell> cells_;
+
+  /**
+   * @brief Split each cube of an `n x n x n` grid on `[-1, 1]^3` into 6 tetrahedra sharing its main diagonal.
+   *
+   */
+  explicit TetraPart(int n) {
+    Scalar h = 2.0 / n;
+    constexpr std::array<std::array<int, 3>, 6> kPermutations{{
+      {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0} }};
+    for (int k = 0; k < n; ++k) {
+      for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) {
+          Global origin{-1 + i * h, -1 + j * h, -1 + k * h};
+          for (auto const &permutation : kPermutations) {
+            std::array<Global, 4> nodes;
+            nodes[0] = origin;
+            for (int a = 0; a < 3; ++a) {
+              nodes[a + 1] = nodes[a];
+              nodes[a + 1][permutation[a]] += h;
+            }
+            auto &cell = cells_.emplace_back();
+            cell.coordinate_ = { nodes[0], nodes[1], nodes[2], nodes[3] };
+            cell.faces_[0].integrator_.coordinate_ = { nodes[1], nodes[2], nodes[3] };
+            cell.faces_[1].integrator_.coordinate_ = { nodes[0], nodes[2], nodes[3] };
+            cell.faces_[2].integrator_.coordinate_ = { nodes[0], nodes[1], nodes[3] };
+            cell.faces_[3].integrator_.coordinate_ = { nodes[0], nodes[1], nodes[2] };
+            cell.length_ = h;
+          }
+        }
+      }
+    }
+    // `faces_` are not moved anymore
+    for (auto &cell : cells_) {
+      for (auto const &face : cell.faces_) {
+        cell.adj_faces_.emplace_back(&face);
+      }
+    }
+  }
+};
+
+class TestRotorcraft : public ::testing::Test {
+ protected:
+  using Scalar = double;
+  using Rotorcraft = mini::aircraft::Rotorcraft<TetraPart>;
+  using Cell = TetraPart::Cell;
+  using Coeff = Cell::Polynomial::Coeff;
+  using Airfoil = mini::aircraft::airfoil::Linear<Scalar>;
+
+  // Blades refer to these airfoils, so they must outlive the Rotorcraft.
+  std::vector<Airfoil> airfoils_{ Airfoil(0.08, 0.02), Airfoil(0.10, 0.04) };
+
+  Rotorcraft BuildRotorcraft() const {
+    auto rotor = mini::aircraft::Rotor<Scalar>();
+    rotor.SetRevolutionsPerSecond(10.0);
+    rotor.SetOrigin(0.0123, -0.0217, 0.0311);
+    auto frame = mini::geometry::Frame<Scalar>();
+    frame.RotateY(-5/* deg */);
+    rotor.SetFrame(frame);
+    auto blade = mini::aircraft::Blade<Scalar>();
+    blade.InstallSection(0.0, 0.3, 0.0, airfoils_[0]);
+    blade.InstallSection(0.8, 0.1, -5.0, airfoils_[1]);
+    Scalar root{0.1};
+    rotor.InstallBlade(root, blade);
+    rotor.InstallBlade(root, blade);
+    rotor.InstallBlade(root, blade);
+    auto rotorcraft = Rotorcraft();
+    rotorcraft.InstallRotor(rotor);
+    return rotorcraft;
+  }
+};
+TEST_F(TestRotorcraft, UpdateCoeffsByBins) {
+  auto part = TetraPart(7);
+  auto n_cells = std::ssize(part.cells_);
+  auto rotorcraft = BuildRotorcraft();
+  rotorcraft.BuildCellIndex(part.cells_);
+  auto coeffs_on_all = std::vector<Coeff>(n_cells);
+  auto coeffs_by_bins = std::vector<Coeff>(n_cells);
+  for (double t_curr : {0.0037, 0.0113, 0.0271, 0.0432}) {
+    for (auto &coeff : coeffs_on_all) {
+      coeff.setZero();
+    }
+    for (auto &coeff : coeffs_by_bins) {
+      coeff.setZero();
+    }
+    // the old way, which visits all cells
+    for (int i_cell = 0; i_cell < n_cells; ++i_cell) {
+      rotorcraft.UpdateCoeff(part.cells_[i_cell], t_curr,
+          coeffs_on_all[i_cell].data());
+    }
+    // the new way, which only visits cells touched by some blade
+    rotorcraft.UpdateCoeffs(t_curr, [&](Cell const &cell) {
+      return coeffs_by_bins[&cell - part.cells_.data()].data();
+    });
+    int n_touched = 0;
+    for (int i_cell = 0; i_cell < n_cells; ++i_cell) {
+      EXPECT_EQ(coeffs_on_all[i_cell], coeffs_by_bins[i_cell]);
+      n_touched += (coeffs_on_all[i_cell].squaredNorm() > 0);
+    }
+    // each blade crosses several cells, but far fewer than all of them
+    EXPECT_GT(n_touched, 3 * 4);
+    EXPECT_LT(n_touched * 10, n_cells);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,66 @@
+// Copyright 2024 PEI Weicheng
+#include <vector>
+
+#include "mini/geometry/bins.hpp"
+
+#include "gtest/gtest.h"
+
+class TestBins : public ::testing::Test {
+ protected:
+  using Scalar = double;
+  using Bins = mini::geometry::Bins<Scalar>;
+  using Point = typename Bins::Point;
+};
+TEST_F(TestBins, IntersectBox) {
+  Point lower{0, 0, 0}, upper{1, 1, 1};
+  EXPECT_TRUE(mini::geometry::IntersectBox(
+      Point(-1, 0.5, 0.5), Point(2, 0.5, 0.5), lower, upper));
+  EXPECT_TRUE(mini::geometry::IntersectBox(
+      Point(0.2, 0.2, 0.2), Point(0.8, 0.8, 0.8), lower, upper));
+  EXPECT_FALSE(mini::geometry::IntersectBox(
+      Point(-1, 0.5, 0.5), Point(-0.1, 0.5, 0.5), lower, upper));
+  EXPECT_FALSE(mini::geometry::IntersectBox(
+      Point(-1, 1.5, 0.5), Point(2, 1.5, 0.5), lower, upper));
+  // passing by the edge `x = 0, y = 1`
+  EXPECT_FALSE(mini::geometry::IntersectBox(
+      Point(-1, 0.5, 0.5), Point(0.5, 2, 0.5), lower, upper));
+}
+TEST_F(TestBins, QueryOnGrid) {
+  // 10 x 10 x 10 unit boxes
+  constexpr int n = 10;
+  auto lowers = std::vector<Point>(), uppers = std::vector<Point>();
+  for (int k = 0; k < n; ++k) {
+    for (int j = 0; j < n; ++j) {
+      for (int i = 0; i < n; ++i) {
+        lowers.emplace_back(i, j, k);
+        uppers.emplace_back(i + 1, j + 1, k + 1);
+      }
+    }
+  }
+  auto bins = Bins(lowers, uppers);
+  EXPECT_EQ(bins.CountBoxes(), n * n * n);
+  EXPECT_GT(bins.CountBins(), 1);
+  auto boxes = std::vector<int>();
+  auto brute_force = [&](Point const &p, Point const &q) {
+    auto expected = std::vector<int>();
+    for (int i_box = 0; i_box < n * n * n; ++i_box) {
+      if (mini::geometry::IntersectBox(p, q, lowers[i_box], uppers[i_box])) {
+        expected.emplace_back(i_box);
+      }
+    }
+    return expected;
+  };
+  // a segment along the x-axis only touches one row of boxes
+  Point p{-1, 4.5, 4.5}, q{11, 4.5, 4.5};
+  bins.Query(p, q, &boxes);
+  EXPECT_EQ(boxes.size(), n);
+  EXPECT_EQ(boxes, brute_force(p, q));
+  // a skew segment
+  p = Point(0.3, 0.2, 0.1); q = Point(9.7, 6.1, 3.3);
+  bins.Query(p, q, &boxes);
+  EXPECT_EQ(boxes, brute_force(p, q));
+  // a segment outside the grid
+  p = Point(-3, -3, -3); q = Point(-1, -2, -1);
+  bins.Query(p, q, &boxes);
+  EXPECT_TRUE(boxes.empty());
+}
@@ -24,6 +24,7 @@
 #include "mini/integrator/quadrangle.hpp"
 #include "mini/integrator/hexahedron.hpp"
 #include "mini/polynomial/projection.hpp"
+#include "mini/limiter/detector.hpp"
 #include "mini/limiter/weno.hpp"
 #include "mini/limiter/reconstruct.hpp"
 #include "mini/riemann/rotated/single.hpp"
@@ -86,6 +87,147 @@ TEST_F(TestWenoLimiters, Smoothness) {
   EXPECT_NEAR(s_actual[Index::XZ], 16./3 * w1 + 8 * w2, 1e-15);
   EXPECT_NEAR(s_actual[Index::YZ], 16./3 * w1 + 8 * w2, 1e-14);
 }
+TEST_F(TestWenoLimiters, PerssonPeraire) {
+  using Projection = mini::polynomial::Projection<double, 3, 2, 1>;
+  using Cell = mini::mesh::part::Cell<cgsize_t, Projection>;
+  using Value = typename Cell::Value;
+  auto coords = {
+      Coord{-1, -1, -1}, Coord{+1, -1, -1},
+      Coord{+1, +1, -1}, Coord{-1, +1, -1},
+      Coord{-1, -1, +1}, Coord{+1, -1, +1},
+      Coord{+1, +1, +1}, Coord{-1, +1, +1},
+  };
+  auto coordinate_uptr = std::make_unique<Coordinate>(coords);
+  auto integrator_uptr = std::make_unique<Integrator>(*coordinate_uptr);
+  auto cell = Cell(std::move(coordinate_uptr), std::move(integrator_uptr), 0);
+  auto detector = mini::limiter::detector::PerssonPeraire<Cell>();
+  // a smooth function is not troubled
+  cell.Approximate([](Coord const &xyz) {
+    return Value(1 + 0.1 * xyz[0] + 0.01 * xyz[1] * xyz[2]);
+  });
+  EXPECT_FALSE(detector.IsNotSmooth(cell));
+  // a discontinuous function is troubled
+  cell.Approximate([](Coord const &xyz) {
+    return Value(xyz[0] < 0.5 ? 0.0 : 1.0);
+  });
+  EXPECT_TRUE(detector.IsNotSmooth(cell));
+  // every cell is troubled for the default detector
+  EXPECT_TRUE(mini::limiter::detector::Always<Cell>().IsNotSmooth(cell));
+}
+TEST_F(TestWenoLimiters, Krivodonova) {
+  using Projection = mini::polynomial::Projection<double, 3, 2, 5>;
+  using Cell = mini::mesh::part::Cell<cgsize_t, Projection>;
+  using Face = typename Cell::Face;
+  using Value = typename Cell::Value;
+  using FaceCoordinate = mini::coordinate::Quadrangle4<double, 3>;
+  using FaceIntegrator = mini::integrator::Quadrangle<3, Gx, Gx>;
+  auto build_cell = [](double x_min, cgsize_t id) {
+    auto coords = {
+        Coord{x_min + 0, -1, -1}, Coord{x_min + 2, -1, -1},
+        Coord{x_min + 2, +1, -1}, Coord{x_min + 0, +1, -1},
+        Coord{x_min + 0, -1, +1}, Coord{x_min + 2, -1, +1},
+        Coord{x_min + 2, +1, +1}, Coord{x_min + 0, +1, +1},
+    };
+    auto coordinate_uptr = std::make_unique<Coordinate>(coords);
+    auto integrator_uptr = std::make_unique<Integrator>(*coordinate_uptr);
+    return Cell(std::move(coordinate_uptr), std::move(integrator_uptr), id);
+  };
+  // the face on `x = x`, whose normal vector is `(1, 0, 0)`
+  auto build_face = [](double x, Cell *holder, Cell *sharer, cgsize_t id) {
+    auto coords = {
+        Coord{x, -1, -1}, Coord{x, +1, -1}, Coord{x, +1, +1}, Coord{x, -1, +1},
+    };
+    auto coordinate_uptr = std::make_unique<FaceCoordinate>(coords);
+    auto integrator_uptr = std::make_unique<FaceIntegrator>(*coordinate_uptr);
+    return Face(std::move(coordinate_uptr), std::move(integrator_uptr),
+        holder, sharer, id);
+  };
+  // three cells in a row, the fluid flows along +x
+  auto left = build_cell(-3, 0), middle = build_cell(-1, 1),
+      right = build_cell(+1, 2);
+  auto left_face = build_face(-1, &left, &middle, 0);
+  auto right_face = build_face(+1, &middle, &right, 1);
+  EXPECT_NEAR(right_face.integrator().GetNormalFrame(0)[0][0], 1.0, 1e-15);
+  left.adj_faces_ = { &left_face };
+  middle.adj_faces_ = { &left_face, &right_face };
+  right.adj_faces_ = { &right_face };
+  auto get_conservative = [](double rho, double u, double p) {
+    return Value(rho, rho * u, 0, 0, p / 0.4 + rho * u * u / 2);
+  };
+  auto smooth = [&](Coord const &xyz) {
+    return get_conservative(1 + 0.1 * xyz[0] + 0.01 * xyz[1] * xyz[2],
+        1.0, 1.0);
+  };
+  auto shocked = [&](Coord const &xyz) {
+    return xyz[0] < 1 ? get_conservative(1.0, 1.0, 1.0)
+        : get_conservative(4.0, 1.0, 10.0);
+  };
+  auto detector = mini::limiter::detector::Krivodonova<Cell>(0.5);
+  // a smooth field is not troubled
+  left.Approximate(smooth);
+  middle.Approximate(smooth);
+  right.Approximate(smooth);
+  EXPECT_FALSE(detector.IsNotSmooth(left));
+  EXPECT_FALSE(detector.IsNotSmooth(middle));
+  EXPECT_FALSE(detector.IsNotSmooth(right));
+  // a shock on `x = 1` only troubles the cell downstream,
+  // although the jump on the outflow face of the upstream cell is larger
+  left.Approximate(shocked);
+  middle.Approximate(shocked);
+  right.Approximate(shocked);
+  EXPECT_FALSE(detector.IsNotSmooth(middle));
+  EXPECT_TRUE(detector.IsNotSmooth(right));
+  // a fluid at rest is checked on all faces
+  auto resting = [&](Coord const &xyz) {
+    return xyz[0] < 1 ? get_conservative(1.0, 0.0, 1.0)
+        : get_conservative(4.0, 0.0, 10.0);
+  };
+  middle.Approximate(resting);
+  right.Approximate(resting);
+  EXPECT_TRUE(detector.IsNotSmooth(middle));
+}
+TEST_F(TestWenoLimiters, Operators) {
+  using Projection = mini::polynomial::Projection<double, 3, 2, 2>;
+  using Cell = mini::mesh::part::Cell<cgsize_t, Projection>;
+  using Value = typename Cell::Value;
+  auto build_cell = [](double x_min, cgsize_t id) {
+    auto coords = {
+        Coord{x_min + 0, -1, -1}, Coord{x_min + 2, -1, -1},
+        Coord{x_min + 2, +1, -1}, Coord{x_min + 0, +1, -1},
+        Coord{x_min + 0, -1, +1}, Coord{x_min + 2, -1, +1},
+        Coord{x_min + 2, +1, +1}, Coord{x_min + 0, +1, +1},
+    };
+    auto coordinate_uptr = std::make_unique<Coordinate>(coords);
+    auto integrator_uptr = std::make_unique<Integrator>(*coordinate_uptr);
+    return Cell(std::move(coordinate_uptr), std::move(integrator_uptr), id);
+  };
+  auto my_cell = build_cell(-1, 0);
+  auto adj_cell = build_cell(+1, 1);
+  my_cell.adj_cells_.push_back(&adj_cell);
+  auto func = [](Coord const &xyz) {
+    return Value(std::sin(xyz[0]) + xyz[1] * xyz[2], std::exp(xyz[0] / 4));
+  };
+  my_cell.Approximate(func);
+  adj_cell.Approximate(func);
+  auto operators = mini::limiter::weno::Operators<Cell>();
+  auto const &entry = operators(my_cell);
+  EXPECT_EQ(&entry, &operators(my_cell));  // built only once
+  EXPECT_EQ(entry.borrowings.size(), 1);
+  // borrowing by the cached operator == re-projecting by integration
+  auto const &my_projection = my_cell.polynomial().projection();
+  using ProjectionWrapper = typename Projection::Wrapper;
+  auto expected = ProjectionWrapper(my_projection.basis());
+  expected.Approximate([&adj_cell](Coord const &xyz) {
+    return adj_cell.GlobalToValue(xyz);
+  });
+  auto actual = entry.Borrow(0, adj_cell.polynomial().coeff());
+  EXPECT_NEAR((actual - expected.coeff()).norm(), 0.0, 1e-14);
+  // smoothness by the quadratic form == smoothness by integration
+  auto s_expected = mini::limiter::weno::GetSmoothness(my_projection);
+  auto s_actual = entry.GetSmoothness(my_projection.coeff());
+  EXPECT_NEAR((s_actual - s_expected).norm(), 0.0, 1e-13);
+  EXPECT_NEAR(s_actual[1], s_expected[1], 1e-14);
+}
 TEST_F(TestWenoLimiters, ReconstructScalar) {
   auto case_name = std::string("simple_cube");
   // build mesh files
@@ -0,0 +1,65 @@
+// Copyright 2024 PEI Weicheng
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "mpi.h"
+#include "gtest/gtest.h"
+
+#include "mini/mesh/async_writer.hpp"
+
+class TestMeshAsyncWriter : public ::testing::Test {
+ protected:
+  using AsyncWriter = mini::mesh::AsyncWriter;
+};
+TEST_F(TestMeshAsyncWriter, RunInOrder) {
+  auto writer = AsyncWriter(MPI_COMM_WORLD);
+  auto done = std::vector<int>();
+  for (int i = 0; i < 5; ++i) {
+    writer.Push([i, &done, &writer](MPI_Comm comm) {
+      int result;
+      MPI_Comm_compare(comm, MPI_COMM_WORLD, &result);
+      EXPECT_EQ(result, writer.async() ? MPI_CONGRUENT : MPI_IDENT);
+      MPI_Barrier(comm);  // collective calls on the duplicate
+      done.emplace_back(i);
+    });
+  }
+  writer.Flush();
+  EXPECT_EQ(done, (std::vector<int>{ 0, 1, 2, 3, 4 }));
+}
+TEST_F(TestMeshAsyncWriter, FlushAll) {
+  bool done = false;
+  auto writer = AsyncWriter(MPI_COMM_WORLD);
+  writer.Push([&done](MPI_Comm) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    done = true;
+  });
+  AsyncWriter::FlushAll();
+  EXPECT_TRUE(done);
+}
+TEST_F(TestMeshAsyncWriter, RethrowOnFlush) {
+  auto writer = AsyncWriter(MPI_COMM_WORLD);
+  writer.Push([](MPI_Comm) { throw std::runtime_error("task failed"); });
+  EXPECT_THROW(writer.Flush(), std::runtime_error);
+  // the error is rethrown only once
+  writer.Push([](MPI_Comm) {});
+  EXPECT_NO_THROW(writer.Flush());
+}
+TEST_F(TestMeshAsyncWriter, RethrowOnDestruction) {
+  auto run = []() {
+    auto writer = AsyncWriter(MPI_COMM_WORLD);
+    writer.Push([](MPI_Comm) { throw std::runtime_error("task failed"); });
+  };
+  EXPECT_THROW(run(), std::runtime_error);
+}
+
+// mpirun -n 4 ./async_writer
+int main(int argc, char* argv[]) {
+  int thread_level;
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &thread_level);
+  ::testing::InitGoogleTest(&argc, argv);
+  auto exit_code = RUN_ALL_TESTS();
+  MPI_Finalize();
+  return exit_code;
+}
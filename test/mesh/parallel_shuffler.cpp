@@ -0,0 +1,170 @@
+// Copyright 2024 PEI Weicheng
+#include <cstdio>
+#include <cstdlib>
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mpi.h"
+#include "pcgnslib.h"
+#include "gtest/gtest.h"
+
+#include "mini/mesh/shuffler.hpp"
+#include "mini/mesh/parallel_shuffler.hpp"
+#include "mini/mesh/part.hpp"
+#include "mini/polynomial/projection.hpp"
+#include "mini/input/path.hpp"  // defines INPUT_DIR
+
+#include "test/mesh/part.hpp"
+
+class TestMeshParallelShuffler : public ::testing::Test {
+ protected:
+  using Projection = mini::polynomial::Projection<
+      Scalar, kDimensions, kDegrees, kComponents>;
+  using Part = mini::mesh::part::Part<cgsize_t, Projection>;
+
+  /**
+   * @brief Get the global numbers of cells and boundary faces and the global sums of their volumes and areas.
+   */
+  static std::array<Scalar, 4> Summarize(std::string const &case_name) {
+    auto part = Part(case_name, i_core, n_core);
+    InstallIntegratorPrototypes(&part);
+    std::array<Scalar, 4> local{ 0, 0, 0, 0 }, global;
+    for (const auto &cell : part.GetLocalCells()) {
+      local[0] += 1;
+      local[2] += cell.volume();
+    }
+    for (const auto &face : part.GetBoundaryFaces()) {
+      local[1] += 1;
+      local[3] += face.area();
+    }
+    MPI_Allreduce(local.data(), global.data(), 4, MPI_DOUBLE, MPI_SUM,
+        MPI_COMM_WORLD);
+    return global;
+  }
+
+  // [metis id] -> { center, sorted metis ids of adjacent cells }
+  using Graph = std::map<cgsize_t, std::pair<Coord, std::vector<cgsize_t>>>;
+
+  /**
+   * @brief Check the ghost cells on this rank, then get the global dual graph labeled by metis ids.
+   */
+  static Graph CheckGhostsAndGetGraph(std::string const &case_name) {
+    auto part = Part(case_name, i_core, n_core);
+    InstallIntegratorPrototypes(&part);
+    constexpr int kMaxAdj = 6;
+    // each row is [metis id, adjacent metis ids..., -1...]
+    auto local_rows = std::vector<cgsize_t>();
+    auto local_centers = std::vector<Scalar>();
+    auto expected_ghosts = std::set<cgsize_t>();
+    for (const auto &cell : part.GetLocalCells()) {
+      local_rows.emplace_back(cell.metis_id);
+      EXPECT_LE(cell.adj_cells_.size(), kMaxAdj);
+      for (int k = 0; k < kMaxAdj; ++k) {
+        if (k < cell.adj_cells_.size()) {
+          auto const *adj = cell.adj_cells_[k];
+          local_rows.emplace_back(adj->metis_id);
+          if (part.IsGhost(adj->id())) {
+            expected_ghosts.emplace(adj->metis_id);
+          }
+        } else {
+          local_rows.emplace_back(-1);
+        }
+      }
+      auto center = cell.center();
+      local_centers.insert(local_centers.end(), center.begin(), center.end());
+    }
+    // each ghost cell is adjacent to some local cell and owned by another rank
+    auto actual_ghosts = std::set<cgsize_t>();
+    for (const auto &cell : part.GetGhostCells()) {
+      actual_ghosts.emplace(cell.metis_id);
+    }
+    EXPECT_EQ(actual_ghosts, expected_ghosts);
+    EXPECT_EQ(actual_ghosts.size(), part.CountGhostCells());
+    // gather all rows
+    int n_local = part.CountLocalCells();
+    auto counts = std::vector<int>(n_core), displs = std::vector<int>(n_core);
+    MPI_Allgather(&n_local, 1, MPI_INT, counts.data(), 1, MPI_INT,
+        MPI_COMM_WORLD);
+    int n_global = 0;
+    for (int r = 0; r < n_core; ++r) {
+      displs[r] = n_global;
+      n_global += counts[r];
+    }
+    auto gather = [&](auto const &local, int n_columns, MPI_Datatype type) {
+      using T = typename std::decay_t<decltype(local)>::value_type;
+      auto global = std::vector<T>(n_global * n_columns);
+      auto column_counts = counts, column_displs = displs;
+      for (int r = 0; r < n_core; ++r) {
+        column_counts[r] *= n_columns;
+        column_displs[r] *= n_columns;
+      }
+      MPI_Allgatherv(local.data(), local.size(), type, global.data(),
+          column_counts.data(), column_displs.data(), type, MPI_COMM_WORLD);
+      return global;
+    };
+    auto int_type = sizeof(cgsize_t) == 8 ? MPI_LONG : MPI_INT;
+    auto rows = gather(local_rows, 1 + kMaxAdj, int_type);
+    auto centers = gather(local_centers, kDimensions, MPI_DOUBLE);
+    auto graph = Graph();
+    for (int i = 0; i < n_global; ++i) {
+      auto const *row = &rows[i * (1 + kMaxAdj)];
+      auto &[center, adj] = graph[row[0]];
+      center = Coord(&centers[i * kDimensions]);
+      for (int k = 1; k <= kMaxAdj && row[k] >= 0; ++k) {
+        adj.emplace_back(row[k]);
+      }
+      std::ranges::sort(adj);
+    }
+    EXPECT_EQ(graph.size(), n_global);
+    // each ghost cell is a copy of the local cell of the same metis id
+    for (const auto &cell : part.GetGhostCells()) {
+      auto const &[center, _] = graph.at(cell.metis_id);
+      EXPECT_NEAR((cell.center() - center).norm(), 0, 1e-12);
+    }
+    return graph;
+  }
+};
+TEST_F(TestMeshParallelShuffler, PartitionAndShuffle) {
+  auto old_file_name = std::string("double_mach.cgns");
+  if (i_core == 0) {
+    char cmd[1024];
+    std::snprintf(cmd, sizeof(cmd), "gmsh %s/double_mach.geo -save -o %s",
+        INPUT_DIR, old_file_name.c_str());
+    if (std::system(cmd))
+      throw std::runtime_error(cmd + std::string(" failed."));
+    // the serial version as a reference
+    using Shuffler = mini::mesh::Shuffler<idx_t, Scalar>;
+    Shuffler::PartitionAndShuffle("serial", old_file_name, n_core);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  using ParallelShuffler = mini::mesh::ParallelShuffler<idx_t, Scalar>;
+  ParallelShuffler::PartitionAndShuffle("parallel", old_file_name,
+      MPI_COMM_WORLD);
+  auto expected = Summarize("serial");
+  auto actual = Summarize("parallel");
+  EXPECT_EQ(actual[0], expected[0]);
+  EXPECT_EQ(actual[1], expected[1]);
+  EXPECT_NEAR(actual[2], expected[2], 1e-10);
+  EXPECT_NEAR(actual[3], expected[3], 1e-10);
+  // the dual graphs are identical, although the partitions might differ
+  auto expected_graph = CheckGhostsAndGetGraph("serial");
+  auto actual_graph = CheckGhostsAndGetGraph("parallel");
+  EXPECT_EQ(actual_graph.size(), expected_graph.size());
+  for (auto &[m_cell, expected_cell] : expected_graph) {
+    auto const &actual_cell = actual_graph.at(m_cell);
+    EXPECT_NEAR((actual_cell.first - expected_cell.first).norm(), 0, 1e-12);
+    EXPECT_EQ(actual_cell.second, expected_cell.second);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  return Main(argc, argv);
+}
@@ -5,12 +5,14 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include "mpi.h"
 #include "pcgnslib.h"
 
 #include "mini/mesh/cgns.hpp"
 #include "mini/mesh/part.hpp"
+#include "mini/mesh/shuffler.hpp"
 #include "mini/limiter/weno.hpp"
 #include "mini/limiter/reconstruct.hpp"
 #include "mini/polynomial/projection.hpp"
@@ -20,8 +22,48 @@
 
 #include "test/mesh/part.hpp"
 
+/**
+ * @brief Read the coordinates of local nodes from a file written after `Part::WriteGrid`, which are got through its links to the grid file.
+ */
 template <class Part>
-void Process(Part *part_ptr, const std::string &solution_name) {
+void CheckLinkedGrid(Part const &part, std::string const &soln_name) {
+  auto cgns_file = part.GetDirectoryName() + "/" + soln_name + ".cgns";
+  int i_file, i_base = 1, n_zones;
+  if (cgp_open(cgns_file.c_str(), CG_MODE_READ, &i_file)
+      || cg_nzones(i_file, i_base, &n_zones)) {
+    cgp_error_exit();
+  }
+  for (int i_zone = 1; i_zone <= n_zones; ++i_zone) {
+    auto &nodes = part.GetLocalNodes(i_zone);
+    cgsize_t range_min[] = { nodes.head() };
+    cgsize_t range_max[] = { nodes.tail() - 1 };
+    auto x = std::vector<Scalar>(nodes.size());
+    auto y = x, z = x;
+    if (cgp_coord_read_data(i_file, i_base, i_zone, 1,
+        range_min, range_max, x.data()) ||
+        cgp_coord_read_data(i_file, i_base, i_zone, 2,
+        range_min, range_max, y.data()) ||
+        cgp_coord_read_data(i_file, i_base, i_zone, 3,
+        range_min, range_max, z.data())) {
+      cgp_error_exit();
+    }
+    for (int i = 0; i < nodes.size(); ++i) {
+      auto i_node = nodes.head() + i;
+      if (x[i] != nodes.x_[i_node] || y[i] != nodes.y_[i_node]
+          || z[i] != nodes.z_[i_node]) {
+        throw std::runtime_error("Node " + std::to_string(i_node)
+            + " in " + cgns_file + " does not match the grid.");
+      }
+    }
+  }
+  if (cgp_close(i_file)) {
+    cgp_error_exit();
+  }
+}
+
+template <class Part>
+void Process(Part *part_ptr, const std::string &solution_name,
+    bool link_grid = false) {
   InstallIntegratorPrototypes(part_ptr);
   part_ptr->SetFieldNames({"U1", "U2"});
   double volume = 0.0, area = 0.0;
@@ -56,7 +98,13 @@ void Process(Part *part_ptr, const std::string &solution_name) {
   std::printf("Run Write() on proc[%d/%d] at %f sec\n",
       i_core, n_core, MPI_Wtime() - time_begin);
   part_ptr->GatherSolutions();
+  if (link_grid) {
+    part_ptr->WriteGrid();
+  }
   part_ptr->WriteSolutions(solution_name);
+  if (link_grid) {
+    CheckLinkedGrid(*part_ptr, solution_name);
+  }
 }
 
 // mpirun -n 4 ./part [<case_name> [<input_dir>]]]
@@ -105,7 +153,41 @@ int main(int argc, char* argv[]) {
   using Extrapolation = mini::polynomial::Extrapolation<Interpolation>;
   using Part = mini::mesh::part::Part<cgsize_t, Extrapolation>;
   auto part = Part(case_name, i_core, n_core);
-  Process(&part, "Interpolation");
+  Process(&part, "Interpolation", /* link_grid = */true);
+}
+  /* run on a strict subset of ranks, if there are more than one rank */
+{
+  int n_sub_core = (n_core + 1) / 2;
+  auto sub_case_name = case_name + "_split";
+  std::printf("Run Part() on proc[%d/%d] at %f sec on %d ranks\n",
+      i_core, n_core, MPI_Wtime() - time_begin, n_sub_core);
+  if (i_core == 0) {
+    using Shuffler = mini::mesh::Shuffler<idx_t, Scalar>;
+    Shuffler::PartitionAndShuffle(sub_case_name,
+        case_name + "/original.cgns", n_sub_core);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  MPI_Comm comm;
+  MPI_Comm_split(MPI_COMM_WORLD, i_core < n_sub_core ? 0 : MPI_UNDEFINED,
+      i_core, &comm);
+  if (comm != MPI_COMM_NULL) {
+    int i_sub_core, n_comm_core;
+    MPI_Comm_rank(comm, &i_sub_core);
+    MPI_Comm_size(comm, &n_comm_core);
+    assert(n_comm_core == n_sub_core && i_sub_core == i_core);
+    cgp_mpi_comm(comm);
+    {
+      using Interpolation = mini::polynomial::Hexahedron<Gx, Gx, Gx, kComponents, false>;
+      using Extrapolation = mini::polynomial::Extrapolation<Interpolation>;
+      using Part = mini::mesh::part::Part<cgsize_t, Extrapolation>;
+      auto part = Part(sub_case_name, i_sub_core, n_sub_core, comm);
+      assert(part.mpi_comm() == comm);
+      Process(&part, "Interpolation", /* link_grid = */true);
+    }
+    cgp_mpi_comm(MPI_COMM_WORLD);
+    MPI_Comm_free(&comm);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
 }
   std::printf("Run MPI_Finalize() on proc[%d/%d] at %f sec\n",
       i_core, n_core, MPI_Wtime() - time_begin);
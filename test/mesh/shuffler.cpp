@@ -1,9 +1,11 @@
 // Copyright 2019 PEI Weicheng and YANG Minghao
 
 #include <cassert>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -15,6 +17,7 @@
 
 #include "mini/mesh/mapper.hpp"
 #include "mini/mesh/shuffler.hpp"
+#include "mini/mesh/partition.hpp"
 #include "mini/mesh/cgns.hpp"
 #include "mini/mesh/metis.hpp"
 #include "mini/input/path.hpp"  // defines INPUT_DIR
@@ -63,6 +66,60 @@ TEST_F(TestMeshShuffler, ShuffleConnectivity) {
     EXPECT_EQ(i_node_list[i], expected_new_i_node_list[i]);
   }
 }
+TEST_F(TestMeshShuffler, PartitionInfo) {
+  using mini::mesh::partition::Info;
+  using mini::mesh::partition::Table;
+  auto info = Info();
+  info.Append(Table::kNodeRanges, { 1, 1, 10 });
+  info.Append(Table::kInnerAdjacency, { 0, 1 });
+  info.Append(Table::kInnerAdjacency, { 0, 2 });
+  info.Append(Table::kInterpartAdjacency, { 1, 2, 3, 8, 8 });
+  auto file_name = std::string("partition_info.bin");
+  info.Write(file_name);
+  auto read = Info::Read(file_name);
+  EXPECT_EQ(read.CountRows(Table::kNodeRanges), 1);
+  EXPECT_EQ(read.CountRows(Table::kSendNodes), 0);
+  EXPECT_EQ(read.CountRows(Table::kInnerAdjacency), 2);
+  EXPECT_EQ(read.CountRows(Table::kInterpartAdjacency), 1);
+  EXPECT_EQ(read.GetRow(Table::kNodeRanges, 0)[2], 10);
+  EXPECT_EQ(read.GetRow(Table::kInnerAdjacency, 1)[1], 2);
+  EXPECT_EQ(read.GetRow(Table::kInterpartAdjacency, 0)[4], 8);
+  // a text file is rejected
+  std::ofstream("partition_info.txt") << "# i_zone i_node_head i_node_tail\n";
+  EXPECT_THROW(Info::Read("partition_info.txt"), std::runtime_error);
+  // a table of wrong columns is rejected
+  {
+    auto file = std::fstream(file_name,
+        std::ios::binary | std::ios::in | std::ios::out);
+    // skip the magic, the version and the number of tables
+    file.seekp(sizeof(mini::mesh::partition::kMagic) + 2 * sizeof(int64_t));
+    int64_t n_columns = 4;
+    file.write(reinterpret_cast<char const *>(&n_columns), sizeof(n_columns));
+  }
+  EXPECT_THROW(Info::Read(file_name), std::runtime_error);
+  // a wrong number of tables is rejected, but not as a wrong version
+  info.Write(file_name);
+  {
+    auto file = std::fstream(file_name,
+        std::ios::binary | std::ios::in | std::ios::out);
+    // skip the magic and the version
+    file.seekp(sizeof(mini::mesh::partition::kMagic) + sizeof(int64_t));
+    int64_t n_tables = mini::mesh::partition::kTables + 1;
+    file.write(reinterpret_cast<char const *>(&n_tables), sizeof(n_tables));
+  }
+  try {
+    Info::Read(file_name);
+    ADD_FAILURE() << "a wrong number of tables is not rejected";
+  } catch (std::runtime_error const &e) {
+    EXPECT_NE(std::string(e.what()).find("tables"), std::string::npos);
+    EXPECT_EQ(std::string(e.what()).find("version"), std::string::npos);
+  }
+  // a truncated file is rejected
+  info.Write(file_name);
+  std::filesystem::resize_file(file_name,
+      std::filesystem::file_size(file_name) - 1);
+  EXPECT_THROW(Info::Read(file_name), std::runtime_error);
+}
 TEST_F(TestMeshShuffler, ParitionAndShuffle) {
   char cmd[1024];
   std::snprintf(cmd, sizeof(cmd), "mkdir -p %s/partition", case_name);
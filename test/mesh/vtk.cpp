@@ -1,4 +1,6 @@
 // Copyright 2024 PEI Weicheng
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -106,14 +108,81 @@ TEST_F(TestMeshVtk, DecodeBase64) {
   DecodeBase64("MTIzNDU2", decoded.size(), decoded.data());
   EXPECT_EQ(origin, decoded);
 }
+TEST_F(TestMeshVtk, AppendRaw) {
+  using mini::mesh::vtk::AppendRaw;
+  auto origin = std::vector<double>{ 1.0, 2.0, 3.0 };
+  auto appended = std::string("_");
+  auto n_byte = sizeof(double) * origin.size();
+  AppendRaw(reinterpret_cast<char const *>(origin.data()), n_byte, &appended);
+  EXPECT_EQ(appended.size(), 1 + sizeof(uint64_t) + n_byte);
+  uint64_t header;
+  std::memcpy(&header, appended.data() + 1, sizeof(header));
+  EXPECT_EQ(header, n_byte);
+  auto decoded = std::vector<double>(origin.size());
+  std::memcpy(decoded.data(), appended.data() + 1 + sizeof(header), n_byte);
+  EXPECT_EQ(origin, decoded);
+}
+#ifdef ENABLE_ZLIB
+TEST_F(TestMeshVtk, AppendZlib) {
+  using mini::mesh::vtk::AppendZlib;
+  using mini::mesh::vtk::kBlockSize;
+  // 2.5 blocks in total
+  auto origin = std::vector<int32_t>(kBlockSize * 5 / 2 / sizeof(int32_t));
+  for (int i = 0; i < origin.size(); ++i) {
+    origin[i] = i % 7;
+  }
+  auto n_byte = sizeof(int32_t) * origin.size();
+  auto appended = std::string();
+  AppendZlib(reinterpret_cast<char const *>(origin.data()), n_byte, &appended);
+  auto *header = reinterpret_cast<uint64_t const *>(appended.data());
+  EXPECT_EQ(header[0], 3);
+  EXPECT_EQ(header[1], kBlockSize);
+  EXPECT_EQ(header[2], kBlockSize / 2);
+  auto decoded = std::vector<int32_t>(origin.size());
+  auto *output = reinterpret_cast<Bytef *>(decoded.data());
+  auto *input = reinterpret_cast<Bytef const *>(header + 3 + header[0]);
+  for (int i_block = 0; i_block < header[0]; ++i_block) {
+    uLongf n_byte_out = (i_block + 1 < header[0]) ? header[1] : header[2];
+    EXPECT_EQ(uncompress(output, &n_byte_out, input, header[3 + i_block]),
+        Z_OK);
+    output += n_byte_out;
+    input += header[3 + i_block];
+  }
+  EXPECT_EQ(origin, decoded);
+}
+#endif
+
+TEST_F(TestMeshVtk, MergeNodes) {
+  using mini::mesh::vtk::MergeNodes;
+  double tolerance = 1e-3;
+  // nodes [0, 2] are close but on both sides of the bin boundary at x = 0
+  // nodes [1, 3] are close and in the same bin
+  auto coords = std::vector<Coord>{ Coord(-1e-4, 0.5, 0.5),
+      Coord(1.0, 0.5, 0.5), Coord(+1e-4, 0.5, 0.5), Coord(1.0, 0.5, 0.5),
+      Coord(2.0, 0.5, 0.5) };
+  auto values = std::vector<Value>{ Value(1, 2), Value(3, 4), Value(5, 6),
+      Value(7, 8), Value(9, 10) };
+  auto point_data = std::vector<std::vector<Scalar>>{ { 1, 2, 3, 4, 5 } };
+  auto connectivity = std::vector<int32_t>{ 0, 1, 2, 3, 4 };
+  MergeNodes(tolerance, &coords, &values, &point_data, &connectivity);
+  EXPECT_EQ(coords.size(), 3u);
+  EXPECT_EQ(connectivity, (std::vector<int32_t>{ 0, 1, 0, 1, 2 }));
+  EXPECT_EQ(values[0], Value(3, 4));
+  EXPECT_EQ(values[1], Value(5, 6));
+  EXPECT_EQ(values[2], Value(9, 10));
+  EXPECT_EQ(point_data[0], (std::vector<Scalar>{ 2, 3, 5 }));
+  // nodes farther than the tolerance are kept
+  coords = { Coord(0, 0, 0), Coord(0, 0, 2 * tolerance) };
+  values = { Value(1, 2), Value(3, 4) };
+  point_data = { { 1, 2 } };
+  connectivity = { 0, 1 };
+  MergeNodes(tolerance, &coords, &values, &point_data, &connectivity);
+  EXPECT_EQ(coords.size(), 2u);
+  EXPECT_EQ(connectivity, (std::vector<int32_t>{ 0, 1 }));
+}
 
 template <class Part>
-void Write(std::string const &case_name, std::string const &solution_name) {
-  auto part = Part(case_name, i_core, n_core);
-  InstallIntegratorPrototypes(&part);
-  part.SetFieldNames({"U1", "U2"});
-  part.ReadSolutions(solution_name);
-  part.ScatterSolutions();
+void AddExtraData() {
   using VtkWriter = mini::mesh::vtk::Writer<Part>;
   using Cell = typename Part::Cell;
   auto plus = [](Cell const &cell) -> Scalar {
@@ -125,7 +194,17 @@ void Write(std::string const &case_name, std::string const &solution_name) {
     return value[0] - value[1];
   };
   VtkWriter::AddPointData("U1-U2", minus);
-  VtkWriter::WriteSolutions(part, solution_name);
+}
+
+template <class Part>
+void Write(std::string const &case_name, std::string const &solution_name,
+    std::string const &output_name, mini::mesh::AsyncWriter *writer = nullptr) {
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  part.SetFieldNames({"U1", "U2"});
+  part.ReadSolutions(solution_name);
+  part.ScatterSolutions();
+  mini::mesh::vtk::Writer<Part>::WriteSolutions(part, output_name, writer);
 }
 
 TEST_F(TestMeshVtk, Writer) {
@@ -137,7 +216,8 @@ TEST_F(TestMeshVtk, Writer) {
   using Projection = mini::polynomial::Projection<
       Scalar, kDimensions, kDegrees, kComponents>;
   using Part = mini::mesh::part::Part<cgsize_t, Projection>;
-  Write<Part>("double_mach", solution_name);
+  AddExtraData<Part>();
+  Write<Part>("double_mach", solution_name, solution_name);
 }
   /* aproximated by Interpolation on Lagrange basis */
 {
@@ -147,7 +227,24 @@ TEST_F(TestMeshVtk, Writer) {
   using Interpolation = mini::polynomial::Hexahedron<Gx, Gx, Gx, kComponents, false>;
   using Extrapolation = mini::polynomial::Extrapolation<Interpolation>;
   using Part = mini::mesh::part::Part<cgsize_t, Extrapolation>;
-  Write<Part>("double_mach", solution_name);
+  using VtkWriter = mini::mesh::vtk::Writer<Part>;
+  AddExtraData<Part>();
+  // ascii, unmerged
+  VtkWriter::SetEncoding(mini::mesh::vtk::Encoding::kAscii);
+  Write<Part>("double_mach", solution_name, solution_name);
+  // binary, merged, in the background
+#ifdef ENABLE_ZLIB
+  VtkWriter::SetEncoding(mini::mesh::vtk::Encoding::kZlib);
+#else
+  VtkWriter::SetEncoding(mini::mesh::vtk::Encoding::kRaw);
+#endif
+  VtkWriter::SetPrecision("U1-U2", mini::mesh::vtk::Precision::kFloat32);
+  VtkWriter::SetMergeTolerance(1e-8);
+  auto writer = mini::mesh::AsyncWriter(MPI_COMM_WORLD);
+  Write<Part>("double_mach", solution_name, "InterpolationMerged", &writer);
+  writer.Flush();
+  VtkWriter::SetEncoding(mini::mesh::vtk::Encoding::kAscii);
+  VtkWriter::SetMergeTolerance(0);
 }
 }
 
@@ -14,6 +14,8 @@
 #include "mini/basis/linear.hpp"
 #include "mini/polynomial/projection.hpp"
 #include "mini/polynomial/hexahedron.hpp"
+#include "mini/polynomial/concept.hpp"
+#include "mini/polynomial/transfer.hpp"
 #include "mini/constant/index.hpp"
 #include "mini/algebra/eigen.hpp"
 #include "mini/rand.hpp"
@@ -205,6 +207,12 @@ class TestPolynomialHexahedronInterpolation : public TestPolynomialHexahedron {
 
   template <bool kLocal>
   static void CheckCollinearPoints();
+
+  template <bool kLocal>
+  static void CheckFluxDivergence();
+
+  template <bool kLocal>
+  static void CheckTransfer();
 };
 
 template <bool kLocal>
@@ -368,6 +376,50 @@ TEST_F(TestPolynomialHexahedronInterpolation, Derivatives) {
   CheckDerivatives<false>();
 }
 
+template <bool kLocal>
+void TestPolynomialHexahedronInterpolation::CheckFluxDivergence() {
+  using Interpolation = mini::polynomial::Hexahedron<
+      IntegratorX, IntegratorY, IntegratorZ, kComponents, kLocal>;
+  static_assert(mini::polynomial::TensorProduct<Interpolation>);
+  constexpr int N = Interpolation::N;
+  constexpr int K = Interpolation::K;
+  using FluxMatrix = mini::algebra::Matrix<Scalar, K, 3>;
+  std::array<FluxMatrix, N> local_fluxes;
+  for (auto &flux : local_fluxes) {
+    flux = FluxMatrix::Random();
+  }
+  // build a trivial interpolation to access the static members
+  auto interp = Interpolation();
+  // check MinusFluxDivergence() against the dense O(N^2) operator
+  mini::algebra::Vector<Scalar, N * K> expect, actual;
+  expect.setZero();
+  actual.setZero();
+  for (int q = 0; q < N; ++q) {
+    auto const &grad = interp.GetBasisLocalGradients(q);
+    Value value = Value::Zero();
+    for (int k = 0; k < N; ++k) {
+      value += local_fluxes[k] * grad.col(k);
+    }
+    Interpolation::MinusValue(value, expect.data(), q);
+  }
+  Interpolation::MinusFluxDivergence(local_fluxes, actual.data());
+  EXPECT_NEAR((expect - actual).norm(), 0.0, 1e-12 * expect.norm());
+  // check AddFluxDotBasisGradients() against the dense O(N^2) operator
+  expect.setZero();
+  actual.setZero();
+  for (int q = 0; q < N; ++q) {
+    auto const &grad = interp.GetBasisLocalGradients(q);
+    typename Interpolation::Coeff prod = local_fluxes[q] * grad;
+    Interpolation::AddToResidual(prod, expect.data());
+  }
+  Interpolation::AddFluxDotBasisGradients(local_fluxes, actual.data());
+  EXPECT_NEAR((expect - actual).norm(), 0.0, 1e-12 * expect.norm());
+}
+TEST_F(TestPolynomialHexahedronInterpolation, FluxDivergence) {
+  CheckFluxDivergence<true>();
+  CheckFluxDivergence<false>();
+}
+
 template <bool kLocal>
 void TestPolynomialHexahedronInterpolation::CheckCollinearPoints() {
   using Interpolation = mini::polynomial::Hexahedron<
@@ -510,6 +562,69 @@ TEST_F(TestPolynomialHexahedronInterpolation, CollinearPoints) {
   CheckCollinearPoints<false>();
 }
 
+template <bool kLocal>
+void TestPolynomialHexahedronInterpolation::CheckTransfer() {
+  using Fine = mini::polynomial::Hexahedron<
+      IntegratorX, IntegratorY, IntegratorZ, kComponents, kLocal>;
+  using Coarse = mini::polynomial::Hexahedron<
+      mini::integrator::Legendre<Scalar, 2>, mini::integrator::Lobatto<Scalar, 2>,
+      mini::integrator::Legendre<Scalar, 1>, kComponents, kLocal>;
+  using Modal = mini::polynomial::Projection<Scalar, 3, 2, kComponents>;
+  static_assert(Coarse::P < Fine::P);
+  auto a = 2.0, b = 3.0, c = 4.0;
+  auto coordinate = Coordinate {
+    Global(-a, -b, -c), Global(+a, -b, -c),
+    Global(+a, +b, -c), Global(-a, +b, -c),
+    Global(-a, -b, +c), Global(+a, -b, +c),
+    Global(+a, +b, +c), Global(-a, +b, +c),
+  };
+  auto fine_integrator = typename Fine::Integrator(coordinate);
+  auto coarse_integrator = typename Coarse::Integrator(coordinate);
+  auto fine = Fine(fine_integrator);
+  auto coarse = Coarse(coarse_integrator);
+  coeff_ = Value::Random();
+  // restriction is the interpolation on coarse nodes
+  fine.Approximate(GetExactValue);
+  mini::polynomial::Transfer(fine, &coarse);
+  auto coarse_exact = Coarse(coarse_integrator);
+  coarse_exact.Approximate(GetExactValue);
+  EXPECT_NEAR((coarse.coeff() - coarse_exact.coeff()).norm(), 0, 1e-13);
+  // prolongation is exact, since the coarse space is a subspace of the fine one
+  mini::polynomial::Transfer(coarse, &fine);
+  for (int i_trial = 0; i_trial < kTrials; ++i_trial) {
+    auto global = Global{ rand_f(-a, a), rand_f(-b, b), rand_f(-c, c) };
+    auto value = coarse.GlobalToValue(global);
+    value -= fine.GlobalToValue(global);
+    EXPECT_NEAR(value.norm(), 0, 1e-12);
+  }
+  // transfer between nodal and modal bases
+  fine.Approximate(GetExactValue);
+  using ModalIntegrator = mini::integrator::Hexahedron<
+      mini::integrator::Legendre<Scalar, 4>,
+      mini::integrator::Legendre<Scalar, 4>,
+      mini::integrator::Legendre<Scalar, 4>>;
+  auto modal_integrator = ModalIntegrator(coordinate);
+  auto modal = Modal(modal_integrator);
+  mini::polynomial::Transfer(fine, &modal);
+  // restriction to degree 0 keeps the average
+  auto constant = mini::polynomial::Projection<Scalar, 3, 0, kComponents>(
+      modal_integrator);
+  mini::polynomial::Transfer(modal, &constant);
+  EXPECT_NEAR((constant.average() - modal.average()).norm(), 0, 1e-13);
+  fine.SetZero();
+  mini::polynomial::Transfer(modal, &fine);
+  for (int i_trial = 0; i_trial < kTrials; ++i_trial) {
+    auto global = Global{ rand_f(-a, a), rand_f(-b, b), rand_f(-c, c) };
+    auto value = GetExactValue(global);
+    value -= fine.GlobalToValue(global);
+    EXPECT_NEAR(value.norm(), 0, 1e-12);
+  }
+}
+TEST_F(TestPolynomialHexahedronInterpolation, Transfer) {
+  CheckTransfer<true>();
+  CheckTransfer<false>();
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -66,6 +66,33 @@ TEST_F(TestRiemannEulerTypes, TestConverters) {
   EXPECT_DOUBLE_EQ(primitive_copy.v(), v);
   EXPECT_DOUBLE_EQ(primitive_copy.p(), p);
 }
+TEST_F(TestRiemannEulerTypes, TestBatchedConverters) {
+  using Gas = mini::riemann::euler::IdealGas<double, 1.4>;
+  using Conservative = mini::riemann::euler::Conservatives<double, 3>;
+  using Batch = mini::riemann::euler::Batch<double, 3>;
+  // valid states, and invalid ones on each branch of the scalar version
+  auto conservatives = std::vector<Conservative>{
+    { 1.2, 0.3, -0.4, 0.5, 2.5 },  // valid
+    { 1.2, 0.3, -0.4, 0.5, -2.5 },  // negative energy
+    { 1.2, 3.0, -4.0, 5.0, 2.5 },  // negative pressure
+    { -1.2, 0.3, -0.4, 0.5, 2.5 },  // negative density
+    { 0.0, 0.3, -0.4, 0.5, 2.5 },  // zero density
+    { 0.0, 0.3, -0.4, 0.5, -2.5 },  // zero density and negative energy
+    { 0.0, 0.0, 0.0, 0.0, 0.0 },  // vacuum
+  };
+  int n = conservatives.size();
+  Batch conservative_batch(n, 5), primitive_batch;
+  for (int i = 0; i < n; ++i) {
+    conservative_batch.row(i) = conservatives[i].transpose();
+  }
+  Gas::ConservativeToPrimitive(conservative_batch, &primitive_batch);
+  for (int i = 0; i < n; ++i) {
+    auto primitive = Gas::ConservativeToPrimitive(conservatives[i]);
+    for (int k = 0; k < 5; ++k) {
+      EXPECT_DOUBLE_EQ(primitive_batch(i, k), primitive[k]);
+    }
+  }
+}
 
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
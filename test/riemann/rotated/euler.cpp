@@ -6,8 +6,11 @@
 #include "gtest/gtest.h"
 
 #include "mini/geometry/pi.hpp"
+#include "mini/riemann/concept.hpp"
 #include "mini/riemann/euler/types.hpp"
 #include "mini/riemann/euler/exact.hpp"
+#include "mini/riemann/euler/hllc.hpp"
+#include "mini/riemann/euler/ausm.hpp"
 
 #define SOLVE_RIEMANN_PROBLEM_ON_INVISCID_WALL_
 #include "mini/riemann/rotated/euler.hpp"
@@ -149,6 +152,48 @@ TEST_F(TestRotatedEuler, Test3dSolver) {
     EXPECT_EQ(0.0, flux.energy());
   }
 }
+template <class Solver>
+void CompareBatchedWithPointwise(double (*rand_f)(), double (*disturb)(double)) {
+  using Vector = typename Solver::Vector;
+  using Frame = typename Solver::Frame;
+  using Primitive = typename Solver::Primitive;
+  using Gas = typename Solver::Gas;
+  using Batch = typename Solver::Batch;
+  static_assert(mini::riemann::Batched<Solver>);
+  int n = Solver::kMaxBatch - 3;
+  auto frames = std::vector<Frame>(n);
+  auto solvers = std::vector<Solver>(n);
+  Batch left(n, Solver::kComponents), right(n, Solver::kComponents);
+  for (int i = 0; i < n; ++i) {
+    Vector a = Vector(rand_f(), rand_f(), rand_f()).normalized();
+    Vector b = a.cross(Vector(rand_f(), rand_f(), rand_f())).normalized();
+    frames[i] = { a, b, a.cross(b) };
+    solvers[i].Rotate(frames[i]);
+    left.row(i) = Gas::PrimitiveToConservative(Primitive(disturb(1.29),
+        300 * rand_f(), 300 * rand_f(), 300 * rand_f(), disturb(101325)));
+    right.row(i) = Gas::PrimitiveToConservative(Primitive(disturb(1.29),
+        300 * rand_f(), 300 * rand_f(), 300 * rand_f(), disturb(101325)));
+  }
+  Batch flux;
+  Solver::GetFluxesUpwind(solvers, left, right, &flux);
+  EXPECT_EQ(flux.rows(), n);
+  for (int i = 0; i < n; ++i) {
+    typename Solver::Conservative left_i = left.row(i).transpose();
+    typename Solver::Conservative right_i = right.row(i).transpose();
+    auto flux_i = solvers[i].GetFluxUpwind(left_i, right_i);
+    for (int k = 0; k < Solver::kComponents; ++k) {
+      EXPECT_NEAR(flux(i, k), flux_i[k], 1e-8 * (1 + std::abs(flux_i[k])));
+    }
+  }
+}
+TEST_F(TestRotatedEuler, TestBatchedSolvers) {
+  std::srand(31415926);
+  CompareBatchedWithPointwise<Euler<euler::HartenLaxLeerContact<Gas, 3>>>(
+      rand_f, disturb);
+  CompareBatchedWithPointwise<Euler<euler::AdvectionUpstreamSplittingMethod<
+      Gas, 3>>>(rand_f, disturb);
+  CompareBatchedWithPointwise<Euler<euler::Exact<Gas, 3>>>(rand_f, disturb);
+}
 
 }  // namespace rotated
 }  // namespace riemann
@@ -0,0 +1,130 @@
+//  Copyright 2024 PEI Weicheng
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+#include "mini/mesh/cgns.hpp"
+#include "mini/mesh/part.hpp"
+#include "mini/polynomial/projection.hpp"
+#include "mini/polynomial/hexahedron.hpp"
+#include "mini/riemann/concept.hpp"
+#include "mini/riemann/euler/types.hpp"
+#include "mini/riemann/euler/hllc.hpp"
+#include "mini/riemann/rotated/euler.hpp"
+#include "mini/spatial/dg/general.hpp"
+#include "mini/spatial/dg/lobatto.hpp"
+#include "mini/spatial/fr/general.hpp"
+#include "mini/spatial/fr/lobatto.hpp"
+#include "mini/basis/vincent.hpp"
+#include "mini/input/path.hpp"  // defines PROJECT_BINARY_DIR
+
+#include "test/mesh/part.hpp"
+
+constexpr int kEulerComponents = kDimensions + 2;
+using EulerValue = mini::algebra::Vector<Scalar, kEulerComponents>;
+
+using Gas = mini::riemann::euler::IdealGas<Scalar, 1.4>;
+using Unrotated = mini::riemann::euler::HartenLaxLeerContact<Gas, kDimensions>;
+using Riemann = mini::riemann::rotated::Euler<Unrotated>;
+static_assert(mini::riemann::Batched<Riemann>);
+
+/**
+ * @brief The same solver as `Riemann`, but its `Batch` is hidden, so spatial schemes call it point by point.
+ *
+ */
+class PointwiseRiemann : public Riemann {
+ public:
+  using Batch = void;
+};
+static_assert(mini::riemann::Convective<PointwiseRiemann>);
+static_assert(!mini::riemann::Batched<PointwiseRiemann>);
+
+EulerValue GetConservative(Coord const &xyz) {
+  auto x = xyz[0], y = xyz[1], z = xyz[2];
+  auto primitive = typename Riemann::Primitive(1.29 + 0.2 * std::sin(x + y),
+      100 + 20 * y, -50 + 10 * x, 30 * z,
+      101325 * (1 + 0.1 * std::cos(x - z)));
+  return Gas::PrimitiveToConservative(primitive);
+}
+
+auto case_name = PROJECT_BINARY_DIR + std::string("/test/mesh/double_mach");
+
+class TestSpatialBatched : public ::testing::Test {
+ protected:
+  template <class Spatial>
+  static auto GetResidualColumn(Spatial *spatial_ptr) {
+    for (auto name : { "4_S_27", "4_S_31", "4_S_1", "4_S_32", "4_S_19",
+        "4_S_23", "4_S_15" }) {
+      spatial_ptr->SetSupersonicOutlet(name);
+    }
+    spatial_ptr->Approximate(GetConservative);
+    spatial_ptr->SetTime(1.5);
+    return spatial_ptr->GetResidualColumn();
+  }
+  /**
+   * @brief Compare the residuals got by batched and pointwise Riemann solvers on the same `Part`.
+   *
+   * @tparam Batched the spatial scheme using `Riemann`
+   * @tparam Pointwise the spatial scheme using `PointwiseRiemann`
+   */
+  template <class Batched, class Pointwise, class Part, class... Args>
+  static void CompareResiduals(Part *part_ptr, Args &&...args) {
+    time_begin = MPI_Wtime();
+    auto batched = Batched(part_ptr, args...);
+    auto batched_residual = GetResidualColumn(&batched);
+    auto pointwise = Pointwise(part_ptr, std::forward<Args>(args)...);
+    auto pointwise_residual = GetResidualColumn(&pointwise);
+    std::printf("%s() proc[%d/%d] cost %f sec\n",
+        batched.name().c_str(), i_core, n_core, MPI_Wtime() - time_begin);
+    ASSERT_EQ(batched_residual.size(), pointwise_residual.size());
+    EXPECT_GT(pointwise_residual.norm(), 0);
+    EXPECT_NEAR((batched_residual - pointwise_residual).norm(), 0,
+        1e-10 * pointwise_residual.norm());
+  }
+};
+TEST_F(TestSpatialBatched, GeneralDG) {
+  using Polynomial = mini::polynomial::Projection<
+      Scalar, kDimensions, kDegrees, kEulerComponents>;
+  using Part = mini::mesh::part::Part<cgsize_t, Polynomial>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  CompareResiduals<mini::spatial::dg::General<Part, Riemann>,
+      mini::spatial::dg::General<Part, PointwiseRiemann>>(&part);
+}
+TEST_F(TestSpatialBatched, LobattoDG) {
+  using Polynomial = mini::polynomial::Hexahedron<Gx, Gx, Gx,
+      kEulerComponents, true>;
+  using Part = mini::mesh::part::Part<cgsize_t, Polynomial>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  CompareResiduals<mini::spatial::dg::Lobatto<Part, Riemann>,
+      mini::spatial::dg::Lobatto<Part, PointwiseRiemann>>(&part);
+}
+TEST_F(TestSpatialBatched, GeneralFR) {
+  using Polynomial = mini::polynomial::Hexahedron<Gx, Gx, Gx,
+      kEulerComponents, true>;
+  using Part = mini::mesh::part::Part<cgsize_t, Polynomial>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  using Vincent = mini::basis::Vincent<Scalar>;
+  CompareResiduals<mini::spatial::fr::General<Part, Riemann>,
+      mini::spatial::fr::General<Part, PointwiseRiemann>>(&part,
+      Vincent::HuynhLumpingLobatto(kDegrees));
+}
+TEST_F(TestSpatialBatched, LobattoFR) {
+  using Polynomial = mini::polynomial::Hexahedron<Gx, Gx, Gx,
+      kEulerComponents, true>;
+  using Part = mini::mesh::part::Part<cgsize_t, Polynomial>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  CompareResiduals<mini::spatial::fr::Lobatto<Part, Riemann>,
+      mini::spatial::fr::Lobatto<Part, PointwiseRiemann>>(&part);
+}
+
+// mpirun -n 4 ./part must be run in ../mesh
+// mpirun -n 4 ./batched
+int main(int argc, char* argv[]) {
+  return Main(argc, argv);
+}
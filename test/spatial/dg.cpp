@@ -42,20 +42,15 @@ Scalar Norm1(Part const &part) {
 
 auto case_name = PROJECT_BINARY_DIR + std::string("/test/mesh/double_mach");
 
-// mpirun -n 4 ./part must be run in ../mesh
-// mpirun -n 4 ./dg
-int main(int argc, char* argv[]) {
-  int n_core, i_core;
-  double time_begin;
-  MPI_Init(NULL, NULL);
-  MPI_Comm_size(MPI_COMM_WORLD, &n_core);
-  MPI_Comm_rank(MPI_COMM_WORLD, &i_core);
-  cgp_mpi_comm(MPI_COMM_WORLD);
-
+class TestSpatialDG : public ::testing::Test {
+ protected:
+  void SetUp() override;
+};
+void TestSpatialDG::SetUp() {
   test::spatial::ResetRiemann();
-
+}
+TEST_F(TestSpatialDG, GeneralWithBasisTables) {
   /* aproximated by Projection on OrthoNormal basis */
-{
   time_begin = MPI_Wtime();
   using Polynomial = mini::polynomial::Projection<
       Scalar, kDimensions, kDegrees, kComponents>;
@@ -92,12 +87,26 @@ int main(int argc, char* argv[]) {
 
   time_begin = MPI_Wtime();
   column = spatial.GetResidualColumn();
+  auto residual_norm2 = column.squaredNorm();
   std::printf("residual.squaredNorm() == %6.2e on proc[%d/%d] cost %f sec\n",
+      residual_norm2, i_core, n_core, MPI_Wtime() - time_begin);
+  MPI_Barrier(MPI_COMM_WORLD);
+
+  /* Check equivalence between evaluated and tabulated basis values. */
+  time_begin = MPI_Wtime();
+  spatial.BuildBasisTables();
+  std::printf("BuildBasisTables() on proc[%d/%d] cost %f sec\n",
+      i_core, n_core, MPI_Wtime() - time_begin);
+  time_begin = MPI_Wtime();
+  column -= spatial.GetResidualColumn();
+  std::printf("(residual - tabulated).squaredNorm() == %6.2e"
+      " on proc[%d/%d] cost %f sec\n",
       column.squaredNorm(), i_core, n_core, MPI_Wtime() - time_begin);
+  EXPECT_NEAR(column.squaredNorm(), 0.0, 1e-20 * residual_norm2);
   MPI_Barrier(MPI_COMM_WORLD);
 }
+TEST_F(TestSpatialDG, Lobatto) {
   /* aproximated by Projection on Lagrange basis on Lobatto roots */
-{
   time_begin = MPI_Wtime();
   /* Check equivalence between local and global formulation. */
 {
@@ -320,5 +329,9 @@ int main(int argc, char* argv[]) {
       column.squaredNorm(), i_core, n_core, MPI_Wtime() - time_begin);
   MPI_Barrier(MPI_COMM_WORLD);
 }
-  MPI_Finalize();
+
+// mpirun -n 4 ./part must be run in ../mesh
+// mpirun -n 4 ./dg
+int main(int argc, char* argv[]) {
+  return Main(argc, argv);
 }
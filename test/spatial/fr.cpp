@@ -95,6 +95,23 @@ TEST_F(TestSpatialFR, CompareResiduals) {
   auto lobatto_residual = GetResidualColumn(&lobatto, &part);
   EXPECT_NEAR(0, (general_residual - lobatto_residual).squaredNorm(), 1e-15);
 }
+TEST_F(TestSpatialFR, ShareTracesOnly) {
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  // Without diffusion, only traces on ghost faces are shared.
+  using Lobatto = mini::spatial::fr::Lobatto<Part, test::spatial::Convection>;
+  auto lobatto = Lobatto(&part);
+  GetResidualColumn(&lobatto, &part);
+  // Modify coeffs on local cells without sharing them:
+  for (auto *cell_ptr : part.GetLocalCellPointers()) {
+    cell_ptr->Approximate([](Coord const &xyz) { return Value(func(xyz) * 2); });
+  }
+  auto residual_by_traces = lobatto.GetResidualColumn();
+  part.ShareGhostCellCoeffs();
+  part.UpdateGhostCellCoeffs();
+  auto residual_by_cells = lobatto.GetResidualColumn();
+  EXPECT_EQ(residual_by_traces, residual_by_cells);
+}
 
 // mpirun -n 4 ./part must be run in ../mesh
 // mpirun -n 4 ./fr
@@ -0,0 +1,181 @@
+//  Copyright 2024 PEI Weicheng
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mini/mesh/cgns.hpp"
+#include "mini/mesh/part.hpp"
+#include "mini/polynomial/projection.hpp"
+#include "mini/polynomial/hexahedron.hpp"
+#include "mini/spatial/dg/general.hpp"
+#include "mini/spatial/dg/lobatto.hpp"
+#include "mini/spatial/fr/general.hpp"
+#include "mini/spatial/fr/lobatto.hpp"
+#include "mini/basis/vincent.hpp"
+#include "mini/input/path.hpp"  // defines PROJECT_BINARY_DIR
+
+#include "test/mesh/part.hpp"
+#include "test/spatial/riemann.hpp"
+
+using Hexahedron = mini::polynomial::Hexahedron<Gx, Gx, Gx, kComponents, true>;
+using Projection = mini::polynomial::Projection<
+    Scalar, kDimensions, kDegrees, kComponents>;
+
+auto case_name = PROJECT_BINARY_DIR + std::string("/test/mesh/double_mach");
+
+class TestSpatialImplicit : public ::testing::Test {
+ protected:
+  // the number of cells checked on each `Part`
+  static constexpr int kCheckedCells = 3;
+
+  void SetUp() override {
+    test::spatial::ResetRiemann();
+  }
+
+  template <class Spatial>
+  static void SetBoundaries(Spatial *spatial_ptr) {
+    spatial_ptr->SetSmartBoundary("4_S_31", moving);  // Left
+    spatial_ptr->SetInviscidWall("4_S_1");   // Back
+    spatial_ptr->SetSubsonicInlet("4_S_32", moving);  // Front
+    spatial_ptr->SetSubsonicOutlet("4_S_23", moving);  // Right
+    spatial_ptr->SetSupersonicInlet("4_S_27", moving);  // Top
+    spatial_ptr->SetSupersonicOutlet("4_S_15");  // Gap
+    spatial_ptr->SetSupersonicOutlet("4_S_19");  // Bottom
+    spatial_ptr->Approximate(func);
+    spatial_ptr->SetTime(1.5);
+  }
+
+  /**
+   * @brief Check the `ImplicitSystem` methods of a viscous scheme against its full residual and the residual of an inviscid scheme on the same `Part`.
+   *
+   * @tparam Viscous the spatial scheme using `test::spatial::Riemann`
+   * @tparam Inviscid the same scheme using `test::spatial::Convection`
+   */
+  template <class Viscous, class Inviscid, class Part, class... Args>
+  static void CheckImplicitSystem(Part *part_ptr, Args &&...args) {
+    using Column = typename Viscous::Column;
+    auto viscous = Viscous(part_ptr, args...);
+    SetBoundaries(&viscous);
+    Column stiff, nonstiff;
+    viscous.WriteStiffAndNonstiffResidualsTo(&stiff, &nonstiff);
+    // The full residual is got after the split, so the mode is restored.
+    auto residual = viscous.GetResidualColumn();
+    ASSERT_EQ(stiff.size(), residual.size());
+    ASSERT_EQ(nonstiff.size(), residual.size());
+    EXPECT_GT(stiff.norm(), 0);
+    EXPECT_NEAR((stiff + nonstiff - residual).norm(), 0,
+        1e-12 * residual.norm());
+    // The nonstiff part is the residual of the inviscid scheme.
+    {
+      auto inviscid = Inviscid(part_ptr, std::forward<Args>(args)...);
+      SetBoundaries(&inviscid);
+      auto inviscid_residual = inviscid.GetResidualColumn();
+      EXPECT_NEAR((nonstiff - inviscid_residual).norm(), 0,
+          1e-10 * inviscid_residual.norm());
+    }
+    // The inner product is reduced over all `Part`s.
+    Column ones = Column::Ones(residual.size());
+    int local_size = residual.size(), global_size;
+    MPI_Allreduce(&local_size, &global_size, 1, MPI_INT, MPI_SUM,
+        MPI_COMM_WORLD);
+    EXPECT_EQ(viscous.GetInnerProduct(ones, ones), global_size);
+    CheckPreconditioner(&viscous, *part_ptr, stiff);
+  }
+
+  /**
+   * @brief Check each block of the preconditioner against \f$ I - \gamma\,\Delta t\,\partial R_\mathrm{stiff} / \partial U \f$, whose product with a Column is got by a finite difference of the stiff residual.
+   *
+   * Only cells touching neither boundaries nor other `Part`s are checked, since only the blocks on them are exact.
+   * Each `Part` perturbs one of its cells at a time, which cannot be a neighbor of the cells perturbed by other `Part`s.
+   */
+  template <class Spatial, class Part>
+  static void CheckPreconditioner(Spatial *spatial_ptr, Part const &part,
+      typename Spatial::Column const &stiff) {
+    using Column = typename Spatial::Column;
+    constexpr int kFields = Part::Cell::kFields;
+    auto checked_cells = std::vector<typename Part::Cell const *>();
+    for (auto const &cell : part.GetLocalCells()) {
+      if (std::ssize(checked_cells) == kCheckedCells) {
+        break;
+      }
+      bool interior = cell.boundary_faces_.empty();
+      for (auto const *neighbor : cell.adj_cells_) {
+        interior = interior && part.IsLocal(neighbor->id());
+      }
+      if (interior) {
+        checked_cells.emplace_back(&cell);
+      }
+    }
+    Scalar gamma_dt = 10 * spatial_ptr->GetTimeStep(1e100, 3);
+    spatial_ptr->UpdatePreconditioner(gamma_dt);
+    Column x = Column::Random(stiff.size());
+    Column y = x;
+    // y = P^{-1} x, so P y == x on each checked cell
+    spatial_ptr->ApplyPreconditioner(&y);
+    auto u = spatial_ptr->GetSolutionColumn();
+    Column stiff_perturbed;
+    for (int i_checked = 0; i_checked < kCheckedCells; ++i_checked) {
+      auto u_perturbed = u;
+      int offset = -1;
+      Scalar eps = 0;
+      if (i_checked < std::ssize(checked_cells)) {
+        offset = part.GetCellDataOffset(checked_cells[i_checked]->id());
+        eps = 1e-3 * std::max(Scalar(1), u.segment(offset, kFields).norm())
+            / y.segment(offset, kFields).norm();
+        u_perturbed.segment(offset, kFields)
+            += eps * y.segment(offset, kFields);
+      }
+      // All `Part`s take part in the halo exchange.
+      spatial_ptr->SetSolutionColumn(u_perturbed);
+      spatial_ptr->WriteStiffResidualTo(&stiff_perturbed);
+      if (offset < 0) {
+        continue;
+      }
+      Column j_y = (stiff_perturbed - stiff).segment(offset, kFields) / eps;
+      Column p_y = y.segment(offset, kFields) - gamma_dt * j_y;
+      Column x_i = x.segment(offset, kFields);
+      EXPECT_NEAR((p_y - x_i).norm(), 0,
+          1e-6 * (x_i.norm() + gamma_dt * j_y.norm()));
+    }
+    spatial_ptr->SetSolutionColumn(u);
+  }
+};
+TEST_F(TestSpatialImplicit, GeneralDG) {
+  using Part = mini::mesh::part::Part<cgsize_t, Projection>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  CheckImplicitSystem<mini::spatial::dg::General<Part, test::spatial::Riemann>,
+      mini::spatial::dg::General<Part, test::spatial::Convection>>(&part);
+}
+TEST_F(TestSpatialImplicit, LobattoDG) {
+  using Part = mini::mesh::part::Part<cgsize_t, Hexahedron>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  CheckImplicitSystem<mini::spatial::dg::Lobatto<Part, test::spatial::Riemann>,
+      mini::spatial::dg::Lobatto<Part, test::spatial::Convection>>(&part);
+}
+TEST_F(TestSpatialImplicit, GeneralFR) {
+  using Part = mini::mesh::part::Part<cgsize_t, Hexahedron>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  using Vincent = mini::basis::Vincent<Scalar>;
+  CheckImplicitSystem<mini::spatial::fr::General<Part, test::spatial::Riemann>,
+      mini::spatial::fr::General<Part, test::spatial::Convection>>(&part,
+      Vincent::HuynhLumpingLobatto(kDegrees));
+}
+TEST_F(TestSpatialImplicit, LobattoFR) {
+  using Part = mini::mesh::part::Part<cgsize_t, Hexahedron>;
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  CheckImplicitSystem<mini::spatial::fr::Lobatto<Part, test::spatial::Riemann>,
+      mini::spatial::fr::Lobatto<Part, test::spatial::Convection>>(&part);
+}
+
+// mpirun -n 4 ./part must be run in ../mesh
+// mpirun -n 4 ./implicit
+int main(int argc, char* argv[]) {
+  return Main(argc, argv);
+}
@@ -0,0 +1,145 @@
+//  Copyright 2024 PEI Weicheng
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "mini/mesh/cgns.hpp"
+#include "mini/mesh/part.hpp"
+#include "mini/polynomial/projection.hpp"
+#include "mini/spatial/dg/general.hpp"
+#include "mini/spatial/multigrid.hpp"
+#include "mini/temporal/ode.hpp"
+#include "mini/temporal/steady.hpp"
+#include "mini/temporal/multigrid.hpp"
+#include "mini/input/path.hpp"  // defines PROJECT_BINARY_DIR
+
+#include "test/mesh/part.hpp"
+#include "test/spatial/riemann.hpp"
+
+template <int kDegree>
+using Projection = mini::polynomial::Projection<
+    Scalar, kDimensions, kDegree, kComponents>;
+using FinePart = mini::mesh::part::Part<cgsize_t, Projection<kDegrees>>;
+using CoarsePart = mini::mesh::part::Part<cgsize_t, Projection<kDegrees - 1>>;
+using ConstantPart = mini::mesh::part::Part<cgsize_t, Projection<0>>;
+using Fine = mini::spatial::dg::General<FinePart, test::spatial::Convection>;
+using Coarse = mini::spatial::dg::General<CoarsePart,
+    test::spatial::Convection>;
+using Constant = mini::spatial::dg::General<ConstantPart,
+    test::spatial::Convection>;
+using Multigrid = mini::temporal::FullApproximationScheme<Scalar>;
+using Column = typename Multigrid::Column;
+
+auto case_name = PROJECT_BINARY_DIR + std::string("/test/mesh/double_mach");
+
+class TestSpatialMultigrid : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    test::spatial::ResetRiemann();
+  }
+
+  template <class Spatial>
+  static void SetBoundaries(Spatial *spatial_ptr) {
+    spatial_ptr->SetSmartBoundary("4_S_31", moving);  // Left
+    spatial_ptr->SetInviscidWall("4_S_1");   // Back
+    spatial_ptr->SetSubsonicInlet("4_S_32", moving);  // Front
+    spatial_ptr->SetSubsonicOutlet("4_S_23", moving);  // Right
+    spatial_ptr->SetSupersonicInlet("4_S_27", moving);  // Top
+    spatial_ptr->SetSupersonicOutlet("4_S_15");  // Gap
+    spatial_ptr->SetSupersonicOutlet("4_S_19");  // Bottom
+    spatial_ptr->Approximate(func);
+    spatial_ptr->SetTime(1.5);
+  }
+};
+TEST_F(TestSpatialMultigrid, TransferBetweenDegrees) {
+  auto fine_part = FinePart(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&fine_part);
+  auto coarse_part = CoarsePart(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&coarse_part);
+  auto fine = Fine(&fine_part);
+  auto coarse = Coarse(&coarse_part);
+  SetBoundaries(&fine);
+  SetBoundaries(&coarse);
+  auto restriction = mini::spatial::GetTransfer(fine, coarse);
+  auto prolongation = mini::spatial::GetTransfer(coarse, fine);
+  // prolonging to a higher degree and restricting back is exact
+  Column coarse_solution = coarse.GetSolutionColumn(), fine_solution;
+  prolongation(coarse_solution, &fine_solution);
+  EXPECT_EQ(fine_solution.size(), fine.GetSolutionColumn().size());
+  Column coarse_again;
+  restriction(fine_solution, &coarse_again);
+  EXPECT_NEAR((coarse_again - coarse_solution).norm(), 0,
+      1e-10 * coarse_solution.norm());
+}
+TEST_F(TestSpatialMultigrid, CoarseCorrection) {
+  auto fine_part = FinePart(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&fine_part);
+  auto coarse_part = CoarsePart(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&coarse_part);
+  auto fine = Fine(&fine_part);
+  auto coarse = Coarse(&coarse_part);
+  SetBoundaries(&fine);
+  SetBoundaries(&coarse);
+  auto restriction = mini::spatial::GetTransfer(fine, coarse);
+  auto prolongation = mini::spatial::GetTransfer(coarse, fine);
+  // Without smoothing on the fine level, one Euler step on the coarse level
+  // gives u_coarse += dt * (R_coarse(I u) + I R_fine(u) - R_coarse(I u)),
+  // so the V-cycle gives u += dt * P I R_fine(u).
+  auto euler = mini::temporal::Euler<Scalar>();
+  auto multigrid = Multigrid(0, 0, 1);
+  double dt = fine.GetTimeStep(1e100, 3);
+  multigrid.AddLevel(&fine, &euler);
+  multigrid.AddLevel(&coarse, &euler, dt, restriction, prolongation);
+  Column u_old = fine.GetSolutionColumn();
+  Column fine_residual = fine.GetResidualColumn(), coarse_residual;
+  restriction(fine_residual, &coarse_residual);
+  Column correction;
+  prolongation(coarse_residual, &correction);
+  multigrid.Update(&fine, 1.5, 1e100);
+  Column u_new = fine.GetSolutionColumn();
+  EXPECT_GT(correction.norm(), 0);
+  EXPECT_NEAR((u_new - u_old - dt * correction).norm(), 0,
+      1e-10 * (u_old.norm() + dt * fine_residual.norm()));
+}
+TEST_F(TestSpatialMultigrid, ReduceResidual) {
+  auto fine_part = FinePart(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&fine_part);
+  auto coarse_part = CoarsePart(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&coarse_part);
+  // The coarsest level holds piecewise constants, i.e. `Taylor<3, 0>`.
+  auto constant_part = ConstantPart(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&constant_part);
+  auto fine = Fine(&fine_part);
+  auto coarse = Coarse(&coarse_part);
+  auto constant = Constant(&constant_part);
+  SetBoundaries(&fine);
+  SetBoundaries(&coarse);
+  SetBoundaries(&constant);
+  using Pseudo = mini::temporal::PseudoTimeStepping<3, Scalar>;
+  auto fine_smoother = Pseudo(), coarse_smoother = Pseudo();
+  auto constant_smoother = Pseudo();
+  auto multigrid = Multigrid(2, 2, 4);
+  multigrid.AddLevel(&fine, &fine_smoother);
+  multigrid.AddLevel(&coarse, &coarse_smoother, 1e100,
+      mini::spatial::GetTransfer(fine, coarse),
+      mini::spatial::GetTransfer(coarse, fine));
+  multigrid.AddLevel(&constant, &constant_smoother, 1e100,
+      mini::spatial::GetTransfer(coarse, constant),
+      mini::spatial::GetTransfer(constant, coarse));
+  EXPECT_EQ(multigrid.CountLevels(), 3);
+  auto initial_norm = fine.GetNorms(fine.GetResidualColumn()).first;
+  for (int i_cycle = 0; i_cycle < 4; ++i_cycle) {
+    multigrid.Update(&fine, 1.5, 1e100);
+  }
+  auto final_norm = fine.GetNorms(fine.GetResidualColumn()).first;
+  if (i_core == 0) {
+    std::printf("residual norm: %6.2e -> %6.2e\n", initial_norm, final_norm);
+  }
+  EXPECT_LT(final_norm, initial_norm);
+}
+
+// mpirun -n 4 ./part must be run in ../mesh
+// mpirun -n 4 ./multigrid
+int main(int argc, char* argv[]) {
+  return Main(argc, argv);
+}
@@ -0,0 +1,181 @@
+//  Copyright 2024 PEI Weicheng
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "mini/mesh/cgns.hpp"
+#include "mini/mesh/part.hpp"
+#include "mini/polynomial/hexahedron.hpp"
+#include "mini/spatial/dg/lobatto.hpp"
+#include "mini/spatial/fr/lobatto.hpp"
+#include "mini/temporal/multirate.hpp"
+#include "mini/input/path.hpp"  // defines PROJECT_BINARY_DIR
+
+#include "test/mesh/part.hpp"
+#include "test/spatial/riemann.hpp"
+
+using Polynomial = mini::polynomial::Hexahedron<Gx, Gx, Gx, kComponents, true>;
+using Part = mini::mesh::part::Part<cgsize_t, Polynomial>;
+
+auto case_name = PROJECT_BINARY_DIR + std::string("/test/mesh/double_mach");
+
+class TestSpatialMultirate : public ::testing::Test {
+ protected:
+  static constexpr int kOrders = 3;
+  static constexpr int kLevels = 3;
+
+  void SetUp() override {
+    test::spatial::ResetRiemann();
+  }
+
+  template <class Spatial>
+  static void SetBoundaries(Spatial *spatial_ptr) {
+    spatial_ptr->SetSmartBoundary("4_S_31", moving);  // Left
+    spatial_ptr->SetInviscidWall("4_S_1");   // Back
+    spatial_ptr->SetSubsonicInlet("4_S_32", moving);  // Front
+    spatial_ptr->SetSubsonicOutlet("4_S_23", moving);  // Right
+    spatial_ptr->SetSupersonicInlet("4_S_27", moving);  // Top
+    spatial_ptr->SetSupersonicOutlet("4_S_15");  // Gap
+    spatial_ptr->SetSupersonicOutlet("4_S_19");  // Bottom
+    spatial_ptr->Approximate(func);
+    spatial_ptr->SetTime(1.5);
+  }
+
+  /**
+   * @brief Check the levels set by `UpdateTimeLevels`, and return whether some face has different levels on its two sides.
+   *
+   * @param dt_min_ptr the step of the finest level, which is overwritten
+   */
+  template <class Spatial>
+  static bool CheckTimeLevels(Spatial *spatial_ptr, Part const &part,
+      double *dt_min_ptr = nullptr) {
+    auto local_dt = spatial_ptr->GetSolutionColumn();
+    spatial_ptr->WriteLocalTimeStepsTo(&local_dt, kOrders);
+    double dt_min = local_dt.minCoeff();
+    MPI_Allreduce(MPI_IN_PLACE, &dt_min, 1, MPI_DOUBLE, MPI_MIN,
+        MPI_COMM_WORLD);
+    // Let cells away from other `Part`s be on coarser levels.
+    dt_min /= 1 << (kLevels - 1);
+    spatial_ptr->UpdateTimeLevels(dt_min, kOrders, kLevels);
+    if (dt_min_ptr) {
+      *dt_min_ptr = dt_min;
+    }
+    EXPECT_EQ(spatial_ptr->CountTimeLevels(), kLevels);
+    auto levels = std::vector<int8_t>();
+    spatial_ptr->WriteTimeLevelsTo(&levels);
+    EXPECT_EQ(std::ssize(levels), local_dt.size());
+    auto get_level = [&](auto const &cell) {
+      return levels.at(part.GetCellDataOffset(cell.id()));
+    };
+    for (auto const &cell : part.GetLocalCells()) {
+      int level = get_level(cell);
+      EXPECT_LE(0, level);
+      EXPECT_LT(level, kLevels);
+      // the step of each level is stable on its cells
+      auto i_head = part.GetCellDataOffset(cell.id());
+      EXPECT_LE((1 << level) * dt_min, local_dt[i_head] * (1 + 1e-12));
+    }
+    for (auto const &face : part.GetGhostFaces()) {
+      EXPECT_EQ(get_level(face.holder()), 0);
+    }
+    bool has_jump = false;
+    for (auto const &face : part.GetLocalFaces()) {
+      int jump = std::abs(get_level(face.holder()) - get_level(face.sharer()));
+      EXPECT_LE(jump, 1);
+      has_jump |= (jump == 1);
+    }
+    return has_jump;
+  }
+
+  /**
+   * @brief Check `WriteSplitResidualTo` on a frozen solution.
+   *
+   * Each cell (or face) on level `l` is active in `2^(n_levels - 1 - l)` substeps with its residual scaled by `2^l`, and the correction makes up the difference on faces between levels.
+   * So summing the split residual and the correction over all substeps of a macro step must give `2^(n_levels - 1)` copies of the unsplit residual.
+   */
+  template <class Spatial>
+  static void CheckSplitResidual(Spatial *spatial_ptr, bool has_jump) {
+    using Column = typename Spatial::Column;
+    Column residual, correction;
+    spatial_ptr->SetSubstep(-1);
+    auto unsplit = spatial_ptr->GetResidualColumn();
+    spatial_ptr->WriteSplitResidualTo(&residual, &correction);
+    EXPECT_NEAR((residual - unsplit).norm(), 0, 1e-12 * unsplit.norm());
+    EXPECT_EQ(correction.norm(), 0);
+    int n_substeps = 1 << (kLevels - 1);
+    Column sum = Column::Zero(unsplit.size());
+    double correction_norm = 0;
+    for (int i_substep = 0; i_substep < n_substeps; ++i_substep) {
+      spatial_ptr->SetSubstep(i_substep);
+      spatial_ptr->WriteSplitResidualTo(&residual, &correction);
+      sum += residual;
+      sum += correction;
+      correction_norm += correction.norm();
+    }
+    spatial_ptr->SetSubstep(-1);
+    EXPECT_NEAR((sum - n_substeps * unsplit).norm(), 0,
+        1e-12 * n_substeps * unsplit.norm());
+    if (has_jump) {
+      // the correction path in AddFluxOnLocalFaces is taken
+      EXPECT_GT(correction_norm, 0);
+    }
+  }
+};
+TEST_F(TestSpatialMultirate, LobattoFR) {
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  using Spatial = mini::spatial::fr::Lobatto<Part, test::spatial::Riemann>;
+  auto spatial = Spatial(&part);
+  SetBoundaries(&spatial);
+  bool has_jump = CheckTimeLevels(&spatial, part);
+  if (n_core > 1) {
+    // cells next to other `Part`s are on the finest level, but others are not
+    EXPECT_TRUE(has_jump);
+  }
+  CheckSplitResidual(&spatial, has_jump);
+}
+TEST_F(TestSpatialMultirate, LobattoDG) {
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  using Spatial = mini::spatial::dg::Lobatto<Part, test::spatial::Riemann>;
+  auto spatial = Spatial(&part);
+  SetBoundaries(&spatial);
+  bool has_jump = CheckTimeLevels(&spatial, part);
+  CheckSplitResidual(&spatial, has_jump);
+}
+TEST_F(TestSpatialMultirate, PreserveConstant) {
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  using Spatial = mini::spatial::dg::Lobatto<Part, test::spatial::Convection>;
+  auto spatial = Spatial(&part);
+  auto constant = [](Coord const &xyz, double t) { return Value(1.0, 2.0); };
+  spatial.SetSmartBoundary("4_S_31", constant);  // Left
+  spatial.SetSmartBoundary("4_S_1", constant);   // Back
+  spatial.SetSmartBoundary("4_S_32", constant);  // Front
+  spatial.SetSmartBoundary("4_S_23", constant);  // Right
+  spatial.SetSmartBoundary("4_S_27", constant);  // Top
+  spatial.SetSmartBoundary("4_S_15", constant);  // Gap
+  spatial.SetSmartBoundary("4_S_19", constant);  // Bottom
+  spatial.Approximate([](Coord const &xyz) { return Value(1.0, 2.0); });
+  spatial.SetTime(0.0);
+  auto u_old = spatial.GetSolutionColumn();
+  double dt_min;
+  CheckTimeLevels(&spatial, part, &dt_min);
+  auto lts = mini::temporal::LocalTimeStepping<kOrders, Scalar>();
+  double dt_macro = dt_min * (1 << (kLevels - 1));
+  for (int i_step = 0; i_step < 4; ++i_step) {
+    lts.Update(&spatial, i_step * dt_macro, dt_macro);
+  }
+  auto u_new = spatial.GetSolutionColumn();
+  EXPECT_NEAR((u_new - u_old).cwiseAbs().maxCoeff(), 0, 1e-12);
+}
+
+// mpirun -n 4 ./part must be run in ../mesh
+// mpirun -n 4 ./multirate
+int main(int argc, char* argv[]) {
+  return Main(argc, argv);
+}
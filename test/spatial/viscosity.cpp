@@ -48,7 +48,11 @@ TEST_F(TestSpatialViscosity, LobattoFR) {
   auto spatial = Spatial(&part);
   RiemannWithViscosity::InstallSpatial(&spatial);
   auto damping_matrices = RiemannWithViscosity::BuildDampingMatrices();
-  std::cout << "[Done] BuildDampingMatrices" << std::endl;
+  std::cout << "[Done] BuildDampingMatrices: "
+      << damping_matrices.CountUniqueMatrices() << " unique matrices on "
+      << damping_matrices.CountCells() << " cells" << std::endl;
+  EXPECT_EQ(damping_matrices.CountCells(), part.CountLocalCells());
+  EXPECT_LE(damping_matrices.CountUniqueMatrices(), part.CountLocalCells());
   // BuildDampingMatrices() modifies Part, so Approximate() is called after it.
   for (auto *cell_ptr : part.GetLocalCellPointers()) {
     cell_ptr->Approximate(func);
@@ -65,10 +69,10 @@ TEST_F(TestSpatialViscosity, LobattoFR) {
   std::cout << "[Done] GetViscosityValues" << std::endl;
   RiemannWithViscosity::InitializeRequestsAndBuffers();
   std::cout << "[Done] InitializeRequestsAndBuffers" << std::endl;
-  RiemannWithViscosity::ShareGhostCellProperties();
-  std::cout << "[Done] ShareGhostCellProperties" << std::endl;
-  RiemannWithViscosity::UpdateGhostCellProperties();
-  std::cout << "[Done] UpdateGhostCellProperties" << std::endl;
+  RiemannWithViscosity::ShareGhostCellCoeffsAndProperties();
+  std::cout << "[Done] ShareGhostCellCoeffsAndProperties" << std::endl;
+  RiemannWithViscosity::UpdateGhostCellCoeffsAndProperties();
+  std::cout << "[Done] UpdateGhostCellCoeffsAndProperties" << std::endl;
   // Check values by VTK plotting:
   using VtkWriter = mini::mesh::vtk::Writer<Part>;
   using Cell = typename Part::Cell;
@@ -99,6 +103,69 @@ TEST_F(TestSpatialViscosity, LobattoFR) {
     }
   }
 }
+TEST_F(TestSpatialViscosity, CompactDampingMatrices) {
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  using RiemannWithViscosity = mini::spatial::EnergyBasedViscosity<
+      Part, test::spatial::Riemann>;
+  using Spatial = mini::spatial::fr::Lobatto<Part, RiemannWithViscosity>;
+  auto spatial = Spatial(&part);
+  RiemannWithViscosity::InstallSpatial(&spatial);
+  auto dense_matrices = RiemannWithViscosity::BuildDenseDampingMatrices();
+  using DampingMatrices = typename RiemannWithViscosity::DampingMatrices;
+  using DampingMatrix = typename RiemannWithViscosity::DampingMatrix;
+  auto n_cells = part.CountLocalCells();
+  auto compact_matrices = DampingMatrices(n_cells);
+  for (int i_cell = 0; i_cell < n_cells; ++i_cell) {
+    compact_matrices.Set(i_cell, dense_matrices.at(i_cell));
+  }
+  compact_matrices.Compress();
+  EXPECT_EQ(compact_matrices.CountCells(), n_cells);
+  constexpr int N = Part::Cell::N;
+  using Row = mini::algebra::Vector<Scalar, N>;
+  for (int i_cell = 0; i_cell < n_cells; ++i_cell) {
+    DampingMatrix const &dense = dense_matrices[i_cell];
+    DampingMatrix symmetric = (dense + dense.transpose()) / 2;
+    Scalar scale = symmetric.cwiseAbs().maxCoeff();
+    DampingMatrix compact = compact_matrices.GetMatrix(i_cell);
+    for (int r = 0; r < N; ++r) {
+      for (int c = 0; c < N; ++c) {
+        EXPECT_NEAR(compact(r, c), symmetric(r, c), 1e-9 * scale);
+      }
+    }
+    Row u = Row::Random();
+    EXPECT_NEAR(compact_matrices.GetQuadraticForm(i_cell, u), u.dot(dense * u),
+        1e-9 * scale * N * u.squaredNorm());
+  }
+}
+TEST_F(TestSpatialViscosity, SharedDampingMatrices) {
+  auto part = Part(case_name, i_core, n_core);
+  InstallIntegratorPrototypes(&part);
+  using RiemannWithViscosity = mini::spatial::EnergyBasedViscosity<
+      Part, test::spatial::Riemann>;
+  using Spatial = mini::spatial::fr::Lobatto<Part, RiemannWithViscosity>;
+  auto spatial = Spatial(&part);
+  RiemannWithViscosity::InstallSpatial(&spatial);
+  // built by sharing geometrically identical cells and coloring the others
+  auto shared_matrices = RiemannWithViscosity::BuildDampingMatrices();
+  // built cell by cell
+  auto dense_matrices = RiemannWithViscosity::BuildDenseDampingMatrices();
+  using DampingMatrix = typename RiemannWithViscosity::DampingMatrix;
+  auto n_cells = part.CountLocalCells();
+  EXPECT_EQ(shared_matrices.CountCells(), n_cells);
+  constexpr int N = Part::Cell::N;
+  for (int i_cell = 0; i_cell < n_cells; ++i_cell) {
+    DampingMatrix const &dense = dense_matrices.at(i_cell);
+    DampingMatrix symmetric = (dense + dense.transpose()) / 2;
+    Scalar scale = symmetric.cwiseAbs().maxCoeff();
+    DampingMatrix shared = shared_matrices.GetMatrix(i_cell);
+    for (int r = 0; r < N; ++r) {
+      for (int c = 0; c < N; ++c) {
+        EXPECT_NEAR(shared(r, c), symmetric(r, c), 1e-8 * scale);
+      }
+    }
+  }
+}
 
 // mpirun -n 4 ./part must be run in ../mesh
 // mpirun -n 4 ./viscosity
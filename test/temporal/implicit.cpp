@@ -0,0 +1,179 @@
+//  Copyright 2024 PEI Weicheng
+
+#include <cmath>
+#include <stdexcept>
+
+#include "mini/temporal/ode.hpp"
+#include "mini/temporal/rk.hpp"
+#include "mini/temporal/implicit.hpp"
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief The 2nd-order central scheme for `du/dt + a * du/dx = nu * d^2u/dx^2` on a periodic grid, whose diffusive part is stiff.
+ */
+class AdvectionDiffusion : public mini::temporal::System<double>,
+    public mini::temporal::ImplicitSystem<double> {
+ public:
+  using Column = typename mini::temporal::System<double>::Column;
+
+ private:
+  Column u_;
+  Eigen::PartialPivLU<Eigen::MatrixXd> preconditioner_;
+  double a_, nu_, h_;
+
+ public:
+  bool use_preconditioner = true;
+  // the numbers of evaluations of each part
+  mutable int n_stiff = 0, n_nonstiff = 0;
+
+  AdvectionDiffusion(int n, double a, double nu)
+      : a_(a), nu_(nu), h_(1.0 / n) {
+  }
+
+  void SetTime(double t_curr) final {
+  }
+  void SetSolutionColumn(Column const &u) final {
+    u_ = u;
+  }
+  void WriteSolutionTo(Column *u) const final {
+    *u = u_;
+  }
+  void WriteResidualTo(Column *residual) const final {
+    Column stiff, nonstiff;
+    WriteStiffAndNonstiffResidualsTo(&stiff, &nonstiff);
+    *residual = stiff + nonstiff;
+  }
+  void WriteStiffAndNonstiffResidualsTo(Column *stiff, Column *nonstiff) const
+      final {
+    WriteStiffResidualTo(stiff);
+    WriteNonstiffResidualTo(nonstiff);
+  }
+  void WriteStiffResidualTo(Column *stiff) const final {
+    ++n_stiff;
+    int n = u_.size();
+    stiff->resize(n);
+    for (int i = 0; i < n; ++i) {
+      double u_l = u_[(i + n - 1) % n], u_r = u_[(i + 1) % n];
+      (*stiff)[i] = nu_ * (u_l - 2 * u_[i] + u_r) / (h_ * h_);
+    }
+  }
+  void WriteNonstiffResidualTo(Column *nonstiff) const final {
+    ++n_nonstiff;
+    int n = u_.size();
+    nonstiff->resize(n);
+    for (int i = 0; i < n; ++i) {
+      double u_l = u_[(i + n - 1) % n], u_r = u_[(i + 1) % n];
+      (*nonstiff)[i] = -a_ * (u_r - u_l) / (2 * h_);
+    }
+  }
+  // the exact inverse of I - gamma_dt * dS/dU
+  void UpdatePreconditioner(double gamma_dt) final {
+    int n = u_.size();
+    double scale = gamma_dt * nu_ / (h_ * h_);
+    Eigen::MatrixXd matrix = Eigen::MatrixXd::Zero(n, n);
+    for (int i = 0; i < n; ++i) {
+      matrix(i, i) = 1 + 2 * scale;
+      matrix(i, (i + n - 1) % n) = matrix(i, (i + 1) % n) = -scale;
+    }
+    preconditioner_.compute(matrix);
+  }
+  void ApplyPreconditioner(Column *column) const final {
+    if (use_preconditioner) {
+      *column = preconditioner_.solve(*column);
+    }
+  }
+};
+
+class TestTemporalImplicit : public ::testing::Test {
+ protected:
+  using Column = AdvectionDiffusion::Column;
+  static constexpr int kCells = 32;
+
+  static Column GetInitialValue() {
+    Column u(kCells);
+    for (int i = 0; i < kCells; ++i) {
+      double x = (i + 0.5) / kCells - 0.5;
+      u[i] = 2 + std::exp(-32 * x * x);
+    }
+    return u;
+  }
+  static Column March(mini::temporal::Solver<double> *solver,
+      mini::temporal::System<double> *system, double t_end, int n_steps) {
+    system->SetSolutionColumn(GetInitialValue());
+    double dt = t_end / n_steps;
+    for (int i_step = 0; i_step < n_steps; ++i_step) {
+      solver->Update(system, i_step * dt, dt);
+    }
+    return system->GetSolutionColumn();
+  }
+};
+TEST_F(TestTemporalImplicit, StableBeyondExplicitLimit) {
+  // The explicit limit of the diffusive part is about h^2 / (2 nu).
+  auto system = AdvectionDiffusion(kCells, 0.0, 1.0);
+  auto solver = mini::temporal::ImplicitRungeKutta<double>();
+  Column u = March(&solver, &system, 1.0, 10);
+  double mean = GetInitialValue().mean();
+  EXPECT_NEAR(u.mean(), mean, 1e-10);
+  EXPECT_LT((u.array() - mean).abs().maxCoeff(), 1e-6);
+}
+TEST_F(TestTemporalImplicit, ImplicitIsSecondOrder) {
+  auto system = AdvectionDiffusion(kCells, 1.0, 0.1);
+  auto rk = mini::temporal::RungeKutta<3, double>();
+  Column u_exact = March(&rk, &system, 0.25, 4000);
+  auto solver = mini::temporal::ImplicitRungeKutta<double>();
+  double error_coarse = (March(&solver, &system, 0.25, 8) - u_exact).norm();
+  double error_fine = (March(&solver, &system, 0.25, 16) - u_exact).norm();
+  EXPECT_NEAR(error_coarse / error_fine, 4, 0.5);
+}
+TEST_F(TestTemporalImplicit, ImexIsSecondOrder) {
+  auto system = AdvectionDiffusion(kCells, 1.0, 0.1);
+  auto rk = mini::temporal::RungeKutta<3, double>();
+  Column u_exact = March(&rk, &system, 0.25, 4000);
+  auto solver = mini::temporal::ImexRungeKutta<double>();
+  double error_coarse = (March(&solver, &system, 0.25, 16) - u_exact).norm();
+  double error_fine = (March(&solver, &system, 0.25, 32) - u_exact).norm();
+  EXPECT_NEAR(error_coarse / error_fine, 4, 0.5);
+}
+TEST_F(TestTemporalImplicit, ImexEvaluatesNonstiffOncePerStage) {
+  auto system = AdvectionDiffusion(kCells, 1.0, 0.1);
+  auto solver = mini::temporal::ImexRungeKutta<double>();
+  system.SetSolutionColumn(GetInitialValue());
+  solver.Update(&system, 0.0, 1.0 / 64);
+  // Newton and Krylov iterations evaluate the stiff part only.
+  EXPECT_EQ(system.n_nonstiff, 2);
+  EXPECT_GT(system.n_stiff, solver.newton_krylov().CountKrylovIterations());
+}
+TEST_F(TestTemporalImplicit, PreconditionerSavesKrylovIterations) {
+  auto system = AdvectionDiffusion(kCells, 1.0, 0.1);
+  auto solver = mini::temporal::ImexRungeKutta<double>();
+  system.SetSolutionColumn(GetInitialValue());
+  solver.Update(&system, 0.0, 1.0 / 64);
+  Column u_preconditioned = system.GetSolutionColumn();
+  int n_preconditioned = solver.newton_krylov().CountKrylovIterations();
+  system.use_preconditioner = false;
+  system.SetSolutionColumn(GetInitialValue());
+  solver.Update(&system, 0.0, 1.0 / 64);
+  int n_unpreconditioned = solver.newton_krylov().CountKrylovIterations();
+  EXPECT_LT(n_preconditioned, n_unpreconditioned);
+  EXPECT_TRUE(solver.newton_krylov().IsConverged());
+  EXPECT_EQ(solver.newton_krylov().CountKrylovFailures(), 0);
+  EXPECT_NEAR((system.GetSolutionColumn() - u_preconditioned).norm(), 0, 1e-6);
+}
+TEST_F(TestTemporalImplicit, ThrowIfNewtonFails) {
+  auto system = AdvectionDiffusion(kCells, 1.0, 0.1);
+  system.use_preconditioner = false;
+  // one Newton step, whose linear solve is stopped after 2 iterations
+  auto solver = mini::temporal::ImplicitRungeKutta<double>(1e-12, 1, 1e-6, 2);
+  system.SetSolutionColumn(GetInitialValue());
+  EXPECT_THROW(solver.Update(&system, 0.0, 1.0 / 16), std::runtime_error);
+  EXPECT_FALSE(solver.newton_krylov().IsConverged());
+  EXPECT_EQ(solver.newton_krylov().CountNewtonIterations(), 1);
+  EXPECT_EQ(solver.newton_krylov().CountKrylovIterations(), 2);
+  EXPECT_EQ(solver.newton_krylov().CountKrylovFailures(), 1);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+//  Copyright 2024 PEI Weicheng
+
+#include <cmath>
+#include <numbers>
+#include <memory>
+#include <vector>
+
+#include "mini/temporal/rk.hpp"
+#include "mini/temporal/steady.hpp"
+#include "mini/temporal/multigrid.hpp"
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief The 2nd-order central scheme for `du/dt = d^2u/dx^2 - u^3 + f(x)` on `(0, 1)` with `u(0) = u(1) = 0`, whose steady solution is `sin(pi x)`.
+ */
+class Poisson : public mini::temporal::System<double>,
+    public mini::temporal::SteadySystem<double> {
+ public:
+  using Column = typename mini::temporal::System<double>::Column;
+
+ private:
+  Column u_, f_;
+  double h_;
+
+ public:
+  explicit Poisson(int n)
+      : h_(1.0 / (n + 1)) {
+    u_.setZero(n);
+    f_.resize(n);
+    for (int i = 0; i < n; ++i) {
+      double sin = std::sin(std::numbers::pi * (i + 1) * h_);
+      f_[i] = std::numbers::pi * std::numbers::pi * sin + sin * sin * sin;
+    }
+  }
+
+  double GetStableStep() const {
+    return 0.4 * h_ * h_;
+  }
+  Column GetSteadySolution() const {
+    int n = u_.size();
+    Column u(n);
+    for (int i = 0; i < n; ++i) {
+      u[i] = std::sin(std::numbers::pi * (i + 1) * h_);
+    }
+    return u;
+  }
+
+  void SetTime(double t_curr) final {
+  }
+  void SetSolutionColumn(Column const &u) final {
+    u_ = u;
+  }
+  void WriteSolutionTo(Column *u) const final {
+    *u = u_;
+  }
+  void WriteResidualTo(Column *residual) const final {
+    int n = u_.size();
+    residual->resize(n);
+    for (int i = 0; i < n; ++i) {
+      double u_l = i ? u_[i - 1] : 0.0, u_r = i + 1 < n ? u_[i + 1] : 0.0;
+      (*residual)[i] = (u_l - 2 * u_[i] + u_r) / (h_ * h_)
+          - u_[i] * u_[i] * u_[i] + f_[i];
+    }
+  }
+  void WriteLocalTimeStepsTo(Column *local_dt, int rk_order) const final {
+    local_dt->setConstant(u_.size(), GetStableStep());
+  }
+};
+
+// full weighting from `2 n + 1` nodes to `n` nodes
+void Restrict(Poisson::Column const &fine, Poisson::Column *coarse) {
+  int n = (fine.size() - 1) / 2;
+  coarse->resize(n);
+  for (int i = 0; i < n; ++i) {
+    (*coarse)[i] = (fine[2 * i] + 2 * fine[2 * i + 1] + fine[2 * i + 2]) / 4;
+  }
+}
+
+// linear interpolation from `n` nodes to `2 n + 1` nodes
+void Prolong(Poisson::Column const &coarse, Poisson::Column *fine) {
+  int n = coarse.size();
+  fine->resize(2 * n + 1);
+  for (int i = 0; i <= n; ++i) {
+    double c_l = i ? coarse[i - 1] : 0.0, c_r = i < n ? coarse[i] : 0.0;
+    (*fine)[2 * i] = (c_l + c_r) / 2;
+    if (i < n) {
+      (*fine)[2 * i + 1] = c_r;
+    }
+  }
+}
+
+class TestTemporalMultigrid : public ::testing::Test {
+ protected:
+  using Column = Poisson::Column;
+  using Pseudo = mini::temporal::PseudoTimeStepping<3, double>;
+  using Explicit = mini::temporal::RungeKutta<3, double>;
+  using Multigrid = mini::temporal::FullApproximationScheme<double>;
+  static constexpr int kFineNodes = 63;
+  static constexpr int kLevels = 5;
+
+  std::vector<std::unique_ptr<Poisson>> systems_;
+  std::vector<std::unique_ptr<mini::temporal::Solver<double>>> smoothers_;
+
+  template <class Smoother>
+  void BuildLevels(Multigrid *multigrid, bool use_level_dt = false) {
+    for (int i_level = 0, n = kFineNodes; i_level < kLevels; ++i_level) {
+      systems_.emplace_back(std::make_unique<Poisson>(n));
+      smoothers_.emplace_back(std::make_unique<Smoother>());
+      double dt = use_level_dt ? systems_.back()->GetStableStep() : 1e100;
+      multigrid->AddLevel(systems_.back().get(), smoothers_.back().get(), dt,
+          Restrict, Prolong);
+      n = (n - 1) / 2;
+    }
+  }
+  static double GetResidualNorm(Poisson const &system) {
+    Column residual;
+    system.WriteResidualTo(&residual);
+    return residual.norm();
+  }
+};
+TEST_F(TestTemporalMultigrid, ConvergeToSteadySolution) {
+  auto multigrid = Multigrid(2, 2);
+  BuildLevels<Pseudo>(&multigrid);
+  EXPECT_EQ(multigrid.CountLevels(), kLevels);
+  auto &fine = *systems_.front();
+  double initial_norm = GetResidualNorm(fine);
+  int n_cycles = 0;
+  while (GetResidualNorm(fine) > 1e-10 * initial_norm && n_cycles < 100) {
+    multigrid.Update(&fine, 0.0, 1e100);
+    ++n_cycles;
+  }
+  EXPECT_LT(n_cycles, 30);
+  // the discretization error is O(h^2)
+  auto u = fine.GetSolutionColumn();
+  EXPECT_NEAR((u - fine.GetSteadySolution()).cwiseAbs().maxCoeff(), 0, 1e-3);
+}
+TEST_F(TestTemporalMultigrid, CyclesSaveSteps) {
+  auto single = Poisson(kFineNodes);
+  auto solver = Pseudo(6);
+  while (!solver.IsConverged() && solver.CountSteps() < 100000) {
+    solver.Update(&single, 0.0, 1e100);
+  }
+  EXPECT_TRUE(solver.IsConverged());
+  auto multigrid = Multigrid(2, 2);
+  BuildLevels<Pseudo>(&multigrid);
+  auto &fine = *systems_.front();
+  auto &fine_smoother = dynamic_cast<Pseudo &>(*smoothers_.front());
+  while (!fine_smoother.IsConverged() && fine_smoother.CountSteps() < 100000) {
+    multigrid.Update(&fine, 0.0, 1e100);
+  }
+  EXPECT_TRUE(fine_smoother.IsConverged());
+  EXPECT_LT(fine_smoother.CountSteps() * 50, solver.CountSteps());
+  auto u_single = single.GetSolutionColumn();
+  auto u_multigrid = fine.GetSolutionColumn();
+  EXPECT_NEAR((u_single - u_multigrid).cwiseAbs().maxCoeff(), 0, 1e-6);
+}
+TEST_F(TestTemporalMultigrid, ExplicitSmoother) {
+  auto multigrid = Multigrid(2, 2);
+  BuildLevels<Explicit>(&multigrid, true);
+  auto &fine = *systems_.front();
+  double initial_norm = GetResidualNorm(fine);
+  for (int i_cycle = 0; i_cycle < 30; ++i_cycle) {
+    multigrid.Update(&fine, 0.0, 1e100);
+  }
+  EXPECT_LT(GetResidualNorm(fine), 1e-10 * initial_norm);
+}
+TEST_F(TestTemporalMultigrid, RequireFinestLevel) {
+  auto multigrid = Multigrid();
+  auto fine = Poisson(kFineNodes), coarse = Poisson(kFineNodes / 2);
+  auto solver = Pseudo();
+  EXPECT_THROW(multigrid.Update(&fine, 0.0, 1.0), std::invalid_argument);
+  multigrid.AddLevel(&fine, &solver);
+  EXPECT_THROW(multigrid.AddLevel(&coarse, &solver), std::invalid_argument);
+  EXPECT_THROW(multigrid.Update(&coarse, 0.0, 1.0), std::invalid_argument);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
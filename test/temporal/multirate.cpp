@@ -0,0 +1,163 @@
+//  Copyright 2024 PEI Weicheng
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "mini/temporal/multirate.hpp"
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief The 1st-order upwind finite-volume scheme for `du/dt + du/dx = 0` on a periodic grid with cells of different sizes.
+ */
+class Advection : public mini::temporal::MultirateSystem<double> {
+ public:
+  using Column = typename mini::temporal::System<double>::Column;
+
+ private:
+  std::vector<double> widths_;
+  std::vector<int> levels_;
+  Column u_;
+  int n_levels_ = 1, i_substep_ = -1;
+
+  double GetScale(int level) const {
+    if (i_substep_ < 0) {
+      return 1;
+    }
+    return i_substep_ % (1 << level) == 0 ? (1 << level) : 0;
+  }
+
+ public:
+  explicit Advection(std::vector<double> const &widths)
+      : widths_(widths), levels_(widths.size(), 0) {
+  }
+
+  void SetLevels(int n_levels) {
+    n_levels_ = n_levels;
+    double width_min = *std::ranges::min_element(widths_);
+    for (int i = 0, n = widths_.size(); i < n; ++i) {
+      int level = std::floor(std::log2(widths_[i] / width_min));
+      levels_[i] = std::min(level, n_levels - 1);
+    }
+  }
+  double GetTotal() const {
+    double total = 0;
+    for (int i = 0, n = widths_.size(); i < n; ++i) {
+      total += u_[i] * widths_[i];
+    }
+    return total;
+  }
+
+  int CountTimeLevels() const final {
+    return n_levels_;
+  }
+  void WriteTimeLevelsTo(std::vector<int8_t> *levels) const final {
+    levels->assign(levels_.begin(), levels_.end());
+  }
+  void SetSubstep(int i_substep) final {
+    i_substep_ = i_substep;
+  }
+  void SetTime(double t_curr) final {
+  }
+  void SetSolutionColumn(Column const &u) final {
+    u_ = u;
+  }
+  void WriteSolutionTo(Column *u) const final {
+    *u = u_;
+  }
+  void WriteResidualTo(Column *residual) const final {
+    Column correction;
+    WriteSplitResidualTo(residual, &correction);
+    *residual += correction;
+  }
+  void WriteSplitResidualTo(Column *residual, Column *correction) const final {
+    int n = widths_.size();
+    residual->setZero(n);
+    correction->setZero(n);
+    for (int i_left = 0; i_left < n; ++i_left) {
+      int i_right = (i_left + 1) % n;
+      int level_left = levels_[i_left], level_right = levels_[i_right];
+      double scale = GetScale(std::min(level_left, level_right));
+      double flux = u_[i_left];
+      // the coarser side predicts the flux at its own rate
+      double scale_left = GetScale(level_left);
+      (*residual)[i_left] -= flux * scale_left / widths_[i_left];
+      (*correction)[i_left] -= flux * (scale - scale_left) / widths_[i_left];
+      double scale_right = GetScale(level_right);
+      (*residual)[i_right] += flux * scale_right / widths_[i_right];
+      (*correction)[i_right] += flux * (scale - scale_right) / widths_[i_right];
+    }
+  }
+};
+
+class TestTemporalMultirate : public ::testing::Test {
+ protected:
+  using Column = Advection::Column;
+  static constexpr double kPi = 3.141592653589793;
+
+  // 64 fine cells followed by 16 cells that are 4 times wider
+  static Advection BuildSystem() {
+    auto widths = std::vector<double>(64, 1.0 / 128);
+    widths.resize(80, 4.0 / 128);
+    auto system = Advection(widths);
+    Column u(widths.size());
+    double x = 0;
+    for (int i = 0, n = widths.size(); i < n; ++i) {
+      u[i] = 2 + std::sin(2 * kPi * (x + widths[i] / 2));
+      x += widths[i];
+    }
+    system.SetSolutionColumn(u);
+    return system;
+  }
+};
+TEST_F(TestTemporalMultirate, SingleLevelIsRungeKutta) {
+  auto lts_system = BuildSystem(), rk_system = BuildSystem();
+  auto lts = mini::temporal::LocalTimeStepping<3, double>();
+  auto rk = mini::temporal::RungeKutta<3, double>();
+  double dt = 0.5 / 128;
+  for (int i_step = 0; i_step < 10; ++i_step) {
+    lts.Update(&lts_system, i_step * dt, dt);
+    rk.Update(&rk_system, i_step * dt, dt);
+  }
+  EXPECT_EQ(lts_system.GetSolutionColumn(), rk_system.GetSolutionColumn());
+}
+TEST_F(TestTemporalMultirate, PreserveConstant) {
+  auto system = BuildSystem();
+  system.SetLevels(3);
+  Column u = Column::Constant(80, 2.0);
+  system.SetSolutionColumn(u);
+  auto lts = mini::temporal::LocalTimeStepping<3, double>();
+  double dt_macro = 2.0 / 128;
+  for (int i_step = 0; i_step < 10; ++i_step) {
+    lts.Update(&system, i_step * dt_macro, dt_macro);
+  }
+  EXPECT_NEAR((system.GetSolutionColumn() - u).cwiseAbs().maxCoeff(), 0, 1e-13);
+}
+TEST_F(TestTemporalMultirate, ConservativeAndConsistent) {
+  auto lts_system = BuildSystem(), rk_system = BuildSystem();
+  lts_system.SetLevels(3);
+  auto lts = mini::temporal::LocalTimeStepping<3, double>();
+  auto rk = mini::temporal::RungeKutta<3, double>();
+  double total = lts_system.GetTotal();
+  double dt_min = 0.5 / 128, dt_macro = dt_min * 4;
+  int n_steps = 32;
+  for (int i_step = 0; i_step < n_steps; ++i_step) {
+    lts.Update(&lts_system, i_step * dt_macro, dt_macro);
+    EXPECT_NEAR(lts_system.GetTotal(), total, 1e-14);
+  }
+  for (int i_step = 0; i_step < n_steps * 4; ++i_step) {
+    rk.Update(&rk_system, i_step * dt_min, dt_min);
+  }
+  Column u_lts = lts_system.GetSolutionColumn();
+  Column u_rk = rk_system.GetSolutionColumn();
+  EXPECT_GT(u_lts.minCoeff(), 1 - 1e-10);
+  EXPECT_LT(u_lts.maxCoeff(), 3 + 1e-10);
+  EXPECT_LT((u_lts - u_rk).cwiseAbs().maxCoeff(), 0.05);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -18,6 +18,22 @@ class TestTemporalConstant : public ::testing::Test {
     return std::rand() / (1.0 + RAND_MAX);
   }
 };
+TEST_F(TestTemporalConstant, WriteInPlace) {
+  int n = 10;
+  std::srand(31415926);
+  Matrix a = Matrix::Random(n, n);
+  auto system = System(a);
+  Column u_old = Column::Random(n);
+  system.SetSolutionColumn(u_old);
+  Column column = Column::Zero(n);
+  auto *data = column.data();
+  system.WriteSolutionTo(&column);
+  EXPECT_EQ(column.data(), data);
+  EXPECT_EQ(column, u_old);
+  system.WriteResidualTo(&column);
+  EXPECT_EQ(column.data(), data);
+  EXPECT_EQ(column, a * u_old);
+}
 TEST_F(TestTemporalConstant, OneStepRungeKutta) {
   using Solver = mini::temporal::RungeKutta<1, Scalar>;
   int n = 10;
@@ -68,6 +84,85 @@ TEST_F(TestTemporalConstant, ThreeStepRungeKutta) {
   auto u_3rd = ((u_2nd + a * u_2nd * dt) * 2 + u_old) / 3;
   EXPECT_EQ(u_new, u_3rd);
 }
+TEST_F(TestTemporalConstant, LowStorageThreeStage) {
+  using Solver = mini::temporal::LowStorageRungeKutta<3, 3, Scalar>;
+  int n = 10;
+  std::srand(31415926);
+  Matrix a = Matrix::Random(n, n);
+  auto system = System(a);
+  Column u_old = Column::Random(n);
+  system.SetSolutionColumn(u_old);
+  auto solver = Solver();
+  auto t_curr = rand_f();
+  auto dt = rand_f();
+  solver.Update(&system, t_curr, dt);
+  auto u_new = system.GetSolutionColumn();
+  // same as RungeKutta<3> on linear systems
+  Column au = a * u_old * dt, aau = a * au * dt, aaau = a * aau * dt;
+  Column u_3rd = u_old + au + aau / 2 + aaau / 6;
+  EXPECT_NEAR((u_new - u_3rd).norm(), 0, 1e-5);
+}
+TEST_F(TestTemporalConstant, SspFourStage) {
+  using Solver = mini::temporal::SspRungeKutta<4, Scalar>;
+  int n = 10;
+  std::srand(31415926);
+  Matrix a = Matrix::Random(n, n);
+  auto system = System(a);
+  Column u_old = Column::Random(n);
+  system.SetSolutionColumn(u_old);
+  auto solver = Solver();
+  auto t_curr = rand_f();
+  auto dt = rand_f();
+  solver.Update(&system, t_curr, dt);
+  auto u_new = system.GetSolutionColumn();
+  Column u_1st = u_old + a * u_old * dt / 3;
+  Column u_2nd = u_1st + a * u_1st * dt / 3;
+  Column u_3rd = u_2nd + a * u_2nd * dt / 3;
+  Column u_4th = ((u_3rd + a * u_3rd * dt / 3) * 3 + u_old) / 4;
+  EXPECT_NEAR((u_new - u_4th).norm(), 0, 1e-5);
+  // second-order accurate, i.e. P(z) = 1 + z + z^2 / 2 + z^3 / 9 + z^4 / 108
+  Column au = a * u_old * dt, aau = a * au * dt, aaau = a * aau * dt;
+  Column aaaau = a * aaau * dt;
+  Column u_poly = u_old + au + aau / 2 + aaau / 9 + aaaau / 108;
+  EXPECT_NEAR((u_new - u_poly).norm(), 0, 1e-5);
+}
+TEST_F(TestTemporalConstant, LowStorageFiveStage) {
+  using Solver = mini::temporal::LowStorageRungeKutta<5, 4, double>;
+  using Matrix = typename mini::temporal::Constant<double>::Matrix;
+  using Column = typename mini::temporal::Constant<double>::Column;
+  int n = 4;
+  std::srand(31415926);
+  Matrix a = Matrix::Random(n, n);
+  Column u_old = Column::Random(n);
+  auto solve = [&](int n_steps) {
+    auto system = mini::temporal::Constant<double>(a);
+    system.SetSolutionColumn(u_old);
+    auto solver = Solver();
+    double dt = 1.0 / n_steps;
+    for (int i_step = 0; i_step < n_steps; ++i_step) {
+      solver.Update(&system, i_step * dt, dt);
+    }
+    return system.GetSolutionColumn();
+  };
+  Column u_exact = solve(1000);
+  auto get_error = [&](int n_steps) {
+    return (solve(n_steps) - u_exact).norm();
+  };
+  // 4th-order accurate, i.e. error(dt) / error(dt / 2) ~= 2^4
+  EXPECT_NEAR(get_error(10) / get_error(20), 16, 1);
+}
+TEST_F(TestTemporalConstant, CflTraits) {
+  using mini::temporal::CflTraits;
+  using mini::temporal::LowStorageRungeKutta;
+  using mini::temporal::RungeKutta;
+  using mini::temporal::SspRungeKutta;
+  EXPECT_EQ((CflTraits<RungeKutta<3, Scalar>>::kRkOrder), 3);
+  EXPECT_EQ((CflTraits<LowStorageRungeKutta<3, 3, Scalar>>::kRkOrder), 3);
+  EXPECT_EQ((CflTraits<LowStorageRungeKutta<5, 4, Scalar>>::kRkOrder), 3);
+  EXPECT_GT((CflTraits<LowStorageRungeKutta<5, 4, Scalar>>::kRatio), 1);
+  EXPECT_EQ((CflTraits<SspRungeKutta<4, Scalar>>::kRkOrder), 2);
+  EXPECT_EQ((CflTraits<SspRungeKutta<4, Scalar>>::kRatio), 3);
+}
 
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,123 @@
+//  Copyright 2024 PEI Weicheng
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "mini/temporal/steady.hpp"
+
+#include "gtest/gtest.h"
+
+/**
+ * @brief The 1st-order upwind finite-volume scheme for `du/dt + du/dx = 1 - u` with `u(0) = 0` on a stretched grid.
+ */
+class Advection : public mini::temporal::System<double>,
+    public mini::temporal::SteadySystem<double> {
+ public:
+  using Column = typename mini::temporal::System<double>::Column;
+
+ private:
+  std::vector<double> widths_;
+  Column u_;
+
+ public:
+  bool use_global_step = false;
+
+  // widths grow geometrically from `width_min` by `ratio`
+  Advection(int n, double width_min, double ratio) {
+    for (int i = 0; i < n; ++i) {
+      widths_.emplace_back(width_min * std::pow(ratio, i));
+    }
+    u_.setZero(n);
+  }
+
+  void SetTime(double t_curr) final {
+  }
+  void SetSolutionColumn(Column const &u) final {
+    u_ = u;
+  }
+  void WriteSolutionTo(Column *u) const final {
+    *u = u_;
+  }
+  void WriteResidualTo(Column *residual) const final {
+    int n = widths_.size();
+    residual->resize(n);
+    for (int i = 0; i < n; ++i) {
+      double u_left = i ? u_[i - 1] : 0.0;
+      (*residual)[i] = (u_left - u_[i]) / widths_[i] + 1 - u_[i];
+    }
+  }
+  void WriteLocalTimeStepsTo(Column *local_dt, int rk_order) const final {
+    int n = widths_.size();
+    local_dt->resize(n);
+    double width_min = *std::ranges::min_element(widths_);
+    for (int i = 0; i < n; ++i) {
+      // the upwind scheme is stable with RungeKutta<3> if dt <= h / (1 + h)
+      double width = use_global_step ? width_min : widths_[i];
+      (*local_dt)[i] = width / (1 + width);
+    }
+  }
+  // the exact steady solution of the discrete system
+  Column GetSteadySolution() const {
+    int n = widths_.size();
+    Column u(n);
+    for (int i = 0; i < n; ++i) {
+      double u_left = i ? u[i - 1] : 0.0;
+      u[i] = (u_left / widths_[i] + 1) / (1 / widths_[i] + 1);
+    }
+    return u;
+  }
+};
+
+class TestTemporalSteady : public ::testing::Test {
+ protected:
+  using Solver = mini::temporal::PseudoTimeStepping<3, double>;
+
+  static int March(Solver *solver, Advection *system, int max_steps) {
+    while (!solver->IsConverged() && solver->CountSteps() < max_steps) {
+      solver->Update(system, 0.0, 1e100);
+    }
+    return solver->CountSteps();
+  }
+};
+TEST_F(TestTemporalSteady, ConvergeToSteadySolution) {
+  auto system = Advection(40, 1e-3, 1.2);
+  auto solver = Solver(10);
+  March(&solver, &system, 10000);
+  EXPECT_TRUE(solver.IsConverged());
+  EXPECT_GE(solver.GetOrdersOfDrop(), 10);
+  auto [l2_norm, linf_norm] = solver.GetResidualNorms();
+  EXPECT_LE(l2_norm, linf_norm * std::sqrt(40.0));
+  auto u_steady = system.GetSteadySolution();
+  auto u = system.GetSolutionColumn();
+  EXPECT_NEAR((u - u_steady).cwiseAbs().maxCoeff(), 0, 1e-8);
+}
+TEST_F(TestTemporalSteady, LocalStepsSaveSteps) {
+  auto local_system = Advection(40, 1e-3, 1.2);
+  auto local_solver = Solver(6);
+  int n_local_steps = March(&local_solver, &local_system, 100000);
+  auto global_system = Advection(40, 1e-3, 1.2);
+  global_system.use_global_step = true;
+  auto global_solver = Solver(6);
+  int n_global_steps = March(&global_solver, &global_system, 100000);
+  EXPECT_TRUE(local_solver.IsConverged());
+  EXPECT_TRUE(global_solver.IsConverged());
+  EXPECT_LT(n_local_steps * 10, n_global_steps);
+}
+TEST_F(TestTemporalSteady, RequireSteadySystem) {
+  auto system = mini::temporal::Constant<double>(
+      mini::temporal::Constant<double>::Matrix::Identity(2, 2));
+  auto solver = Solver();
+  EXPECT_THROW(solver.Update(&system, 0.0, 1.0), std::invalid_argument);
+}
+TEST_F(TestTemporalSteady, NormsOfEmptyColumn) {
+  auto system = Advection(4, 0.1, 1.5);
+  auto [l2_norm, linf_norm] = system.GetNorms(Advection::Column());
+  EXPECT_EQ(l2_norm, 0);
+  EXPECT_EQ(linf_norm, 0);
+}
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}